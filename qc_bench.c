@@ -0,0 +1,422 @@
+/* Copyright IBM Corp. 2018 */
+
+/* Micro-benchmarks for qclib, running on a corpus of dumps (see directory 'dumps'), so
+   that no s390 hardware is required. Reports throughput, median and 99th percentile
+   latencies, as well as the number of allocations per operation. */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "query_capacity_data.h"
+
+
+#define NUM_DUMPS_MAX	64
+#define NAME_LEN	48
+
+struct dump {
+	char			 name[NAME_LEN];
+	char			 path[PATH_MAX];
+	struct qc_source_buffer	 sysinfo;
+	struct qc_source_buffer	 diag_204;
+};
+
+struct bench {
+	char	 name[NAME_LEN];
+	int	 batch;		// number of operations per sample, for operations too fast to time individually
+	void	(*setup)(struct bench *);
+	void	(*run)(struct bench *);
+	void	(*teardown)(struct bench *);
+	struct dump *dump;
+	void	*hdl;
+	int	 layer;
+};
+
+static struct dump	dumps[NUM_DUMPS_MAX];
+static int		num_dumps;
+static unsigned long	num_allocs;
+static int		count_allocs;
+static int		errors;
+
+
+/* Count allocations by interposing the allocator. We only count while an operation is being
+   timed, so that setup and teardown don't skew the results. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void  __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+	num_allocs += count_allocs;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+	num_allocs += count_allocs;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+	num_allocs += count_allocs;
+	return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size) {
+	num_allocs += count_allocs;
+	if ((*memptr = __libc_memalign(alignment, size)) == NULL)
+		return ENOMEM;
+	return 0;
+}
+
+void free(void *ptr) {
+	__libc_free(ptr);
+}
+
+static double now_nsecs(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int read_file(const char *dump, const char *fname, struct qc_source_buffer *buf, int type) {
+	char path[PATH_MAX];
+	struct stat sbuf;
+	size_t len;
+	FILE *f;
+	void *data;
+
+	buf->type = type;
+	snprintf(path, PATH_MAX, "%s/%s", dump, fname);
+	if (stat(path, &sbuf) || sbuf.st_size == 0)
+		return 0;	// not every dump contains data from every source
+	if ((f = fopen(path, "r")) == NULL)
+		return -1;
+	data = malloc(sbuf.st_size);
+	len = data ? fread(data, 1, sbuf.st_size, f) : 0;
+	fclose(f);
+	if (!data || len != (size_t)sbuf.st_size) {
+		free(data);
+		return -1;
+	}
+	buf->data = data;
+	buf->len = len;
+
+	return 0;
+}
+
+static int cmp_str(const void *a, const void *b) {
+	return strcmp(((const struct dump *)a)->name, ((const struct dump *)b)->name);
+}
+
+static int read_corpus(const char *corpus) {
+	struct dirent *de;
+	struct stat sbuf;
+	struct dump *d;
+	DIR *dir;
+
+	if ((dir = opendir(corpus)) == NULL) {
+		fprintf(stderr, "Error: Failed to open corpus '%s'\n", corpus);
+		return -1;
+	}
+	while ((de = readdir(dir)) != NULL && num_dumps < NUM_DUMPS_MAX) {
+		d = &dumps[num_dumps];
+		snprintf(d->path, PATH_MAX, "%s/%s", corpus, de->d_name);
+		if (de->d_name[0] == '.' || stat(d->path, &sbuf) || !S_ISDIR(sbuf.st_mode))
+			continue;
+		snprintf(d->name, NAME_LEN, "%.*s", NAME_LEN - 1, de->d_name);
+		if (read_file(d->path, "sysinfo", &d->sysinfo, QC_SOURCE_SYSINFO) ||
+		    read_file(d->path, "s390_hypfs/diag_204", &d->diag_204, QC_SOURCE_HYPFS_DIAG_204)) {
+			fprintf(stderr, "Error: Failed to read dump '%s'\n", d->path);
+			closedir(dir);
+			return -1;
+		}
+		num_dumps++;
+	}
+	closedir(dir);
+	if (num_dumps == 0) {
+		fprintf(stderr, "Error: No dumps found in corpus '%s'\n", corpus);
+		return -1;
+	}
+	qsort(dumps, num_dumps, sizeof(struct dump), cmp_str);
+
+	return 0;
+}
+
+
+/* qc_open() on a dump via QC_USE_DUMP, i.e. including file I/O */
+static void setup_open(struct bench *b) {
+	setenv("QC_USE_DUMP", b->dump->path, 1);
+}
+
+static void run_open(struct bench *b) {
+	int rc;
+
+	if ((b->hdl = qc_open(&rc)) == NULL || rc) {
+		fprintf(stderr, "Error: qc_open() on '%s' failed, rc=%d\n", b->dump->path, rc);
+		errors++;
+	}
+}
+
+static void teardown_close(struct bench *b) {
+	qc_close(b->hdl);
+	b->hdl = NULL;
+}
+
+/* Attribute retrieval, using the LPAR layer of the first dump */
+static void setup_attr(struct bench *b) {
+	int rc;
+
+	setup_open(b);
+	run_open(b);
+	unsetenv("QC_USE_DUMP");
+	if (b->hdl)
+		b->layer = qc_get_num_layers(b->hdl, &rc) - 1;
+}
+
+static void run_attr_int(struct bench *b) {
+	int i;
+
+	if (qc_get_attribute_int(b->hdl, qc_num_cpu_total, b->layer, &i) <= 0)
+		errors++;
+}
+
+static void run_attr_float(struct bench *b) {
+	float f;
+
+	if (qc_get_attribute_float(b->hdl, qc_capability, 0, &f) <= 0)
+		errors++;
+}
+
+static void run_attr_string(struct bench *b) {
+	const char *s;
+
+	if (qc_get_attribute_string(b->hdl, qc_layer_name, b->layer, &s) <= 0)
+		errors++;
+}
+
+static void run_ebcdic(struct bench *b) {
+	/* "LINUX01 " in EBCDIC */
+	static const char ebcdic[8] = {0xd3, 0xc9, 0xd5, 0xe4, 0xe7, 0xf0, 0xf1, 0x40};
+	char buf[sizeof(ebcdic)];
+
+	memcpy(buf, ebcdic, sizeof(ebcdic));
+	qc_ebcdic_to_ascii(NULL, buf, sizeof(buf));
+	if (buf[0] != 'L')
+		errors++;
+}
+
+/* /proc/sysinfo parsing only, on a bare CEC and LPAR layer as set up in _qc_open() */
+static void setup_sysinfo(struct bench *b) {
+	struct qc_handle *hdl = NULL, *lparhdl;
+
+	if (qc_new_handle(NULL, &hdl, 0, QC_LAYER_TYPE_CEC) ||
+	    qc_new_handle(hdl, &lparhdl, 1, QC_LAYER_TYPE_LPAR)) {
+		errors++;
+		return;
+	}
+	hdl->next = lparhdl;
+	lparhdl->root = hdl->root;
+	b->hdl = hdl;
+}
+
+static void run_sysinfo(struct bench *b) {
+	char *priv = NULL;
+
+	if (sysinfo.open_buf(b->hdl, &b->dump->sysinfo, 1, &priv) ||
+	    sysinfo.process(b->hdl, priv))
+		errors++;
+	sysinfo.close(b->hdl, priv);
+}
+
+static void teardown_sysinfo(struct bench *b) {
+	if (b->hdl) {
+		qc_hdl_reinit(b->hdl);
+		free(b->hdl);
+	}
+	b->hdl = NULL;
+}
+
+/* diag_204 parsing only, on fresh layers derived from /proc/sysinfo without any post-processing */
+static void setup_diag_204(struct bench *b) {
+	setup_sysinfo(b);
+	if (b->hdl)
+		run_sysinfo(b);
+}
+
+static void run_diag_204(struct bench *b) {
+	char *priv = NULL;
+
+	if (hypfs.open_buf(b->hdl, &b->dump->diag_204, 1, &priv) ||
+	    hypfs.process(b->hdl, priv))
+		errors++;
+	hypfs.close(b->hdl, priv);
+}
+
+static int cmp_double(const void *a, const void *b) {
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void run_bench(struct bench *b, int iterations) {
+	double *samples, start, sum = 0;
+	unsigned long allocs;
+	int i, j;
+
+	if ((samples = malloc(iterations * sizeof(double))) == NULL)
+		return;
+	// warm up caches and branch predictors first
+	for (i = 0; i < iterations / 10 + 1; ++i) {
+		if (b->setup)
+			b->setup(b);
+		for (j = 0; j < b->batch; ++j)
+			b->run(b);
+		if (b->teardown)
+			b->teardown(b);
+	}
+	num_allocs = 0;
+	for (i = 0; i < iterations; ++i) {
+		if (b->setup)
+			b->setup(b);
+		count_allocs = 1;
+		start = now_nsecs();
+		for (j = 0; j < b->batch; ++j)
+			b->run(b);
+		samples[i] = (now_nsecs() - start) / b->batch;
+		count_allocs = 0;
+		if (b->teardown)
+			b->teardown(b);
+		sum += samples[i];
+	}
+	allocs = num_allocs;
+	qsort(samples, iterations, sizeof(double), cmp_double);
+	printf("%-32s %12.0f %12.0f %12.0f %12.1f\n", b->name, 1e9 * iterations / sum,
+		samples[iterations / 2], samples[(iterations * 99) / 100],
+		(double)allocs / ((double)iterations * b->batch));
+	free(samples);
+}
+
+static void print_help() {
+	printf("\n");
+	printf("Usage: qc_bench [-h] [-n <iterations>] [<corpus>]\n");
+	printf("\n");
+	printf("Run micro-benchmarks on all dumps in directory <corpus> (defaults to 'dumps'),\n");
+	printf("and report throughput, median and 99th percentile latencies in nanoseconds, as\n");
+	printf("well as the number of allocations per operation.\n");
+	printf("\n");
+	printf("  -h, --help        Print usage information and exit\n");
+	printf("  -n, --iterations  Number of samples per benchmark. Defaults to 2000.\n");
+	printf("\n");
+}
+
+int main(int argc, char **argv) {
+	static struct option long_options[] = {
+		{ "help",	no_argument,	   NULL, 'h'},
+		{ "iterations",	required_argument, NULL, 'n'},
+		{ 0,		0,		   0,	 0  }
+	};
+	int i, c, iterations = 2000, num_benches = 0;
+	const char *corpus = "dumps";
+	struct bench *benches, *b;
+	cpu_set_t cpus;
+
+	while ((c = getopt_long(argc, argv, "hn:", long_options, NULL)) != EOF) {
+		switch (c) {
+		case 'h': print_help();
+			  return 0;
+		case 'n': iterations = atoi(optarg);
+			  break;
+		default:  print_help();
+			  return 1;
+		}
+	}
+	if (optind < argc)
+		corpus = argv[optind++];
+	if (optind < argc || iterations <= 0) {
+		print_help();
+		return 1;
+	}
+	if (read_corpus(corpus))
+		return 1;
+	// stay on a single CPU for more stable results
+	CPU_ZERO(&cpus);
+	CPU_SET(sched_getcpu(), &cpus);
+	sched_setaffinity(0, sizeof(cpus), &cpus);
+
+	if ((benches = calloc(3 * num_dumps + 4, sizeof(struct bench))) == NULL)
+		return 1;
+	for (i = 0; i < num_dumps; ++i) {
+		b = &benches[num_benches++];
+		snprintf(b->name, NAME_LEN, "qc_open(%.32s)", dumps[i].name);
+		b->batch = 1;
+		b->setup = setup_open;
+		b->run = run_open;
+		b->teardown = teardown_close;
+		b->dump = &dumps[i];
+	}
+	for (i = 0; i < num_dumps; ++i) {
+		if (!dumps[i].sysinfo.data)
+			continue;
+		b = &benches[num_benches++];
+		snprintf(b->name, NAME_LEN, "sysinfo(%.32s)", dumps[i].name);
+		b->batch = 1;
+		b->setup = setup_sysinfo;
+		b->run = run_sysinfo;
+		b->teardown = teardown_sysinfo;
+		b->dump = &dumps[i];
+	}
+	for (i = 0; i < num_dumps; ++i) {
+		if (!dumps[i].diag_204.data || !dumps[i].sysinfo.data)
+			continue;
+		b = &benches[num_benches++];
+		snprintf(b->name, NAME_LEN, "diag_204(%.32s)", dumps[i].name);
+		b->batch = 1;
+		b->setup = setup_diag_204;
+		b->run = run_diag_204;
+		b->teardown = teardown_sysinfo;
+		b->dump = &dumps[i];
+	}
+	for (i = 0; i < 3; ++i) {
+		b = &benches[num_benches++];
+		b->batch = 1000;
+		b->setup = setup_attr;
+		b->teardown = teardown_close;
+		b->dump = &dumps[0];
+	}
+	snprintf(benches[num_benches - 3].name, NAME_LEN, "qc_get_attribute_int");
+	benches[num_benches - 3].run = run_attr_int;
+	snprintf(benches[num_benches - 2].name, NAME_LEN, "qc_get_attribute_float");
+	benches[num_benches - 2].run = run_attr_float;
+	snprintf(benches[num_benches - 1].name, NAME_LEN, "qc_get_attribute_string");
+	benches[num_benches - 1].run = run_attr_string;
+	b = &benches[num_benches++];
+	snprintf(b->name, NAME_LEN, "qc_ebcdic_to_ascii");
+	b->batch = 1000;
+	b->run = run_ebcdic;
+
+	printf("%-32s %12s %12s %12s %12s\n", "Benchmark", "ops/s", "median[ns]", "p99[ns]", "allocs/op");
+	for (i = 0; i < num_benches; ++i)
+		run_bench(&benches[i], iterations);
+	free(benches);
+	for (i = 0; i < num_dumps; ++i) {
+		free((void *)dumps[i].sysinfo.data);
+		free((void *)dumps[i].diag_204.data);
+	}
+	if (errors) {
+		fprintf(stderr, "%d error(s) detected\n", errors);
+		return 2;
+	}
+
+	return 0;
+}
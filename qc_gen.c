@@ -0,0 +1,807 @@
+/* Copyright IBM Corp. 2018 */
+
+/* Generates synthetic source data in the dump layout (see QC_USE_DUMP), for scaling tests of
+   the parsers on configurations that are too large to come by easily. */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <endian.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "hcpinfbk_qclib.h"
+
+
+#define MAX_LPARS		85
+#define MAX_CPUS		255	// CPU counts in diag_204 are 8 bit wide
+#define MAX_ZVM_LEVELS		8
+#define MAX_STHYI_LEVELS	3	// see INF0YGMX
+#define STHYI_BUF_SIZE		4096
+#define NAME_LEN		8
+
+#define CPU_TYPE_CP		0
+#define CPU_TYPE_IFL		3
+#define CPU_TYPE_ZIIP		5
+#define CPU_FLAG_PHYS		0x80
+#define CPU_DEDICATED		0xffff
+#define CPU_CONFIGURED		0x20
+#define CPU_CAPPED		0x40
+
+/* The following structs match the ones in query_capacity_hypfs.c */
+struct dfs_diag_hdr {
+	uint64_t  len;
+	uint16_t  version;
+	uint8_t   tod_ext[16];
+	uint64_t  count;
+	uint8_t   reserved[30];
+} __attribute__ ((packed));
+
+struct dfs_info_blk_hdr {
+	uint8_t   npar;
+	uint8_t   flags;
+	uint8_t   reserved1[4];
+	uint16_t  thispart;
+	uint64_t  curtod1;
+	uint64_t  curtod2;
+	uint8_t   reserved[40];
+} __attribute__ ((packed));
+
+struct dfs_sys_hdr {
+	uint8_t   reserved1;
+	uint8_t   cpus;
+	uint8_t   rcpus;
+	uint8_t   reserved2[5];
+	char      sys_name[8];
+	uint8_t   reserved3[48];
+	char      grp_name[8];
+	uint8_t   reserved4[24];
+} __attribute__ ((packed));
+
+struct dfs_cpu_info {
+	uint16_t  cpu_addr;
+	uint16_t  reserved1;
+	uint8_t   ctidx;
+	uint8_t   cflag;
+	uint16_t  weight;
+	uint64_t  acc_time;
+	uint64_t  lp_time;
+	uint64_t  reserved3;
+	uint64_t  online_time;
+	uint32_t  reserved4[4];
+	uint32_t  cpuTypeCap;
+	uint32_t  groupCpuTypeCap;
+	uint32_t  reserved5[8];
+} __attribute__ ((packed));
+
+struct dfs_diag2fc {
+	uint32_t  version;
+	uint32_t  flags;
+	uint64_t  used_cpu;
+	uint64_t  el_time;
+	uint64_t  mem_min_kb;
+	uint64_t  mem_max_kb;
+	uint64_t  mem_share_kb;
+	uint64_t  mem_used_kb;
+	uint32_t  pcpus;
+	uint32_t  lcpus;
+	uint32_t  vcpus;
+	uint32_t  ocpus;
+	uint32_t  cpu_max;
+	uint32_t  cpu_shares;
+	uint32_t  cpu_use_samp;
+	uint32_t  cpu_delay_samp;
+	uint32_t  page_wait_samp;
+	uint32_t  idle_samp;
+	uint32_t  other_samp;
+	uint32_t  total_samp;
+	char      guest_name[NAME_LEN];
+} __attribute__ ((packed));
+
+struct config {
+	int	 lpars;		// number of LPARs
+	int	 cores;		// logical cores per LPAR
+	int	 ifls;		// of which are IFLs
+	int	 ziips;		// shared zIIPs per LPAR other than ours
+	int	 dedicated;	// number of LPARs with dedicated cores, starting with the first one
+	int	 weight;	// weight of our LPAR, all others have a weight of 100
+	int	 abs_cap;	// absolute capping of our LPAR, in hundredths of cores
+	int	 group_cap;	// absolute capping of our LPAR's group, in hundredths of cores
+	int	 zvm_levels;	// number of nested z/VM hypervisors
+	int	 kvm;		// KVM guest on top
+	int	 kvm_guests;	// number of KVM guests run by the highest layer
+	int	 guests;	// number of z/VM guests
+	int	 vcpus;		// virtual CPUs per z/VM and KVM guest
+	int	 guest_cap;	// 0: off, 1: soft, 2: hard
+	int	 uptime;	// seconds that the CPUs were online
+	int	 busy;		// percentage of the uptime that the CPUs were busy
+	int	 mem_limit;	// memory limit of our control group in MB, 0 if not limited
+	int	 own;		// index of our LPAR
+	const char *dir;
+};
+
+static struct config cfg = {
+	.lpars = 3,
+	.cores = 4,
+	.ifls = -1,
+	.weight = 100,
+	.guests = 10,
+	.vcpus = 2,
+	.uptime = 3600,
+	.busy = 50,
+};
+
+
+static int is_own_lpar(int i) {
+	return i == cfg.own;
+}
+
+static int is_dedicated_lpar(int i) {
+	return i < cfg.dedicated;
+}
+
+static void lpar_name(char *buf, int i) {
+	snprintf(buf, NAME_LEN + 1, "LP%02d", (i + 1) % 100);
+}
+
+// Level 0 is the z/VM guest running in the LPAR
+static void zvm_guest_name(char *buf, int level) {
+	if (level == cfg.zvm_levels - 1)
+		strcpy(buf, "QCGUEST");
+	else
+		snprintf(buf, NAME_LEN + 1, "ZVMGST%d", level % 10);
+}
+
+/* Converts 'src' into a blank-padded EBCDIC string of length 'len'. Supports the
+   characters that we use in names only. */
+static void to_ebcdic(char *dst, const char *src, size_t len) {
+	size_t i;
+	char c;
+
+	for (i = 0; i < len; ++i) {
+		c = *src ? *src++ : ' ';
+		if (c >= '0' && c <= '9')
+			dst[i] = 0xf0 + c - '0';
+		else if (c >= 'A' && c <= 'I')
+			dst[i] = 0xc1 + c - 'A';
+		else if (c >= 'J' && c <= 'R')
+			dst[i] = 0xd1 + c - 'J';
+		else if (c >= 'S' && c <= 'Z')
+			dst[i] = 0xe2 + c - 'S';
+		else
+			dst[i] = 0x40;
+	}
+}
+
+static int write_file(const char *fname, const void *data, size_t len) {
+	char path[PATH_MAX], *p;
+	FILE *f;
+
+	snprintf(path, PATH_MAX, "%s/%s", cfg.dir, fname);
+	for (p = strchr(path + strlen(cfg.dir) + 1, '/'); p; p = strchr(p + 1, '/')) {
+		*p = '\0';
+		if (mkdir(path, 0755) && errno != EEXIST) {
+			fprintf(stderr, "Error: Failed to create directory '%s': %s\n", path, strerror(errno));
+			return -1;
+		}
+		*p = '/';
+	}
+	if ((f = fopen(path, "w")) == NULL) {
+		fprintf(stderr, "Error: Failed to open '%s': %s\n", path, strerror(errno));
+		return -1;
+	}
+	if (len && fwrite(data, len, 1, f) != 1) {
+		fprintf(stderr, "Error: Failed to write '%s'\n", path);
+		fclose(f);
+		return -1;
+	}
+
+	return fclose(f);
+}
+
+static int gen_sysinfo(void) {
+	int i, j, rc, ded = is_dedicated_lpar(cfg.own);
+	int phys = cfg.cores * (cfg.dedicated + (cfg.dedicated < cfg.lpars ? 1 : 0));
+	char name[NAME_LEN + 1], *buf = NULL;
+	size_t len = 0;
+	FILE *f;
+
+	if ((f = open_memstream(&buf, &len)) == NULL)
+		return -1;
+	fprintf(f, "Manufacturer:         IBM\n");
+	fprintf(f, "Type:                 3906\n");
+	fprintf(f, "Model:                7%02d              M05\n", phys > 99 ? 99 : phys);
+	fprintf(f, "Sequence Code:        0000000000012345\n");
+	fprintf(f, "Plant:                02\n");
+	fprintf(f, "Model Capacity:       7%02d              00000000\n", phys > 99 ? 99 : phys);
+	fprintf(f, "Capacity Adj. Ind.:   100\n");
+	fprintf(f, "Capacity Ch. Reason:  0\n");
+	fprintf(f, "Capacity Transient:   0\n");
+	fprintf(f, "\n");
+	fprintf(f, "CPUs Total:           %d\n", MAX_CPUS);
+	fprintf(f, "CPUs Configured:      %d\n", phys);
+	fprintf(f, "CPUs Standby:         0\n");
+	fprintf(f, "CPUs Reserved:        %d\n", MAX_CPUS - phys);
+	fprintf(f, "CPUs G-MTID:          0\n");
+	fprintf(f, "CPUs S-MTID:          1\n");
+	fprintf(f, "Capability:           2250\n");
+	fprintf(f, "Secondary Capability: 500\n");
+	fprintf(f, "\n");
+	lpar_name(name, cfg.own);
+	fprintf(f, "LPAR Number:          %d\n", cfg.own + 1);
+	fprintf(f, "LPAR Characteristics: %s\n", ded ? "Dedicated" : "Shared");
+	fprintf(f, "LPAR Name:            %s\n", name);
+	fprintf(f, "LPAR Adjustment:      250\n");
+	fprintf(f, "LPAR CPUs Total:      %d\n", cfg.cores);
+	fprintf(f, "LPAR CPUs Configured: %d\n", cfg.cores);
+	fprintf(f, "LPAR CPUs Standby:    0\n");
+	fprintf(f, "LPAR CPUs Reserved:   0\n");
+	fprintf(f, "LPAR CPUs Dedicated:  %d\n", ded ? cfg.cores : 0);
+	fprintf(f, "LPAR CPUs Shared:     %d\n", ded ? 0 : cfg.cores);
+	fprintf(f, "LPAR CPUs G-MTID:     0\n");
+	fprintf(f, "LPAR CPUs S-MTID:     1\n");
+	fprintf(f, "LPAR CPUs PS-MTID:    1\n");
+	// VM00 is the topmost layer
+	i = 0;
+	if (cfg.kvm) {
+		fprintf(f, "\n");
+		fprintf(f, "VM00 Name:            KVMGUEST\n");
+		fprintf(f, "VM00 Control Program: KVM/Linux\n");
+		fprintf(f, "VM00 Adjustment:      1000\n");
+		fprintf(f, "VM00 CPUs Total:      %d\n", cfg.vcpus);
+		fprintf(f, "VM00 CPUs Configured: %d\n", cfg.vcpus);
+		fprintf(f, "VM00 CPUs Standby:    0\n");
+		fprintf(f, "VM00 CPUs Reserved:   0\n");
+		fprintf(f, "VM00 Extended Name:   kvmguest\n");
+		fprintf(f, "VM00 UUID:            4a3c0e8d-3b5b-4c8a-9c0b-0a1f6f1c5e7d\n");
+		i++;
+	}
+	for (j = cfg.zvm_levels - 1; j >= 0; --j, ++i) {
+		zvm_guest_name(name, j);
+		fprintf(f, "\n");
+		fprintf(f, "VM%02d Name:            %s\n", i, name);
+		fprintf(f, "VM%02d Control Program: z/VM    7.1.0\n", i);
+		fprintf(f, "VM%02d Adjustment:      62\n", i);
+		fprintf(f, "VM%02d CPUs Total:      %d\n", i, cfg.vcpus);
+		fprintf(f, "VM%02d CPUs Configured: %d\n", i, cfg.vcpus);
+		fprintf(f, "VM%02d CPUs Standby:    0\n", i);
+		fprintf(f, "VM%02d CPUs Reserved:   0\n", i);
+	}
+	fclose(f);
+	rc = write_file("sysinfo", buf, len);
+	free(buf);
+
+	return rc;
+}
+
+// 'busy' is the time in microseconds that the CPU was dispatched
+static void fill_cpu(struct dfs_cpu_info *cpu, int addr, int type, int ded, int weight, uint64_t busy) {
+	cpu->cpu_addr = htobe16(addr);
+	cpu->ctidx = type;
+	cpu->cflag = CPU_CONFIGURED;
+	cpu->weight = ded ? CPU_DEDICATED : htobe16(weight);
+	// pretend the CPUs were online for the entire time, with a management overhead of 1% on top
+	cpu->online_time = htobe64((uint64_t)cfg.uptime * 1000000);
+	cpu->lp_time = htobe64(busy);
+	cpu->acc_time = htobe64(busy + busy / 100);
+}
+
+// Physical CPUs only report the management time, which we pretend to be 1% of the uptime
+static void fill_phys_cpu(struct dfs_cpu_info *cpu, int addr, int type, int ded) {
+	fill_cpu(cpu, addr, type, ded, 0, 0);
+	cpu->cflag = 0;
+	cpu->online_time = 0;
+	cpu->acc_time = htobe64((uint64_t)cfg.uptime * 1000000 / 100);
+}
+
+static int gen_diag_204(void) {
+	int i, j, cps = cfg.cores - cfg.ifls, pools = 0, rc, addr = 0, shared = cfg.lpars - cfg.dedicated;
+	uint64_t busy = (uint64_t)cfg.uptime * 1000000 * cfg.busy / 100;
+	// in units of 2^-12 microseconds, starting at an arbitrary point in time
+	uint64_t tod = (0x123456789ull + (uint64_t)cfg.uptime * 1000000) << 12;
+	struct dfs_info_blk_hdr *info;
+	struct dfs_cpu_info *cpu;
+	struct dfs_sys_hdr *sys;
+	struct dfs_diag_hdr *hdr;
+	char name[NAME_LEN + 1];
+	size_t len;
+	uint8_t *buf, *p;
+
+	len = sizeof(*hdr) + sizeof(*info) + (cfg.lpars + 1) * sizeof(*sys) +
+	      (cfg.lpars + MAX_CPUS) * (cfg.cores + cfg.ziips) * sizeof(*cpu);
+	if ((buf = calloc(1, len)) == NULL)
+		return -1;
+	hdr = (struct dfs_diag_hdr *)buf;
+	info = (struct dfs_info_blk_hdr *)(hdr + 1);
+	info->npar = cfg.lpars;
+	info->flags = CPU_FLAG_PHYS;
+	info->curtod1 = htobe64(tod);
+	info->curtod2 = htobe64(tod);
+	p = (uint8_t *)(info + 1);
+	for (i = 0; i < cfg.lpars; ++i) {
+		sys = (struct dfs_sys_hdr *)p;
+		if (is_own_lpar(i)) {
+			info->thispart = htobe16(p - (uint8_t *)info);
+			if (cfg.group_cap)
+				to_ebcdic(sys->grp_name, "GROUP1", NAME_LEN);
+		}
+		sys->cpus = sys->rcpus = cfg.cores + (is_own_lpar(i) ? 0 : cfg.ziips);
+		lpar_name(name, i);
+		to_ebcdic(sys->sys_name, name, NAME_LEN);
+		cpu = (struct dfs_cpu_info *)(sys + 1);
+		for (j = 0; j < cfg.cores; ++j, ++cpu) {
+			fill_cpu(cpu, j, j < cps ? CPU_TYPE_CP : CPU_TYPE_IFL, is_dedicated_lpar(i),
+				 is_own_lpar(i) ? cfg.weight : 100, is_dedicated_lpar(i) ? busy : busy / shared);
+			if (is_own_lpar(i) && cfg.abs_cap) {
+				cpu->cflag |= CPU_CAPPED;
+				cpu->cpuTypeCap = htobe32(cfg.abs_cap);
+			}
+			if (is_own_lpar(i) && cfg.group_cap)
+				cpu->groupCpuTypeCap = htobe32(cfg.group_cap);
+		}
+		// the zIIPs are shared among all LPARs except ours
+		for (j = 0; j < cfg.ziips && !is_own_lpar(i); ++j, ++cpu)
+			fill_cpu(cpu, cfg.cores + j, CPU_TYPE_ZIIP, 0, 100, busy / (cfg.lpars - 1));
+		p = (uint8_t *)cpu;
+	}
+
+	// physical CPUs: each LPAR with dedicated cores has its own, all others share a single pool
+	sys = (struct dfs_sys_hdr *)p;
+	to_ebcdic(sys->sys_name, "PHYSICAL", NAME_LEN);
+	cpu = (struct dfs_cpu_info *)(sys + 1);
+	for (i = 0; i < cfg.lpars; ++i) {
+		if (!is_dedicated_lpar(i) && pools++ > 0)
+			continue;
+		for (j = 0; j < cfg.cores; ++j, ++cpu, ++addr)
+			fill_phys_cpu(cpu, addr, j < cps ? CPU_TYPE_CP : CPU_TYPE_IFL, is_dedicated_lpar(i));
+	}
+	for (j = 0; j < cfg.ziips && cfg.lpars > 1; ++j, ++cpu, ++addr)
+		fill_phys_cpu(cpu, addr, CPU_TYPE_ZIIP, 0);
+	sys->cpus = addr;
+	len = (uint8_t *)cpu - buf;
+	hdr->len = htobe64(len - sizeof(*hdr));
+	hdr->count = htobe64(1);
+	rc = write_file("s390_hypfs/diag_204", buf, len);
+	free(buf);
+
+	return rc;
+}
+
+static int gen_diag_2fc(void) {
+	uint64_t uptime = (uint64_t)cfg.uptime * 1000000;
+	struct dfs_diag2fc *data;
+	struct dfs_diag_hdr *hdr;
+	char name[NAME_LEN + 1];
+	uint32_t samp;
+	size_t len;
+	int i, rc;
+
+	len = sizeof(*hdr) + cfg.guests * sizeof(*data);
+	if ((hdr = calloc(1, len)) == NULL)
+		return -1;
+	hdr->len = htobe64(len - sizeof(*hdr));
+	hdr->count = htobe64(cfg.guests);
+	// our own guest comes last, as it is searched for by name
+	for (i = 0, data = (struct dfs_diag2fc *)(hdr + 1); i < cfg.guests; ++i, ++data) {
+		data->version = htobe32(2);
+		data->vcpus = data->ocpus = htobe32(i == cfg.guests - 1 ? cfg.vcpus : 1 + i % 4);
+		data->pcpus = data->lcpus = htobe32(cfg.cores);
+		data->flags = htobe32(cfg.guest_cap << 1);
+		data->cpu_max = htobe32(10000);
+		data->cpu_shares = htobe32(100);
+		data->mem_max_kb = htobe64(4194304);
+		data->mem_used_kb = htobe64(1048576);
+		// all guests logged on at IPL, sampled once per second
+		data->el_time = htobe64(uptime);
+		data->used_cpu = htobe64(uptime * cfg.busy / 100 * htobe32(data->vcpus));
+		data->total_samp = htobe32(cfg.uptime);
+		data->cpu_delay_samp = htobe32(cfg.uptime * 5 / 100);
+		data->page_wait_samp = htobe32(cfg.uptime / 100);
+		data->other_samp = htobe32(cfg.uptime * 4 / 100);
+		samp = cfg.uptime - htobe32(data->cpu_delay_samp) - htobe32(data->page_wait_samp) - htobe32(data->other_samp);
+		data->cpu_use_samp = htobe32(samp * cfg.busy / 100);
+		data->idle_samp = htobe32(samp - samp * cfg.busy / 100);
+		if (i == cfg.guests - 1)
+			zvm_guest_name(name, cfg.zvm_levels - 1);
+		else
+			snprintf(name, sizeof(name), "G%07u", (unsigned int)i % 10000000);
+		to_ebcdic(data->guest_name, name, NAME_LEN);
+	}
+	rc = write_file("s390_hypfs/diag_2fc", hdr, len);
+	free(hdr);
+
+	return rc;
+}
+
+/* Capacities are in units of 1/0x10000 cores */
+// The KVM guests of a KVM host are busy as given, and started at the same time the CPUs went online
+static int gen_kvm_guests(void) {
+	uint64_t uptime = (uint64_t)cfg.uptime * 1000000;
+	char *buf = NULL;
+	size_t len = 0;
+	int i, rc;
+	FILE *f;
+
+	if ((f = open_memstream(&buf, &len)) == NULL)
+		return -1;
+	for (i = 0; i < cfg.kvm_guests; ++i)
+		fprintf(f, "%d %llu %llu kvmguest%d\n", cfg.vcpus,
+			(unsigned long long)(uptime * cfg.busy / 100 * cfg.vcpus), (unsigned long long)uptime, i);
+	fclose(f);
+	rc = write_file("kvm_guests", buf, len);
+	free(buf);
+
+	return rc;
+}
+
+// The virtual CPUs of the KVM guest are busy as given, and were not dispatched for 2% of the uptime
+static int gen_proc_stat(void) {
+	uint64_t hz = sysconf(_SC_CLK_TCK), total = (uint64_t)cfg.uptime * hz, steal = total * 2 / 100;
+	uint64_t busy = (total - steal) * cfg.busy / 100, idle = total - steal - busy;
+	char *buf = NULL;
+	size_t len = 0;
+	int i, rc;
+	FILE *f;
+
+	if ((f = open_memstream(&buf, &len)) == NULL)
+		return -1;
+	fprintf(f, "cpu  %llu 0 %llu %llu 0 0 0 %llu 0 0\n", (unsigned long long)(busy - busy / 4) * cfg.vcpus,
+		(unsigned long long)(busy / 4) * cfg.vcpus, (unsigned long long)idle * cfg.vcpus,
+		(unsigned long long)steal * cfg.vcpus);
+	for (i = 0; i < cfg.vcpus; ++i)
+		fprintf(f, "cpu%d %llu 0 %llu %llu 0 0 0 %llu 0 0\n", i, (unsigned long long)(busy - busy / 4),
+			(unsigned long long)busy / 4, (unsigned long long)idle, (unsigned long long)steal);
+	fprintf(f, "btime 1526481231\n");
+	fclose(f);
+	rc = write_file("proc_stat", buf, len);
+	free(buf);
+
+	return rc;
+}
+
+// One CPU per core, with 4 cores per socket and 16 cores per book and drawer. Vertical polarization
+// follows the entitlement of our LPAR within the shared pool: Full cores are high, a remainder is medium.
+static int gen_topology(void) {
+	int i, high = cfg.cores, medium = 0, rc, ent;
+	char *buf = NULL;
+	const char *pol;
+	size_t len = 0;
+	FILE *f;
+
+	if (!is_dedicated_lpar(cfg.own)) {
+		// in hundredths of cores
+		ent = cfg.cores * 100 * cfg.weight / (cfg.weight + 100 * (cfg.lpars - cfg.dedicated - 1));
+		high = ent / 100;
+		medium = ent % 100 ? 1 : 0;
+	}
+	if ((f = open_memstream(&buf, &len)) == NULL)
+		return -1;
+	for (i = 0; i < cfg.cores; ++i) {
+		if (i < high)
+			pol = "vertical:high";
+		else if (i < high + medium)
+			pol = "vertical:medium";
+		else
+			pol = "vertical:low";
+		fprintf(f, "%d %s %d %d %d %d\n", i, pol, i / 16, i / 16, i / 4, i);
+	}
+	fclose(f);
+	rc = write_file("topology", buf, len);
+	free(buf);
+
+	return rc;
+}
+
+// MemTotal depends on the highest layer, which in case of a z/VM guest stays below the guest's maximum memory
+static int gen_memory(void) {
+	long long total = cfg.kvm ? 2031616 : cfg.zvm_levels ? 4128768 : 16646144;
+	char buf[64];
+	int len;
+
+	if (cfg.mem_limit)
+		len = snprintf(buf, sizeof(buf), "%lld %lld\n", total, (long long)cfg.mem_limit * 1024);
+	else
+		len = snprintf(buf, sizeof(buf), "%lld max\n", total);
+
+	return write_file("memory", buf, len);
+}
+
+static int gen_sthyi(void) {
+	int i, cps = cfg.cores - cfg.ifls, ded = is_dedicated_lpar(cfg.own), levels;
+	int pool_cps = cps, pool_ifls = cfg.ifls, ded_cps = 0, ded_ifls = 0;
+	struct inf0par *par;
+	struct inf0mac *mac;
+	struct inf0hdr *hdr;
+	struct inf0hyp *hyp;
+	struct inf0gst *gst;
+	char name[NAME_LEN + 1];
+	uint8_t *buf, *p;
+	int rc;
+
+	if ((buf = calloc(1, STHYI_BUF_SIZE)) == NULL)
+		return -1;
+	if (cfg.dedicated == cfg.lpars)
+		pool_cps = pool_ifls = 0;
+	for (i = 0; i < cfg.dedicated; ++i) {
+		ded_cps += cps;
+		ded_ifls += cfg.ifls;
+	}
+	levels = cfg.zvm_levels < MAX_STHYI_LEVELS ? cfg.zvm_levels : MAX_STHYI_LEVELS;
+	hdr = (struct inf0hdr *)buf;
+	mac = (struct inf0mac *)(buf + INF0HDSZ);
+	par = (struct inf0par *)((uint8_t *)mac + INF0MSIZ);
+	p = (uint8_t *)par + INF0PSIZ;
+	hdr->infhygct = levels;
+	hdr->infhtotl = htobe16(STHYI_BUF_SIZE);
+	hdr->infhdln = htobe16(INF0HDSZ);
+	hdr->infmoff = htobe16((uint8_t *)mac - buf);
+	hdr->infmlen = htobe16(INF0MSIZ);
+	hdr->infpoff = htobe16((uint8_t *)par - buf);
+	hdr->infplen = htobe16(INF0PSIZ);
+
+	mac->infmval1 = INFMPROC | INFMMID | INFMMNAM;
+	mac->infmscps = htobe16(pool_cps);
+	mac->infmdcps = htobe16(ded_cps);
+	mac->infmsifl = htobe16(pool_ifls);
+	mac->infmdifl = htobe16(ded_ifls);
+	to_ebcdic((char *)mac->infmname, "CEC1", sizeof(mac->infmname));
+	to_ebcdic((char *)mac->infmtype, "3906", sizeof(mac->infmtype));
+	to_ebcdic((char *)mac->infmmanu, "IBM", sizeof(mac->infmmanu));
+	to_ebcdic((char *)mac->infmseq, "0000000000012345", sizeof(mac->infmseq));
+	to_ebcdic((char *)mac->infmpman, "02", sizeof(mac->infmpman));
+
+	par->infpval1 = INFPPROC | INFPACC | INFPPID;
+	par->infppnum = htobe16(cfg.own + 1);
+	par->infpscps = htobe16(ded ? 0 : cps);
+	par->infpdcps = htobe16(ded ? cps : 0);
+	par->infpsifl = htobe16(ded ? 0 : cfg.ifls);
+	par->infpdifl = htobe16(ded ? cfg.ifls : 0);
+	lpar_name(name, cfg.own);
+	to_ebcdic((char *)par->infppnam, name, sizeof(par->infppnam));
+	par->infpabcp = htobe32(cps ? cfg.abs_cap * 0x10000 / 100 : 0);
+	par->infpabif = htobe32(cfg.ifls ? cfg.abs_cap * 0x10000 / 100 : 0);
+	if (cfg.abs_cap && !ded) {
+		// matches the share of the weights, with all LPARs except ours having a weight of 100
+		int sh = cfg.lpars - cfg.dedicated - 1;
+
+		par->infpval1 |= INFPWBCC;
+		par->infpwbcp = htobe32(cps ? (int64_t)pool_cps * 0x10000 * cfg.weight / (cfg.weight + sh * 100) : 0);
+		par->infpwbif = htobe32(cfg.ifls ? (int64_t)pool_ifls * 0x10000 * cfg.weight / (cfg.weight + sh * 100) : 0);
+	}
+	if (cfg.group_cap) {
+		par->infpval1 |= INFPLGVL;
+		to_ebcdic((char *)par->infplgnm, "GROUP1", sizeof(par->infplgnm));
+		par->infplgcp = htobe32(cps ? cfg.group_cap * 0x10000 / 100 : 0);
+		par->infplgif = htobe32(cfg.ifls ? cfg.group_cap * 0x10000 / 100 : 0);
+	}
+
+	// hypervisor and guest sections, from the bottom up
+	for (i = 0; i < levels; ++i) {
+		hyp = (struct inf0hyp *)p;
+		gst = (struct inf0gst *)(p + INF0YSIZ);
+		if (i == 0) {
+			hdr->infhoff1 = htobe16((uint8_t *)hyp - buf);
+			hdr->infgoff1 = htobe16((uint8_t *)gst - buf);
+		} else if (i == 1) {
+			hdr->infhoff2 = htobe16((uint8_t *)hyp - buf);
+			hdr->infgoff2 = htobe16((uint8_t *)gst - buf);
+		} else {
+			hdr->infhoff3 = htobe16((uint8_t *)hyp - buf);
+			hdr->infgoff3 = htobe16((uint8_t *)gst - buf);
+		}
+		hyp->infytype = INFYTVM;
+		// levels are limited to MAX_STHYI_LEVELS, so this never truncates
+		snprintf(name, sizeof(name), "ZVM%d", i);
+		to_ebcdic((char *)hyp->infysyid, name, sizeof(hyp->infysyid));
+		if (i == 0) {
+			// the LPAR's cores
+			hyp->infyscps = par->infpscps;
+			hyp->infydcps = par->infpdcps;
+			hyp->infysifl = par->infpsifl;
+			hyp->infydifl = par->infpdifl;
+		} else if (cfg.ifls) {
+			// the virtual CPUs of the guest below
+			hyp->infysifl = htobe16(cfg.vcpus);
+		} else
+			hyp->infyscps = htobe16(cfg.vcpus);
+
+		zvm_guest_name(name, i);
+		to_ebcdic((char *)gst->infgusid, name, sizeof(gst->infgusid));
+		if (cfg.ifls) {
+			gst->infgsifl = htobe16(cfg.vcpus);
+			gst->infgifdt = CPU_TYPE_IFL;
+			if (cfg.guest_cap) {
+				gst->infgifcc = htobe32(0x10000);
+				if (cfg.guest_cap == 2)
+					gst->infgflg1 |= INFGIFLH;
+			}
+		} else {
+			gst->infgscps = htobe16(cfg.vcpus);
+			gst->infgcpdt = CPU_TYPE_CP;
+			if (cfg.guest_cap) {
+				gst->infgcpcc = htobe32(0x10000);
+				if (cfg.guest_cap == 2)
+					gst->infgflg1 |= INFGCPLH;
+			}
+		}
+		to_ebcdic((char *)gst->infgpnam, "", sizeof(gst->infgpnam));
+		p += INF0YSIZ + INF0GSIZ;
+	}
+	rc = write_file("sthyi", buf, STHYI_BUF_SIZE);
+	free(buf);
+
+	return rc;
+}
+
+static void print_help() {
+	printf("\n");
+	printf("Usage: qc_gen [-h] [<options>] <dir>\n");
+	printf("\n");
+	printf("Generate synthetic source data in the dump layout in directory <dir>, to be\n");
+	printf("used with QC_USE_DUMP, qc_replay or qc_bench.\n");
+	printf("Our LPAR is the last one, unless its data would be out of reach of the 16 bit\n");
+	printf("offset in diag_204, in which case it is the last one within reach.\n");
+	printf("\n");
+	printf("  -h, --help            Print usage information and exit\n");
+	printf("  -l, --lpars <n>       Number of LPARs, up to %d. Defaults to 3.\n", MAX_LPARS);
+	printf("  -c, --cores <n>       Number of cores per LPAR. Defaults to 4.\n");
+	printf("  -i, --ifls <n>        Number of cores per LPAR that are IFLs, all others are\n");
+	printf("                        CPs. Defaults to all cores.\n");
+	printf("  -Z, --ziips <n>       Number of shared zIIPs of each LPAR except ours.\n");
+	printf("                        Defaults to 0.\n");
+	printf("  -d, --dedicated <n>   Number of LPARs with dedicated cores. Defaults to 0.\n");
+	printf("  -w, --weight <n>      Weight of our LPAR, all others have 100. Defaults to 100.\n");
+	printf("  -a, --abs-cap <n>     Absolute capping of our LPAR in hundredths of cores.\n");
+	printf("  -g, --group-cap <n>   Add our LPAR to an LPAR group with an absolute capping\n");
+	printf("                        of <n> hundredths of cores.\n");
+	printf("  -z, --zvm <n>         Number of nested z/VM hypervisors. Defaults to 0.\n");
+	printf("  -k, --kvm             Run in a KVM guest on top.\n");
+	printf("  -K, --kvm-guests <n>  Number of KVM guests run by the highest layer unless\n");
+	printf("                        '-k' is given. Defaults to 0.\n");
+	printf("  -G, --guests <n>      Number of z/VM guests. Defaults to 10.\n");
+	printf("  -v, --vcpus <n>       Number of virtual CPUs per z/VM and KVM guest. Defaults\n");
+	printf("                        to 2.\n");
+	printf("  -C, --guest-cap <c>   Capping of the z/VM guests: 'off' (default), 'soft' or\n");
+	printf("                        'hard'.\n");
+	printf("  -t, --time <s>        Time in seconds that the cores were online and the z/VM\n");
+	printf("                        guests were logged on, determining the TOD clock in\n");
+	printf("                        diag_204. Defaults to 3600.\n");
+	printf("  -b, --busy <p>        Percentage of time that the physical cores were busy,\n");
+	printf("                        with the shared ones split evenly among the LPARs\n");
+	printf("                        with shared cores, and that the virtual CPUs of the\n");
+	printf("                        z/VM and KVM guests were busy. Defaults to 50. Use\n");
+	printf("                        two directories generated with different times to\n");
+	printf("                        test utilization.\n");
+	printf("  -m, --memory <n>      Memory limit in MB of the control group that we run\n");
+	printf("                        in. Defaults to no limit.\n");
+	printf("\n");
+}
+
+int main(int argc, char **argv) {
+	static struct option long_options[] = {
+		{ "help",	no_argument,	   NULL, 'h'},
+		{ "lpars",	required_argument, NULL, 'l'},
+		{ "cores",	required_argument, NULL, 'c'},
+		{ "ifls",	required_argument, NULL, 'i'},
+		{ "ziips",	required_argument, NULL, 'Z'},
+		{ "dedicated",	required_argument, NULL, 'd'},
+		{ "weight",	required_argument, NULL, 'w'},
+		{ "abs-cap",	required_argument, NULL, 'a'},
+		{ "group-cap",	required_argument, NULL, 'g'},
+		{ "zvm",	required_argument, NULL, 'z'},
+		{ "kvm",	no_argument,	   NULL, 'k'},
+		{ "kvm-guests",	required_argument, NULL, 'K'},
+		{ "guests",	required_argument, NULL, 'G'},
+		{ "vcpus",	required_argument, NULL, 'v'},
+		{ "guest-cap",	required_argument, NULL, 'C'},
+		{ "time",	required_argument, NULL, 't'},
+		{ "busy",	required_argument, NULL, 'b'},
+		{ "memory",	required_argument, NULL, 'm'},
+		{ 0,		0,		   0,	 0  }
+	};
+	int c;
+
+	while ((c = getopt_long(argc, argv, "hl:c:i:Z:d:w:a:g:z:kK:G:v:C:t:b:m:", long_options, NULL)) != EOF) {
+		switch (c) {
+		case 'h': print_help();
+			  return 0;
+		case 'l': cfg.lpars = atoi(optarg);
+			  break;
+		case 'c': cfg.cores = atoi(optarg);
+			  break;
+		case 'i': cfg.ifls = atoi(optarg);
+			  break;
+		case 'Z': cfg.ziips = atoi(optarg);
+			  break;
+		case 'd': cfg.dedicated = atoi(optarg);
+			  break;
+		case 'w': cfg.weight = atoi(optarg);
+			  break;
+		case 'a': cfg.abs_cap = atoi(optarg);
+			  break;
+		case 'g': cfg.group_cap = atoi(optarg);
+			  break;
+		case 'z': cfg.zvm_levels = atoi(optarg);
+			  break;
+		case 'k': cfg.kvm = 1;
+			  break;
+		case 'K': cfg.kvm_guests = atoi(optarg);
+			  break;
+		case 'G': cfg.guests = atoi(optarg);
+			  break;
+		case 'v': cfg.vcpus = atoi(optarg);
+			  break;
+		case 'C': if (!strcmp(optarg, "off"))
+				cfg.guest_cap = 0;
+			  else if (!strcmp(optarg, "soft"))
+				cfg.guest_cap = 1;
+			  else if (!strcmp(optarg, "hard"))
+				cfg.guest_cap = 2;
+			  else {
+				print_help();
+				return 1;
+			  }
+			  break;
+		case 't': cfg.uptime = atoi(optarg);
+			  break;
+		case 'b': cfg.busy = atoi(optarg);
+			  break;
+		case 'm': cfg.mem_limit = atoi(optarg);
+			  break;
+		default:  print_help();
+			  return 1;
+		}
+	}
+	if (optind != argc - 1) {
+		print_help();
+		return 1;
+	}
+	cfg.dir = argv[optind];
+	if (cfg.ifls < 0)
+		cfg.ifls = cfg.cores;
+	if (cfg.lpars < 1 || cfg.lpars > MAX_LPARS || cfg.cores < 1 || cfg.ifls > cfg.cores || cfg.ziips < 0 ||
+	    cfg.dedicated < 0 || cfg.dedicated > cfg.lpars || cfg.weight < 1 || cfg.weight > 999 ||
+	    cfg.abs_cap < 0 || cfg.group_cap < 0 || cfg.zvm_levels < 0 || cfg.zvm_levels > MAX_ZVM_LEVELS ||
+	    cfg.kvm_guests < 0 || cfg.guests < 1 || cfg.vcpus < 1 || cfg.vcpus > cfg.cores || cfg.uptime < 1 ||
+	    cfg.busy < 0 || cfg.busy > 100 || cfg.mem_limit < 0) {
+		fprintf(stderr, "Error: Invalid parameters, see 'qc_gen -h'\n");
+		return 1;
+	}
+	if (cfg.cores * (cfg.dedicated + (cfg.dedicated < cfg.lpars ? 1 : 0)) + cfg.ziips > MAX_CPUS ||
+	    cfg.cores + cfg.ziips > MAX_CPUS) {
+		fprintf(stderr, "Error: Configuration requires more than %d physical cores\n", MAX_CPUS);
+		return 1;
+	}
+	// diag_204 refers to our LPAR by a 16 bit offset, so we want its data as far away as possible
+	cfg.own = (UINT16_MAX - sizeof(struct dfs_info_blk_hdr)) /
+		  (sizeof(struct dfs_sys_hdr) + (cfg.cores + cfg.ziips) * sizeof(struct dfs_cpu_info));
+	if (cfg.own > cfg.lpars - 1)
+		cfg.own = cfg.lpars - 1;
+	if (mkdir(cfg.dir, 0755) && errno != EEXIST) {
+		fprintf(stderr, "Error: Failed to create directory '%s': %s\n", cfg.dir, strerror(errno));
+		return 1;
+	}
+	if (write_file("ocf/cpc_name", "CEC1\n", 5) || gen_sysinfo() || gen_memory())
+		return 2;
+	if (cfg.kvm)	// neither hypfs nor STHYI are available in KVM guests
+		return gen_proc_stat() ? 2 : 0;
+	if (cfg.kvm_guests && gen_kvm_guests())
+		return 2;
+	if (cfg.zvm_levels) {
+		// the LPAR diag file is always present, but its content is invalid
+		if (write_file("s390_hypfs/diag_204", NULL, 0) || gen_diag_2fc())
+			return 2;
+	} else if (gen_diag_204() || gen_topology())
+		return 2;
+	if (gen_sthyi())
+		return 2;
+
+	return 0;
+}
@@ -0,0 +1,498 @@
+/* Copyright IBM Corp. 2018 */
+
+/* Replays a corpus of dumps in parallel using qc_open_from_buffers(), writing one JSON record
+   per dump with all layers, attributes and tables to stdout, followed by a summary on stderr. */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "query_capacity.h"
+
+
+struct dump_file {
+	int		 type;
+	const char	*fname;
+};
+
+static const struct dump_file dump_files[] = {
+	{QC_SOURCE_SYSINFO,		"sysinfo"},
+	{QC_SOURCE_OCF_CPC_NAME,	"ocf/cpc_name"},
+	{QC_SOURCE_HYPFS_DIAG_204,	"s390_hypfs/diag_204"},
+	{QC_SOURCE_HYPFS_DIAG_2FC,	"s390_hypfs/diag_2fc"},
+	{QC_SOURCE_STHYI,		"sthyi"},
+	{QC_SOURCE_PROC_STAT,		"proc_stat"},
+	{QC_SOURCE_KVM_GUESTS,		"kvm_guests"},
+	{QC_SOURCE_TOPOLOGY,		"topology"},
+	{QC_SOURCE_MEMORY,		"memory"},
+};
+#define NUM_DUMP_FILES	(int)(sizeof(dump_files) / sizeof(dump_files[0]))
+
+// return codes of qc_open_from_buffers() that are no errors
+#define RC_INCOMPLETE	1
+#define RC_INCONSISTENT	2
+
+struct result {
+	int	rc;
+	double	usecs;	// time spent in qc_open_from_buffers()
+};
+
+static char		**dumps;
+static int		  num_dumps;
+static int		  next_dump;
+static struct result	 *results;
+static pthread_mutex_t	  out_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static double now_usecs(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Names of attributes and tables, used as keys in the records. Ids that are not known here, e.g. as
+// added to the library later on, map to "unknown" to keep the records valid JSON
+static const char *attr2char(enum qc_attr_id id) {
+	switch (id) {
+	case qc_layer_type_num: return "layer_type_num";
+	case qc_layer_category_num: return "layer_category_num";
+	case qc_layer_type: return "layer_type";
+	case qc_layer_category: return "layer_category";
+	case qc_layer_name: return "layer_name";
+	case qc_layer_extended_name: return "layer_extended_name";
+	case qc_layer_uuid: return "layer_uuid";
+	case qc_manufacturer: return "manufacturer";
+	case qc_type: return "type";
+	case qc_model_capacity: return "model_capacity";
+	case qc_model: return "model";
+	case qc_sequence_code: return "sequence_code";
+	case qc_plant: return "plant";
+	case qc_num_cpu_total: return "num_cpu_total";
+	case qc_num_cpu_configured: return "num_cpu_configured";
+	case qc_num_cpu_standby: return "num_cpu_standby";
+	case qc_num_cpu_reserved: return "num_cpu_reserved";
+	case qc_num_cpu_dedicated: return "num_cpu_dedicated";
+	case qc_num_cpu_shared: return "num_cpu_shared";
+	case qc_num_cp_total: return "num_cp_total";
+	case qc_num_cp_dedicated: return "num_cp_dedicated";
+	case qc_num_cp_shared: return "num_cp_shared";
+	case qc_num_ifl_total: return "num_ifl_total";
+	case qc_num_ifl_dedicated: return "num_ifl_dedicated";
+	case qc_num_ifl_shared: return "num_ifl_shared";
+	case qc_capability: return "capability";
+	case qc_secondary_capability: return "secondary_capability";
+	case qc_capacity_adjustment_indication: return "capacity_adjustment_indication";
+	case qc_capacity_change_reason: return "capacity_change_reason";
+	case qc_partition_number: return "partition_number";
+	case qc_partition_char: return "partition_char";
+	case qc_partition_char_num: return "partition_char_num";
+	case qc_adjustment: return "adjustment";
+	case qc_cp_absolute_capping: return "cp_absolute_capping";
+	case qc_ifl_absolute_capping: return "ifl_absolute_capping";
+	case qc_cp_weight_capping: return "cp_weight_capping";
+	case qc_ifl_weight_capping: return "ifl_weight_capping";
+	case qc_cluster_name: return "cluster_name";
+	case qc_control_program_id: return "control_program_id";
+	case qc_hardlimit_consumption: return "hardlimit_consumption";
+	case qc_prorated_core_time: return "prorated_core_time";
+	case qc_cp_limithard_cap: return "pool_cp_limithard_cap";
+	case qc_cp_capacity_cap: return "pool_cp_capacity_cap";
+	case qc_ifl_limithard_cap: return "pool_ifl_limithard_cap";
+	case qc_ifl_capacity_cap: return "pool_ifl_capacity_cap";
+	case qc_capping: return "capping";
+	case qc_capping_num: return "capping_num";
+	case qc_mobility_enabled: return "mobility_enabled";
+	case qc_has_multiple_cpu_types: return "has_multiple_cpu_types";
+	case qc_cp_dispatch_limithard: return "cp_dispatch_limithard";
+	case qc_ifl_dispatch_limithard: return "ifl_dispatch_limithard";
+	case qc_cp_dispatch_type: return "cp_dispatch_type";
+	case qc_ifl_dispatch_type: return "ifl_dispatch_type";
+	case qc_cp_capped_capacity: return "cp_capped_capacity";
+	case qc_ifl_capped_capacity: return "ifl_capped_capacity";
+	case qc_num_cp_threads: return "num_cp_threads";
+	case qc_num_ifl_threads: return "num_ifl_threads";
+	case qc_num_core_total: return "num_core_total";
+	case qc_num_core_configured: return "num_core_configured";
+	case qc_num_core_standby: return "num_core_standby";
+	case qc_num_core_reserved: return "num_core_reserved";
+	case qc_num_core_dedicated: return "num_core_dedicated";
+	case qc_num_core_shared: return "num_core_shared";
+	case qc_cp_utilization: return "cp_utilization";
+	case qc_ifl_utilization: return "ifl_utilization";
+	case qc_cp_consumption: return "cp_consumption";
+	case qc_ifl_consumption: return "ifl_consumption";
+	case qc_cpu_address: return "cpu_address";
+	case qc_cpu_type: return "cpu_type";
+	case qc_cpu_type_num: return "cpu_type_num";
+	case qc_dedicated: return "dedicated";
+	case qc_cpu_time: return "cpu_time";
+	case qc_mgmt_time: return "mgmt_time";
+	case qc_online_time: return "online_time";
+	case qc_utilization: return "utilization";
+	case qc_lpar_group_name: return "lpar_group_name";
+	case qc_cp_weight: return "cp_weight";
+	case qc_ifl_weight: return "ifl_weight";
+	case qc_cp_group_capping: return "cp_group_capping";
+	case qc_ifl_group_capping: return "ifl_group_capping";
+	case qc_cpu_max: return "cpu_max";
+	case qc_cpu_shares: return "cpu_shares";
+	case qc_mem_min: return "mem_min";
+	case qc_mem_max: return "mem_max";
+	case qc_mem_share: return "mem_share";
+	case qc_mem_used: return "mem_used";
+	case qc_cpu_consumption: return "cpu_consumption";
+	case qc_cpu_delay: return "cpu_delay";
+	case qc_page_wait: return "page_wait";
+	case qc_cpu_use_samples: return "cpu_use_samples";
+	case qc_cpu_delay_samples: return "cpu_delay_samples";
+	case qc_page_wait_samples: return "page_wait_samples";
+	case qc_idle_samples: return "idle_samples";
+	case qc_other_samples: return "other_samples";
+	case qc_total_samples: return "total_samples";
+	case qc_steal_time: return "steal_time";
+	case qc_steal: return "steal";
+	case qc_overcommit: return "overcommit";
+	case qc_cp_time: return "cp_time";
+	case qc_ifl_time: return "ifl_time";
+	case qc_num_ziip_total: return "num_ziip_total";
+	case qc_num_ziip_dedicated: return "num_ziip_dedicated";
+	case qc_num_ziip_shared: return "num_ziip_shared";
+	case qc_num_icf_total: return "num_icf_total";
+	case qc_num_icf_dedicated: return "num_icf_dedicated";
+	case qc_num_icf_shared: return "num_icf_shared";
+	case qc_ziip_absolute_capping: return "ziip_absolute_capping";
+	case qc_icf_absolute_capping: return "icf_absolute_capping";
+	case qc_ziip_weight_capping: return "ziip_weight_capping";
+	case qc_icf_weight_capping: return "icf_weight_capping";
+	case qc_ziip_weight: return "ziip_weight";
+	case qc_icf_weight: return "icf_weight";
+	case qc_polarization: return "polarization";
+	case qc_polarization_num: return "polarization_num";
+	case qc_drawer_id: return "drawer_id";
+	case qc_book_id: return "book_id";
+	case qc_socket_id: return "socket_id";
+	case qc_core_id: return "core_id";
+	case qc_num_cpu_horizontal: return "num_cpu_horizontal";
+	case qc_num_cpu_vertical_low: return "num_cpu_vertical_low";
+	case qc_num_cpu_vertical_medium: return "num_cpu_vertical_medium";
+	case qc_num_cpu_vertical_high: return "num_cpu_vertical_high";
+	case qc_num_drawers: return "num_drawers";
+	case qc_num_core_per_drawer: return "num_core_per_drawer";
+	case qc_cp_effective_capacity: return "cp_effective_capacity";
+	case qc_ifl_effective_capacity: return "ifl_effective_capacity";
+	case qc_cp_guaranteed_capacity: return "cp_guaranteed_capacity";
+	case qc_ifl_guaranteed_capacity: return "ifl_guaranteed_capacity";
+	case qc_cp_limiting_layer: return "cp_limiting_layer";
+	case qc_ifl_limiting_layer: return "ifl_limiting_layer";
+	case qc_cp_normalized_capacity: return "cp_normalized_capacity";
+	case qc_ifl_normalized_capacity: return "ifl_normalized_capacity";
+	case qc_normalized_capacity: return "normalized_capacity";
+	case qc_cp_core_equivalent_capacity: return "cp_core_equivalent_capacity";
+	case qc_ifl_core_equivalent_capacity: return "ifl_core_equivalent_capacity";
+	case qc_cp_thread_equivalent_capacity: return "cp_thread_equivalent_capacity";
+	case qc_ifl_thread_equivalent_capacity: return "ifl_thread_equivalent_capacity";
+	case qc_mem_total: return "mem_total";
+	case qc_mem_limit: return "mem_limit";
+	case qc_mem_effective: return "mem_effective";
+	case qc_mem_limiting_layer: return "mem_limiting_layer";
+	default: break;
+	}
+
+	return "unknown";
+}
+
+static const char *table2char(enum qc_table_id id) {
+	switch (id) {
+	case qc_table_cpus: return "cpus";
+	case qc_table_lpars: return "lpars";
+	case qc_table_zvm_guests: return "zvm_guests";
+	case qc_table_kvm_guests: return "kvm_guests";
+	case qc_table_topology: return "topology";
+	default: break;
+	}
+
+	return "unknown";
+}
+
+static int read_file(const char *dump, const char *fname, struct qc_source_buffer *buf) {
+	char path[PATH_MAX];
+	struct stat sbuf;
+	size_t len;
+	FILE *f;
+	void *data;
+
+	snprintf(path, PATH_MAX, "%s/%s", dump, fname);
+	if (stat(path, &sbuf))
+		return 0;	// not every dump contains data from every source
+	if ((f = fopen(path, "r")) == NULL)
+		return -1;
+	data = malloc(sbuf.st_size + 1);
+	len = data ? fread(data, 1, sbuf.st_size, f) : 0;
+	fclose(f);
+	if (!data || len != (size_t)sbuf.st_size) {
+		free(data);
+		return -1;
+	}
+	buf->data = data;
+	buf->len = len;
+
+	return 0;
+}
+
+static void print_json_string(FILE *f, const char *s) {
+	fputc('"', f);
+	for (; *s; ++s) {
+		if (*s == '"' || *s == '\\')
+			fprintf(f, "\\%c", *s);
+		else if ((unsigned char)*s < 0x20 || (unsigned char)*s >= 0x80)
+			fprintf(f, "\\u%04x", (unsigned char)*s);
+		else
+			fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+// JSON has no representation of NaN and infinity
+static void print_json_float(FILE *f, float fl) {
+	if (isfinite(fl))
+		fprintf(f, "%g", fl);
+	else
+		fprintf(f, "null");
+}
+
+// Prints all attributes of row 'row' that are set, iterating over the attribute ids until we hit an invalid one
+static void print_row(FILE *f, void *hdl, int table, int layer, int row) {
+	const char *s;
+	int id, i, rc, sep = 0;
+	int64_t l;
+	float fl;
+
+	fprintf(f, "{");
+	for (id = 0; (rc = qc_get_row_attribute_int(hdl, table, id, layer, row, &i)) != -2; ++id) {
+		if (rc > 0) {
+			fprintf(f, "%s\"%s\":%d", sep++ ? "," : "", attr2char(id), i);
+		} else if (qc_get_row_attribute_int64(hdl, table, id, layer, row, &l) > 0) {
+			fprintf(f, "%s\"%s\":%" PRId64, sep++ ? "," : "", attr2char(id), l);
+		} else if (qc_get_row_attribute_float(hdl, table, id, layer, row, &fl) > 0) {
+			fprintf(f, "%s\"%s\":", sep++ ? "," : "", attr2char(id));
+			print_json_float(f, fl);
+		} else if (qc_get_row_attribute_string(hdl, table, id, layer, row, &s) > 0) {
+			fprintf(f, "%s\"%s\":", sep++ ? "," : "", attr2char(id));
+			print_json_string(f, s);
+		}
+	}
+	fprintf(f, "}");
+}
+
+// Prints all attributes that are set, iterating over the attribute ids until we hit an invalid one,
+// followed by the layer's tables, if any
+static void print_layer(FILE *f, void *hdl, int layer) {
+	int id, i, rc, sep = 0, table, rows, row;
+	const char *s;
+	int64_t l;
+	float fl;
+
+	fprintf(f, "{");
+	for (id = 0; (rc = qc_get_attribute_int(hdl, id, layer, &i)) != -2; ++id) {
+		if (rc > 0) {
+			fprintf(f, "%s\"%s\":%d", sep++ ? "," : "", attr2char(id), i);
+		} else if (qc_get_attribute_int64(hdl, id, layer, &l) > 0) {
+			fprintf(f, "%s\"%s\":%" PRId64, sep++ ? "," : "", attr2char(id), l);
+		} else if (qc_get_attribute_float(hdl, id, layer, &fl) > 0) {
+			fprintf(f, "%s\"%s\":", sep++ ? "," : "", attr2char(id));
+			print_json_float(f, fl);
+		} else if (qc_get_attribute_string(hdl, id, layer, &s) > 0) {
+			fprintf(f, "%s\"%s\":", sep++ ? "," : "", attr2char(id));
+			print_json_string(f, s);
+		}
+	}
+	for (table = 0, i = 0; (rows = qc_get_num_rows(hdl, table, layer, &rc)), rc != -2; ++table) {
+		if (rc <= 0)
+			continue;
+		fprintf(f, "%s\"%s\":[", i++ ? "," : ",\"tables\":{", table2char(table));
+		for (row = 0; row < rows; ++row) {
+			if (row > 0)
+				fprintf(f, ",");
+			print_row(f, hdl, table, layer, row);
+		}
+		fprintf(f, "]");
+	}
+	if (i)
+		fprintf(f, "}");
+	fprintf(f, "}");
+}
+
+static void replay(int idx) {
+	struct qc_source_buffer bufs[NUM_DUMP_FILES];
+	int i, layers, rc = 0;
+	void *hdl = NULL;
+	char path[PATH_MAX];
+	size_t len = 0;
+	char *rec = NULL;
+	double start;
+	FILE *f;
+
+	memset(bufs, 0, sizeof(bufs));
+	snprintf(path, PATH_MAX, "%s/INCOMPLETE_DUMP.txt", dumps[idx]);
+	if (access(path, F_OK) == 0)
+		rc = RC_INCOMPLETE;
+	for (i = 0; i < NUM_DUMP_FILES && !rc; ++i) {
+		bufs[i].type = dump_files[i].type;
+		if (read_file(dumps[idx], dump_files[i].fname, &bufs[i]))
+			rc = -101;
+	}
+	if (!rc) {
+		start = now_usecs();
+		hdl = qc_open_from_buffers(bufs, NUM_DUMP_FILES, &rc);
+		results[idx].usecs = now_usecs() - start;
+	}
+	results[idx].rc = rc;
+	for (i = 0; i < NUM_DUMP_FILES; ++i)
+		free((void *)bufs[i].data);
+
+	// assemble the record first, so that records of different threads don't interleave
+	if ((f = open_memstream(&rec, &len)) == NULL)
+		goto out;
+	fprintf(f, "{\"dump\":");
+	print_json_string(f, dumps[idx]);
+	fprintf(f, ",\"rc\":%d,\"usecs\":%.1f,\"layers\":[", rc, results[idx].usecs);
+	if (hdl) {
+		layers = qc_get_num_layers(hdl, &rc);
+		for (i = 0; i < layers; ++i) {
+			if (i > 0)
+				fprintf(f, ",");
+			print_layer(f, hdl, i);
+		}
+	}
+	fprintf(f, "]}\n");
+	fclose(f);
+	pthread_mutex_lock(&out_lock);
+	fwrite(rec, 1, len, stdout);
+	pthread_mutex_unlock(&out_lock);
+	free(rec);
+
+out:
+	qc_close(hdl);
+}
+
+static void *worker(void *arg) {
+	int idx;
+
+	while ((idx = __sync_fetch_and_add(&next_dump, 1)) < num_dumps)
+		replay(idx);
+
+	return NULL;
+}
+
+static int cmp_double(const void *a, const void *b) {
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void print_summary(double wall) {
+	int i, ok = 0, failed = 0, incomplete = 0, inconsistent = 0;
+	double *usecs;
+
+	if ((usecs = malloc(num_dumps * sizeof(double))) == NULL)
+		return;
+	for (i = 0; i < num_dumps; ++i) {
+		if (results[i].rc < 0) {
+			fprintf(stderr, "Failed:       %s (rc=%d)\n", dumps[i], results[i].rc);
+			failed++;
+		} else if (results[i].rc == RC_INCONSISTENT) {
+			fprintf(stderr, "Inconsistent: %s\n", dumps[i]);
+			inconsistent++;
+		} else if (results[i].rc > 0) {
+			fprintf(stderr, "Incomplete:   %s\n", dumps[i]);
+			incomplete++;
+		}
+		if (results[i].rc == 0)
+			usecs[ok++] = results[i].usecs;
+	}
+	qsort(usecs, ok, sizeof(double), cmp_double);
+	fprintf(stderr, "\n%d dump(s) in %.3fs: %d ok, %d failed, %d incomplete, %d inconsistent\n",
+		num_dumps, wall / 1e6, ok, failed, incomplete, inconsistent);
+	if (ok)
+		fprintf(stderr, "Parse time: median %.1fus, p99 %.1fus, max %.1fus\n",
+			usecs[ok / 2], usecs[(ok * 99) / 100], usecs[ok - 1]);
+	free(usecs);
+}
+
+static void print_help() {
+	printf("\n");
+	printf("Usage: qc_replay [-h] [-j <threads>] <dump>+\n");
+	printf("\n");
+	printf("Replay dumps in parallel, writing one JSON record per dump with all layers,\n");
+	printf("attributes and tables to stdout, followed by a summary of failures,\n");
+	printf("incomplete data and consistency violations on stderr.\n");
+	printf("\n");
+	printf("  -h, --help       Print usage information and exit\n");
+	printf("  -j, --jobs       Number of threads to use. Defaults to the number of CPUs.\n");
+	printf("\n");
+}
+
+int main(int argc, char **argv) {
+	static struct option long_options[] = {
+		{ "help", no_argument,	     NULL, 'h'},
+		{ "jobs", required_argument, NULL, 'j'},
+		{ 0,	  0,		     0,	   0  }
+	};
+	int i, c, jobs = sysconf(_SC_NPROCESSORS_ONLN), rc = 0;
+	pthread_t *threads;
+	double start;
+
+	while ((c = getopt_long(argc, argv, "hj:", long_options, NULL)) != EOF) {
+		switch (c) {
+		case 'h': print_help();
+			  return 0;
+		case 'j': jobs = atoi(optarg);
+			  break;
+		default:  print_help();
+			  return 1;
+		}
+	}
+	if (optind >= argc || jobs <= 0) {
+		print_help();
+		return 1;
+	}
+	dumps = &argv[optind];
+	num_dumps = argc - optind;
+	if (jobs > num_dumps)
+		jobs = num_dumps;
+	results = calloc(num_dumps, sizeof(struct result));
+	threads = malloc(jobs * sizeof(pthread_t));
+	if (!results || !threads)
+		return 1;
+
+	start = now_usecs();
+	for (i = 0; i < jobs; ++i)
+		if (pthread_create(&threads[i], NULL, worker, NULL)) {
+			fprintf(stderr, "Error: Failed to create thread\n");
+			jobs = i;
+			rc = 1;
+			break;
+		}
+	for (i = 0; i < jobs; ++i)
+		pthread_join(threads[i], NULL);
+	print_summary(now_usecs() - start);
+	for (i = 0; i < num_dumps; ++i)
+		if (results[i].rc)
+			rc = 2;
+	free(threads);
+	free(results);
+
+	return rc;
+}
@@ -4,6 +4,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <getopt.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <endian.h>
+#include <sys/stat.h>
 
 #include "query_capacity.h"
 
@@ -90,6 +95,84 @@ const char *attr2char(enum qc_attr_id id) {
 	case qc_num_core_reserved: return "qc_num_core_reserved";
 	case qc_num_core_dedicated: return "qc_num_core_dedicated";
 	case qc_num_core_shared: return "qc_num_core_shared";
+	case qc_cp_utilization: return "qc_cp_utilization";
+	case qc_ifl_utilization: return "qc_ifl_utilization";
+	case qc_cp_consumption: return "qc_cp_consumption";
+	case qc_ifl_consumption: return "qc_ifl_consumption";
+	case qc_cpu_address: return "qc_cpu_address";
+	case qc_cpu_type: return "qc_cpu_type";
+	case qc_cpu_type_num: return "qc_cpu_type_num";
+	case qc_dedicated: return "qc_dedicated";
+	case qc_cpu_time: return "qc_cpu_time";
+	case qc_mgmt_time: return "qc_mgmt_time";
+	case qc_online_time: return "qc_online_time";
+	case qc_utilization: return "qc_utilization";
+	case qc_lpar_group_name: return "qc_lpar_group_name";
+	case qc_cp_weight: return "qc_cp_weight";
+	case qc_ifl_weight: return "qc_ifl_weight";
+	case qc_cp_group_capping: return "qc_cp_group_capping";
+	case qc_ifl_group_capping: return "qc_ifl_group_capping";
+	case qc_cpu_max: return "qc_cpu_max";
+	case qc_cpu_shares: return "qc_cpu_shares";
+	case qc_mem_min: return "qc_mem_min";
+	case qc_mem_max: return "qc_mem_max";
+	case qc_mem_share: return "qc_mem_share";
+	case qc_mem_used: return "qc_mem_used";
+	case qc_cpu_consumption: return "qc_cpu_consumption";
+	case qc_cpu_delay: return "qc_cpu_delay";
+	case qc_page_wait: return "qc_page_wait";
+	case qc_cpu_use_samples: return "qc_cpu_use_samples";
+	case qc_cpu_delay_samples: return "qc_cpu_delay_samples";
+	case qc_page_wait_samples: return "qc_page_wait_samples";
+	case qc_idle_samples: return "qc_idle_samples";
+	case qc_other_samples: return "qc_other_samples";
+	case qc_total_samples: return "qc_total_samples";
+	case qc_steal_time: return "qc_steal_time";
+	case qc_steal: return "qc_steal";
+	case qc_overcommit: return "qc_overcommit";
+	case qc_cp_time: return "qc_cp_time";
+	case qc_ifl_time: return "qc_ifl_time";
+	case qc_num_ziip_total: return "qc_num_ziip_total";
+	case qc_num_ziip_dedicated: return "qc_num_ziip_dedicated";
+	case qc_num_ziip_shared: return "qc_num_ziip_shared";
+	case qc_num_icf_total: return "qc_num_icf_total";
+	case qc_num_icf_dedicated: return "qc_num_icf_dedicated";
+	case qc_num_icf_shared: return "qc_num_icf_shared";
+	case qc_ziip_absolute_capping: return "qc_ziip_absolute_capping";
+	case qc_icf_absolute_capping: return "qc_icf_absolute_capping";
+	case qc_ziip_weight_capping: return "qc_ziip_weight_capping";
+	case qc_icf_weight_capping: return "qc_icf_weight_capping";
+	case qc_ziip_weight: return "qc_ziip_weight";
+	case qc_icf_weight: return "qc_icf_weight";
+	case qc_polarization: return "qc_polarization";
+	case qc_polarization_num: return "qc_polarization_num";
+	case qc_drawer_id: return "qc_drawer_id";
+	case qc_book_id: return "qc_book_id";
+	case qc_socket_id: return "qc_socket_id";
+	case qc_core_id: return "qc_core_id";
+	case qc_num_cpu_horizontal: return "qc_num_cpu_horizontal";
+	case qc_num_cpu_vertical_low: return "qc_num_cpu_vertical_low";
+	case qc_num_cpu_vertical_medium: return "qc_num_cpu_vertical_medium";
+	case qc_num_cpu_vertical_high: return "qc_num_cpu_vertical_high";
+	case qc_num_drawers: return "qc_num_drawers";
+	case qc_num_core_per_drawer: return "qc_num_core_per_drawer";
+	case qc_cp_effective_capacity: return "qc_cp_effective_capacity";
+	case qc_ifl_effective_capacity: return "qc_ifl_effective_capacity";
+	case qc_cp_guaranteed_capacity: return "qc_cp_guaranteed_capacity";
+	case qc_ifl_guaranteed_capacity: return "qc_ifl_guaranteed_capacity";
+	case qc_cp_limiting_layer: return "qc_cp_limiting_layer";
+	case qc_ifl_limiting_layer: return "qc_ifl_limiting_layer";
+	case qc_cp_normalized_capacity: return "qc_cp_normalized_capacity";
+	case qc_ifl_normalized_capacity: return "qc_ifl_normalized_capacity";
+	case qc_normalized_capacity: return "qc_normalized_capacity";
+	case qc_cp_core_equivalent_capacity: return "qc_cp_core_equivalent_capacity";
+	case qc_ifl_core_equivalent_capacity: return "qc_ifl_core_equivalent_capacity";
+	case qc_cp_thread_equivalent_capacity: return "qc_cp_thread_equivalent_capacity";
+	case qc_ifl_thread_equivalent_capacity: return "qc_ifl_thread_equivalent_capacity";
+	case qc_mem_total: return "qc_mem_total";
+	case qc_mem_limit: return "qc_mem_limit";
+	case qc_mem_effective: return "qc_mem_effective";
+	case qc_mem_limiting_layer: return "qc_mem_limiting_layer";
 
 	default: break;
 	}
@@ -97,6 +180,19 @@ const char *attr2char(enum qc_attr_id id) {
 	return NULL;
 }
 
+const char *table2char(enum qc_table_id id) {
+	switch (id) {
+	case qc_table_cpus: return "qc_table_cpus";
+	case qc_table_lpars: return "qc_table_lpars";
+	case qc_table_zvm_guests: return "qc_table_zvm_guests";
+	case qc_table_kvm_guests: return "qc_table_kvm_guests";
+	case qc_table_topology: return "qc_table_topology";
+	default: break;
+	}
+
+	return NULL;
+}
+
 void verify_nonexistence(void *hdl, enum qc_attr_id id, int layer) {
 	const char *s;
 	float f;
@@ -303,6 +399,36 @@ int sanity_checks(void *hdl, int layers) {
 		err_cnt++;
 	}
 
+	rc = qc_compute_utilization(NULL, hdl);
+	if (rc >= 0) {
+		printf("Error: qc_compute_utilization(NULL, hdl) worked\n");
+		err_cnt++;
+	}
+	rc = qc_compute_utilization(hdl, hdl);
+	if (rc <= 0) {
+		printf("Error: qc_compute_utilization(hdl, hdl) returned %d\n", rc);
+		err_cnt++;
+	}
+	qc_get_num_rows(NULL, qc_table_cpus, 0, &rc);
+	if (rc >= 0) {
+		printf("Error: qc_get_num_rows(NULL, qc_table_cpus, 0, &rc) worked\n");
+		err_cnt++;
+	}
+	qc_get_num_rows(hdl, 78923, 0, &rc);
+	if (rc >= 0) {
+		printf("Error: qc_get_num_rows(hdl, 78923, 0, &rc) worked\n");
+		err_cnt++;
+	}
+	qc_get_row_by_name(hdl, qc_table_lpars, 0, NULL, &rc);
+	if (rc >= 0) {
+		printf("Error: qc_get_row_by_name(hdl, qc_table_lpars, 0, NULL, &rc) worked\n");
+		err_cnt++;
+	}
+	rc = qc_get_row_attribute_int(hdl, qc_table_cpus, qc_cpu_address, 1, -1, &i);
+	if (rc > 0 || i >= 0) {
+		printf("Error: qc_get_row_attribute_int(hdl, qc_table_cpus, qc_cpu_address, 1, -1, &i) worked\n");
+		err_cnt++;
+	}
 
 	return 0;
 }
@@ -406,6 +532,56 @@ void print_float_attr(void *hdl, enum qc_attr_id id, char *src, int layer, int i
 	}
 }
 
+void print_int64_attr(void *hdl, enum qc_attr_id id, char *src, int layer, int indent) {
+	int64_t val;
+	int rc, i;
+	float f;
+
+	rc = qc_get_attribute_int64(hdl, id, layer, &val);
+	switch (rc) {
+	case 1:	if (val < 0) {
+			printf("Error: Attribute '%s' is defined but not set!\n", attr2char(id));
+			err_cnt++;
+			return;
+		}
+		printf("%*s%*s [%3s]: %" PRId64 "\n", indent, "", attr_indent, attr2char(id), src, val);
+		break;
+	case 0:	if (val >= 0) {
+			printf("Error: Attribute '%s' is not defined but set to %" PRId64 "\n", attr2char(id), val);
+			err_cnt++;
+			return;
+		}
+		printf("%*s%*s [%3s]: <undefined>\n", indent, "", attr_indent, attr2char(id), src);
+		break;
+	default: printf("Error: Attribute '%s' retrieval as int64 returned %d\n", attr2char(id), rc);
+		err_cnt++;
+	}
+
+	// False positive tests
+	rc = qc_get_attribute_int(hdl, id, layer, &i);
+	if (rc != 0) {
+		printf("Error: Attribute '%s' definition check as int (is int64) returned rc=%d\n",
+			attr2char(id), rc);
+		err_cnt++;
+	}
+	if (i >= 0) {
+		printf("Error: Attribute '%s' retrieval as int (is int64) returned %d\n",
+			attr2char(id), i);
+		err_cnt++;
+	}
+	rc = qc_get_attribute_float(hdl, id, layer, &f);
+	if (rc != 0) {
+		printf("Error: Attribute '%s' definition check as float (is int64) returned rc=%d\n",
+			attr2char(id), rc);
+		err_cnt++;
+	}
+	if (f >= 0) {
+		printf("Error: Attribute '%s' retrieval as float (is int64) returned %f\n",
+			attr2char(id), f);
+		err_cnt++;
+	}
+}
+
 void print_string_attr(void *hdl, enum qc_attr_id id, char *src, int layer, int indent) {
 	const char *s;
 	float f;
@@ -456,6 +632,31 @@ void print_string_attr(void *hdl, enum qc_attr_id id, char *src, int layer, int
 	}
 }
 
+void print_capacity_information(void *hdl, int layer, int indent) {
+	print_break();
+	print_int_attr(hdl, qc_cp_effective_capacity, "   ", layer, indent);
+	print_int_attr(hdl, qc_cp_guaranteed_capacity, "   ", layer, indent);
+	print_int_attr(hdl, qc_cp_limiting_layer, "   ", layer, indent);
+	print_int_attr(hdl, qc_ifl_effective_capacity, "   ", layer, indent);
+	print_int_attr(hdl, qc_ifl_guaranteed_capacity, "   ", layer, indent);
+	print_int_attr(hdl, qc_ifl_limiting_layer, "   ", layer, indent);
+	print_float_attr(hdl, qc_cp_normalized_capacity, "   ", layer, indent);
+	print_float_attr(hdl, qc_ifl_normalized_capacity, "   ", layer, indent);
+	print_float_attr(hdl, qc_normalized_capacity, "   ", layer, indent);
+	print_float_attr(hdl, qc_cp_core_equivalent_capacity, "   ", layer, indent);
+	print_float_attr(hdl, qc_ifl_core_equivalent_capacity, "   ", layer, indent);
+	print_float_attr(hdl, qc_cp_thread_equivalent_capacity, "   ", layer, indent);
+	print_float_attr(hdl, qc_ifl_thread_equivalent_capacity, "   ", layer, indent);
+}
+
+void print_memory_information(void *hdl, int layer, int indent) {
+	print_break();
+	print_int64_attr(hdl, qc_mem_total, " m ", layer, indent);
+	print_int64_attr(hdl, qc_mem_limit, " m ", layer, indent);
+	print_int64_attr(hdl, qc_mem_effective, "   ", layer, indent);
+	print_int_attr(hdl, qc_mem_limiting_layer, "   ", layer, indent);
+}
+
 void print_cec_information(void *hdl, int layer, int indent) {
 	print_header(indent, layer, "CEC");
 	indent += 2;
@@ -489,6 +690,14 @@ void print_cec_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_num_ifl_dedicated, " hV", layer, indent);
 	print_int_attr(hdl, qc_num_ifl_shared, " hV", layer, indent);
 
+	print_break();
+	print_int_attr(hdl, qc_num_ziip_total, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_ziip_dedicated, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_ziip_shared, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_icf_total, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_icf_dedicated, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_icf_shared, " h ", layer, indent);
+
 	print_break();
 	print_int_attr(hdl, qc_num_cp_threads, "S  ", layer, indent);
 	print_int_attr(hdl, qc_num_ifl_threads, "S  ", layer, indent);
@@ -499,6 +708,14 @@ void print_cec_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_capacity_adjustment_indication, "S  ", layer, indent);
 	print_int_attr(hdl, qc_capacity_change_reason, "S  ", layer, indent);
 
+	print_break();
+	print_float_attr(hdl, qc_cp_utilization, " h ", layer, indent);
+	print_int_attr(hdl, qc_cp_consumption, " h ", layer, indent);
+	print_float_attr(hdl, qc_ifl_utilization, " h ", layer, indent);
+	print_int_attr(hdl, qc_ifl_consumption, " h ", layer, indent);
+
+	print_capacity_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_cp_absolute_capping, layer);
 }
@@ -514,6 +731,20 @@ void print_lpar_group_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_cp_absolute_capping, " hV", layer, indent);
 	print_int_attr(hdl, qc_ifl_absolute_capping, " hV", layer, indent);
 
+	print_break();
+	print_int_attr(hdl, qc_num_cp_total, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_cp_shared, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_ifl_total, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_ifl_shared, " h ", layer, indent);
+	print_int_attr(hdl, qc_cp_weight, " h ", layer, indent);
+	print_int_attr(hdl, qc_ifl_weight, " h ", layer, indent);
+	print_float_attr(hdl, qc_cp_utilization, " h ", layer, indent);
+	print_int_attr(hdl, qc_cp_consumption, " h ", layer, indent);
+	print_float_attr(hdl, qc_ifl_utilization, " h ", layer, indent);
+	print_int_attr(hdl, qc_ifl_consumption, " h ", layer, indent);
+
+	print_capacity_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_secondary_capability, layer);
 }
@@ -551,6 +782,14 @@ void print_lpar_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_num_ifl_dedicated, " hV", layer, indent);
 	print_int_attr(hdl, qc_num_ifl_shared, " hV", layer, indent);
 
+	print_break();
+	print_int_attr(hdl, qc_num_ziip_total, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_ziip_dedicated, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_ziip_shared, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_icf_total, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_icf_dedicated, " h ", layer, indent);
+	print_int_attr(hdl, qc_num_icf_shared, " h ", layer, indent);
+
 	print_break();
 	print_int_attr(hdl, qc_num_cp_threads, "S  ", layer, indent);
 	print_int_attr(hdl, qc_num_ifl_threads, "S  ", layer, indent);
@@ -558,6 +797,28 @@ void print_lpar_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_cp_weight_capping, " hV", layer, indent);
 	print_int_attr(hdl, qc_ifl_absolute_capping, " hV", layer, indent);
 	print_int_attr(hdl, qc_ifl_weight_capping, " hV", layer, indent);
+	print_int_attr(hdl, qc_ziip_absolute_capping, " h ", layer, indent);
+	print_int_attr(hdl, qc_ziip_weight_capping, " h ", layer, indent);
+	print_int_attr(hdl, qc_icf_absolute_capping, " h ", layer, indent);
+	print_int_attr(hdl, qc_icf_weight_capping, " h ", layer, indent);
+
+	print_break();
+	print_float_attr(hdl, qc_cp_utilization, " h ", layer, indent);
+	print_int_attr(hdl, qc_cp_consumption, " h ", layer, indent);
+	print_float_attr(hdl, qc_ifl_utilization, " h ", layer, indent);
+	print_int_attr(hdl, qc_ifl_consumption, " h ", layer, indent);
+	print_float_attr(hdl, qc_overcommit, " k ", layer, indent);
+
+	print_break();
+	print_int_attr(hdl, qc_num_cpu_horizontal, " t ", layer, indent);
+	print_int_attr(hdl, qc_num_cpu_vertical_low, " t ", layer, indent);
+	print_int_attr(hdl, qc_num_cpu_vertical_medium, " t ", layer, indent);
+	print_int_attr(hdl, qc_num_cpu_vertical_high, " t ", layer, indent);
+	print_int_attr(hdl, qc_num_drawers, " t ", layer, indent);
+	print_int_attr(hdl, qc_num_core_per_drawer, " t ", layer, indent);
+
+	print_capacity_information(hdl, layer, indent);
+	print_memory_information(hdl, layer, indent);
 
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_secondary_capability, layer);
@@ -590,6 +851,8 @@ void print_zvmhyp_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_num_cp_threads, "  V", layer, indent);
 	print_int_attr(hdl, qc_num_ifl_threads, "  V", layer, indent);
 
+	print_capacity_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_cp_absolute_capping, layer);
 }
@@ -615,6 +878,8 @@ void print_zvmpool_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_ifl_capacity_cap, "  V", layer, indent);
 	print_int_attr(hdl, qc_ifl_capped_capacity, "  V", layer, indent);
 
+	print_capacity_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_cp_absolute_capping, layer);
 }
@@ -658,6 +923,21 @@ void print_zvmguest_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_ifl_dispatch_limithard, "  V", layer, indent);
 	print_int_attr(hdl, qc_ifl_capped_capacity, "  V", layer, indent);
 
+	print_break();
+	print_int_attr(hdl, qc_cpu_consumption, " h ", layer, indent);
+	print_float_attr(hdl, qc_cpu_delay, " h ", layer, indent);
+	print_float_attr(hdl, qc_page_wait, " h ", layer, indent);
+	print_float_attr(hdl, qc_overcommit, " k ", layer, indent);
+
+	print_break();
+	print_int64_attr(hdl, qc_mem_min, " h ", layer, indent);
+	print_int64_attr(hdl, qc_mem_max, " h ", layer, indent);
+	print_int64_attr(hdl, qc_mem_share, " h ", layer, indent);
+	print_int64_attr(hdl, qc_mem_used, " h ", layer, indent);
+
+	print_capacity_information(hdl, layer, indent);
+	print_memory_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_cp_absolute_capping, layer);
 }
@@ -683,6 +963,9 @@ void print_kvmhyp_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_num_ifl_dedicated, "ShV", layer, indent);
 	print_int_attr(hdl, qc_num_ifl_shared, "ShV", layer, indent);
 
+	print_capacity_information(hdl, layer, indent);
+	print_memory_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_cp_absolute_capping, layer);
 }
@@ -710,10 +993,237 @@ void print_kvmguest_information(void *hdl, int layer, int indent) {
 	print_int_attr(hdl, qc_num_ifl_shared, "S  ", layer, indent);
 	print_int_attr(hdl, qc_ifl_dispatch_type, "SHV", layer, indent);
 
+	print_break();
+	print_float_attr(hdl, qc_utilization, "  p", layer, indent);
+	print_int_attr(hdl, qc_cpu_consumption, "  p", layer, indent);
+	print_float_attr(hdl, qc_steal, "  p", layer, indent);
+
+	print_capacity_information(hdl, layer, indent);
+	print_memory_information(hdl, layer, indent);
+
 	// check an attribute that only exists at a different layer
 	verify_nonexistence(hdl, qc_cp_absolute_capping, layer);
 }
 
+// Prints all tables of layer 'layer', one line per row
+void print_tables(void *hdl, int layer, int indent) {
+	int table, num, row, id, rc, i;
+	const char *s;
+	int64_t l;
+	float f;
+
+	for (table = 0; (num = qc_get_num_rows(hdl, table, layer, &rc)), rc != -2; ++table) {
+		if (rc < 0) {
+			printf("Error: Retrieving number of rows of table '%s' at layer %d returned %d\n",
+				table2char(table), layer, rc);
+			err_cnt++;
+			continue;
+		}
+		if (rc == 0)
+			continue;
+		print_break();
+		printf("%*s%*s: %d row(s)\n", indent, "", attr_indent, table2char(table), num);
+		for (row = 0; row < num; ++row) {
+			printf("%*s%*d:", indent, "", attr_indent, row);
+			// iterate over all attributes until we hit an invalid id
+			for (id = 0; (rc = qc_get_row_attribute_int(hdl, table, id, layer, row, &i)) != -2; ++id) {
+				if (rc > 0) {
+					printf(" %s=%d", attr2char(id) + 3, i);
+				} else if (qc_get_row_attribute_int64(hdl, table, id, layer, row, &l) > 0) {
+					printf(" %s=%" PRId64, attr2char(id) + 3, l);
+				} else if (qc_get_row_attribute_float(hdl, table, id, layer, row, &f) > 0) {
+					printf(" %s=%f", attr2char(id) + 3, f);
+				} else if ((rc = qc_get_row_attribute_string(hdl, table, id, layer, row, &s)) > 0) {
+					printf(" %s=%s", attr2char(id) + 3, s);
+				} else if (rc < 0) {
+					printf("\nError: Attribute '%s' retrieval in row %d of table '%s' returned %d\n",
+						attr2char(id), row, table2char(table), rc);
+					err_cnt++;
+				}
+			}
+			printf("\n");
+		}
+		rc = qc_get_row_attribute_int(hdl, table, 0, layer, num, &i);
+		if (rc >= 0) {
+			printf("Error: Retrieval of row %d of table '%s' with %d rows returned %d\n",
+				num, table2char(table), num, rc);
+			err_cnt++;
+		}
+	}
+}
+
+// Reads file 'fname' in dump 'dump' into a malloc'd buffer. Returns the buffer's size or -1.
+static ssize_t read_dump_file(const char *dump, const char *fname, char **buf) {
+	char path[PATH_MAX];
+	struct stat sbuf;
+	ssize_t len = -1;
+	FILE *f;
+
+	*buf = NULL;
+	snprintf(path, PATH_MAX, "%s/%s", dump, fname);
+	if (stat(path, &sbuf) || (f = fopen(path, "r")) == NULL)
+		return -1;
+	if ((*buf = malloc(sbuf.st_size + 1)) != NULL)
+		len = fread(*buf, 1, sbuf.st_size, f);
+	fclose(f);
+
+	return len;
+}
+
+// Verify that qc_open_from_buffers() on the dump's content results in identical attributes
+static void verify_buffers(void *hdl, int layers, const char *dump) {
+	struct { int type; const char *fname; } files[] = {
+		{QC_SOURCE_SYSINFO,		"sysinfo"},
+		{QC_SOURCE_OCF_CPC_NAME,	"ocf/cpc_name"},
+		{QC_SOURCE_HYPFS_DIAG_204,	"s390_hypfs/diag_204"},
+		{QC_SOURCE_HYPFS_DIAG_2FC,	"s390_hypfs/diag_2fc"},
+		{QC_SOURCE_STHYI,		"sthyi"},
+		{QC_SOURCE_PROC_STAT,		"proc_stat"},
+		{QC_SOURCE_KVM_GUESTS,		"kvm_guests"},
+		{QC_SOURCE_TOPOLOGY,		"topology"},
+		{QC_SOURCE_MEMORY,		"memory"},
+	};
+	int num = sizeof(files) / sizeof(files[0]), i, id, layer, rc, rc2, i1, i2, table, row, rows;
+	struct qc_source_buffer bufs[num];
+	const char *s1, *s2;
+	int64_t l1, l2;
+	void *bhdl;
+	ssize_t len;
+	char *buf;
+	float f1, f2;
+
+	for (i = 0; i < num; ++i) {
+		len = read_dump_file(dump, files[i].fname, &buf);
+		bufs[i].type = files[i].type;
+		bufs[i].data = len >= 0 ? buf : NULL;
+		bufs[i].len = len >= 0 ? len : 0;
+		if (len < 0)
+			free(buf);
+	}
+	bhdl = qc_open_from_buffers(bufs, num, &rc);
+	for (i = 0; i < num; ++i)
+		free((void *)bufs[i].data);
+	if (rc || !bhdl) {
+		printf("Error: qc_open_from_buffers() failed on dump '%s', rc=%d\n", dump, rc);
+		err_cnt++;
+		return;
+	}
+	if (qc_get_num_layers(bhdl, &rc) != layers) {
+		printf("Error: qc_open_from_buffers() returned a different number of layers\n");
+		err_cnt++;
+		goto out;
+	}
+	for (layer = 0; layer < layers; ++layer) {
+		// iterate over all attributes until we hit an invalid id
+		for (id = 0; (rc = qc_get_attribute_int(hdl, id, layer, &i1)) != -2; ++id) {
+			rc2 = qc_get_attribute_int(bhdl, id, layer, &i2);
+			if (rc != rc2 || (rc > 0 && i1 != i2))
+				goto mismatch;
+			rc = qc_get_attribute_int64(hdl, id, layer, &l1);
+			rc2 = qc_get_attribute_int64(bhdl, id, layer, &l2);
+			if (rc != rc2 || (rc > 0 && l1 != l2))
+				goto mismatch;
+			rc = qc_get_attribute_float(hdl, id, layer, &f1);
+			rc2 = qc_get_attribute_float(bhdl, id, layer, &f2);
+			if (rc != rc2 || (rc > 0 && f1 != f2))
+				goto mismatch;
+			rc = qc_get_attribute_string(hdl, id, layer, &s1);
+			rc2 = qc_get_attribute_string(bhdl, id, layer, &s2);
+			if (rc != rc2 || (rc > 0 && strcmp(s1, s2)))
+				goto mismatch;
+		}
+		for (table = 0; (rows = qc_get_num_rows(hdl, table, layer, &rc)), rc != -2; ++table) {
+			if (qc_get_num_rows(bhdl, table, layer, &rc2) != rows || rc != rc2)
+				goto table_mismatch;
+			for (row = 0; row < rows; ++row) {
+				for (id = 0; (rc = qc_get_row_attribute_int(hdl, table, id, layer, row, &i1)) != -2; ++id) {
+					rc2 = qc_get_row_attribute_int(bhdl, table, id, layer, row, &i2);
+					if (rc != rc2 || (rc > 0 && i1 != i2))
+						goto table_mismatch;
+					rc = qc_get_row_attribute_int64(hdl, table, id, layer, row, &l1);
+					rc2 = qc_get_row_attribute_int64(bhdl, table, id, layer, row, &l2);
+					if (rc != rc2 || (rc > 0 && l1 != l2))
+						goto table_mismatch;
+					rc = qc_get_row_attribute_float(hdl, table, id, layer, row, &f1);
+					rc2 = qc_get_row_attribute_float(bhdl, table, id, layer, row, &f2);
+					if (rc != rc2 || (rc > 0 && f1 != f2))
+						goto table_mismatch;
+					rc = qc_get_row_attribute_string(hdl, table, id, layer, row, &s1);
+					rc2 = qc_get_row_attribute_string(bhdl, table, id, layer, row, &s2);
+					if (rc != rc2 || (rc > 0 && strcmp(s1, s2)))
+						goto table_mismatch;
+				}
+			}
+		}
+	}
+	goto out;
+
+mismatch:
+	printf("Error: qc_open_from_buffers() result differs in attribute '%s' at layer %d\n",
+		attr2char(id), layer);
+	err_cnt++;
+	goto out;
+table_mismatch:
+	printf("Error: qc_open_from_buffers() result differs in table '%s' at layer %d\n",
+		table2char(table), layer);
+	err_cnt++;
+out:
+	qc_close(bhdl);
+}
+
+/* Verify that qc_open_from_buffers() rejects the dump's file 'fname' when either setting 'width' Bytes at
+   'offset' to 0xff, or when truncating it by 'trunc' Bytes while adjusting the diag header's length */
+static void verify_corrupt_buffer(const char *dump, int type, const char *fname, int offset, int width, int trunc) {
+	struct qc_source_buffer bufs[2];
+	char *sysinfo, *buf;
+	ssize_t len, slen;
+	uint64_t hlen;
+	void *bhdl;
+	int rc;
+
+	slen = read_dump_file(dump, "sysinfo", &sysinfo);
+	len = read_dump_file(dump, fname, &buf);
+	if (slen < 0 || len < offset + width || len <= trunc)
+		goto out;
+	if (trunc) {
+		len -= trunc;
+		// the diag header's length excludes the header itself, which is 64 Bytes
+		hlen = htobe64(len - 64);
+		memcpy(buf, &hlen, sizeof(hlen));
+	} else
+		memset(buf + offset, 0xff, width);
+	bufs[0].type = QC_SOURCE_SYSINFO;
+	bufs[0].data = sysinfo;
+	bufs[0].len = slen;
+	bufs[1].type = type;
+	bufs[1].data = buf;
+	bufs[1].len = len;
+	bhdl = qc_open_from_buffers(bufs, 2, &rc);
+	if (rc >= 0 || bhdl) {
+		printf("Error: qc_open_from_buffers() accepted corrupt '%s' (offset %d, truncated by %d), rc=%d\n",
+			fname, offset, trunc, rc);
+		err_cnt++;
+		qc_close(bhdl);
+	}
+
+out:
+	free(sysinfo);
+	free(buf);
+}
+
+// Verify that inconsistent offsets and counts in binary data are rejected instead of being walked
+static void verify_corrupt_buffers(const char *dump) {
+	// truncated by one CPU record, number of LPARs, CPUs of the first LPAR, and offset of our LPAR
+	verify_corrupt_buffer(dump, QC_SOURCE_HYPFS_DIAG_204, "s390_hypfs/diag_204", 0, 0, 96);
+	verify_corrupt_buffer(dump, QC_SOURCE_HYPFS_DIAG_204, "s390_hypfs/diag_204", 64, 1, 0);
+	verify_corrupt_buffer(dump, QC_SOURCE_HYPFS_DIAG_204, "s390_hypfs/diag_204", 130, 1, 0);
+	verify_corrupt_buffer(dump, QC_SOURCE_HYPFS_DIAG_204, "s390_hypfs/diag_204", 70, 2, 0);
+	// number of guests
+	verify_corrupt_buffer(dump, QC_SOURCE_HYPFS_DIAG_2FC, "s390_hypfs/diag_2fc", 26, 8, 0);
+	// offset of machine section
+	verify_corrupt_buffer(dump, QC_SOURCE_STHYI, "sthyi", 12, 2, 0);
+}
+
 int get_handle(void **hdl, int *layers, int quiet) {
 	int rc;
 
@@ -748,8 +1258,580 @@ int get_handle(void **hdl, int *layers, int quiet) {
 	return 0;
 }
 
-// Retrieve handle, dump data, and return *hdl to leave it at the caller's discretion when to close it
-static void *run_test(int quiet, int fulltest) {
+/* Expected utilization in percent for dump pair 'utilization-1' and 'utilization-2' in subdirectory 'dumps',
+   generated by 'qc_gen -l 3 -c 4 -i 2 -Z 1 -g 300 -K 2' with '-t 3600' and '-t 3660' respectively: Each
+   LPAR CPU runs at 1/6, the KVM guests at 1/2, and management time adds 1% per physical CPU */
+static const struct {
+	const char *dump;
+	int layer;
+	int table;	// -1 for attributes of the layer
+	int row;
+	enum qc_attr_id id;
+	float util;
+} expected_utilization[] = {
+	{"utilization-2", 0, -1, 0, qc_cp_utilization, 51.0},
+	{"utilization-2", 0, -1, 0, qc_ifl_utilization, 51.0},
+	{"utilization-2", 1, -1, 0, qc_cp_utilization, 11.111},
+	{"utilization-2", 1, -1, 0, qc_ifl_utilization, 11.111},
+	{"utilization-2", 2, -1, 0, qc_cp_utilization, 16.667},
+	{"utilization-2", 2, -1, 0, qc_ifl_utilization, 16.667},
+	{"utilization-2", 2, qc_table_cpus, 0, qc_utilization, 16.667},
+	{"utilization-2", 2, qc_table_cpus, 2, qc_utilization, 16.667},
+	{"utilization-2", 2, qc_table_kvm_guests, 1, qc_utilization, 50.0},
+};
+
+// Verify that utilization can be computed from the difference between 'hdl' and 'prev_hdl', and
+// matches the expected values if 'hdl' is one of the dumps listed in 'expected_utilization'
+static void verify_utilization(void *hdl, void *prev_hdl) {
+	const char *dump = getenv("QC_USE_DUMP"), *name;
+	char path[PATH_MAX], *s;
+	int rc, i, len;
+	float val;
+
+	rc = qc_compute_utilization(hdl, prev_hdl);
+	if (rc < 0) {
+		printf("Error: qc_compute_utilization() returned %d\n", rc);
+		err_cnt++;
+		return;
+	} else if (rc > 0) {
+		printf("No utilization data available, rc=%d\n\n", rc);
+		return;
+	}
+	if (!dump)
+		return;
+	snprintf(path, PATH_MAX, "%s", dump);
+	for (len = strlen(path); len > 1 && path[len - 1] == '/'; )
+		path[--len] = '\0';
+	name = (s = strrchr(path, '/')) != NULL ? s + 1 : path;
+	for (i = 0; i < (int)(sizeof(expected_utilization) / sizeof(expected_utilization[0])); i++) {
+		if (strcmp(name, expected_utilization[i].dump))
+			continue;
+		if (expected_utilization[i].table < 0)
+			rc = qc_get_attribute_float(hdl, expected_utilization[i].id, expected_utilization[i].layer, &val);
+		else
+			rc = qc_get_row_attribute_float(hdl, expected_utilization[i].table, expected_utilization[i].id,
+							expected_utilization[i].layer, expected_utilization[i].row, &val);
+		if (rc <= 0 || val < expected_utilization[i].util - 0.01 || val > expected_utilization[i].util + 0.01) {
+			printf("Error: '%s' of layer %d, table %d, row %d is %f (rc=%d), expected %f\n",
+			       attr2char(expected_utilization[i].id), expected_utilization[i].layer,
+			       expected_utilization[i].table, expected_utilization[i].row, rc > 0 ? val : -1, rc,
+			       expected_utilization[i].util);
+			err_cnt++;
+		}
+	}
+}
+
+// Verify that statistics of a configuration added twice match its consumption, that the headroom is
+// the remainder of the effective capacity, and that invalid parameters are rejected
+static void verify_statistics(void *hdl, int layers) {
+	struct qc_stats_config cfg = {0, 0.5, 1};
+	int types[] = {QC_CPU_TYPE_CP, QC_CPU_TYPE_IFL};
+	enum qc_attr_id ids[][2] = {{qc_cp_consumption, qc_cp_effective_capacity},
+				    {qc_ifl_consumption, qc_ifl_effective_capacity}};
+	int rc, updated, i, layer, stat, cons, eff, val, exp;
+	void *stats;
+
+	if (qc_stats_open(hdl, &cfg, &rc) != NULL || rc >= 0) {
+		printf("Error: qc_stats_open() with invalid settings did not fail\n");
+		err_cnt++;
+	}
+	cfg.window = 4;
+	if ((stats = qc_stats_open(hdl, &cfg, &rc)) == NULL || rc) {
+		printf("Error: qc_stats_open() failed, rc=%d\n", rc);
+		err_cnt++;
+		return;
+	}
+	if ((updated = qc_stats_update(stats, hdl)) < 0 || qc_stats_update(stats, hdl) != updated) {
+		printf("Error: qc_stats_update() failed, rc=%d\n", updated);
+		err_cnt++;
+		goto out;
+	}
+	for (layer = 0; layer < layers; layer++) {
+		for (i = 0; i < (int)(sizeof(types) / sizeof(types[0])); i++) {
+			if (qc_get_attribute_int(hdl, ids[i][0], layer, &cons) <= 0) {
+				if (qc_stats_get(stats, layer, types[i], QC_STAT_MEAN, &val) != 0) {
+					printf("Error: Statistics for layer %d without consumption\n", layer);
+					err_cnt++;
+				}
+				continue;
+			}
+			for (stat = QC_STAT_EWMA; stat <= QC_STAT_HEADROOM_FORECAST; stat++) {
+				exp = cons;
+				if (stat >= QC_STAT_HEADROOM) {
+					if (qc_get_attribute_int(hdl, ids[i][1], layer, &eff) <= 0)
+						continue;
+					exp = eff > cons ? eff - cons : 0;
+				}
+				if (qc_stats_get(stats, layer, types[i], stat, &val) <= 0 || val - exp > 1 || exp - val > 1) {
+					printf("Error: Statistic %d of layer %d is %d, expected %d\n", stat, layer, val, exp);
+					err_cnt++;
+				}
+			}
+		}
+	}
+	if (qc_stats_get(stats, layers, QC_CPU_TYPE_IFL, QC_STAT_MEAN, &val) >= 0 ||
+	    qc_stats_get(stats, 0, QC_CPU_TYPE_ZIIP, QC_STAT_MEAN, &val) >= 0) {
+		printf("Error: qc_stats_get() with invalid parameters did not fail\n");
+		err_cnt++;
+	}
+out:
+	qc_stats_close(stats);
+}
+
+static void count_threshold(const struct qc_threshold *thr, int active, float value, void *data) {
+	((int *)data)[active]++;
+}
+
+// Verify that a threshold on the effective capacity of the highest layer fires once when a simulated
+// configuration drops all IFLs, and is cleared once the original configuration is back
+static void verify_thresholds(void *hdl, int layers) {
+	struct qc_threshold thr = {layers - 1, qc_ifl_effective_capacity, -1, 0, 0, 0x100};
+	struct qc_change change = {0, -1, 0, qc_num_ifl_total, 0};
+	int rc, eff, fds[2] = {-1, -1}, cnt[2] = {0, 0};
+	void *stats, *sim = NULL;
+	uint64_t events = 0;
+
+	if (qc_get_attribute_int(hdl, qc_ifl_effective_capacity, layers - 1, &eff) <= 0 || eff < 0x200)
+		return;
+	thr.value = eff - 0x200;
+	if ((stats = qc_stats_open(hdl, NULL, &rc)) == NULL || pipe(fds) ||
+	    (sim = qc_simulate(hdl, &change, 1, &rc)) == NULL) {
+		printf("Error: Failed to set up threshold test, rc=%d\n", rc);
+		err_cnt++;
+		goto out;
+	}
+	if (qc_stats_add_threshold(stats, &thr, NULL, NULL, -1) >= 0 ||
+	    qc_stats_add_threshold(stats, &thr, count_threshold, cnt, fds[1]) != 0) {
+		printf("Error: qc_stats_add_threshold() failed\n");
+		err_cnt++;
+		goto out;
+	}
+	qc_stats_update(stats, hdl);
+	qc_stats_update(stats, sim);
+	qc_stats_update(stats, sim);
+	qc_stats_update(stats, hdl);
+	if (cnt[1] != 1 || cnt[0] != 1 || read(fds[0], &events, sizeof(events)) != sizeof(events) || events != 1) {
+		printf("Error: Threshold was met %d time(s), cleared %d time(s) with %d event(s)\n", cnt[1], cnt[0],
+		       (int)events);
+		err_cnt++;
+	}
+out:
+	if (fds[0] >= 0) {
+		close(fds[0]);
+		close(fds[1]);
+	}
+	qc_close(sim);
+	qc_stats_close(stats);
+}
+
+// Returns the row of 'table' at 'layer' named 'name' by searching all rows, or -1 if not found.
+// Verifies that qc_get_row_by_name() returns the same row.
+static int find_row(void *hdl, enum qc_table_id table, int layer, const char *name) {
+	int rc, rows, row, idx;
+	const char *row_name;
+
+	rows = qc_get_num_rows(hdl, table, layer, &rc);
+	for (row = 0; row < rows; row++)
+		if (qc_get_row_attribute_string(hdl, table, qc_layer_name, layer, row, &row_name) > 0 &&
+		    strcmp(name, row_name) == 0)
+			break;
+	if (row == rows)
+		row = -1;
+	idx = qc_get_row_by_name(hdl, table, layer, name, &rc);
+	if (idx != row || (rc > 0) != (row >= 0)) {
+		printf("Error: qc_get_row_by_name(hdl, %s, %d, \"%s\", &rc) returned %d with rc=%d, expected %d\n",
+			table2char(table), layer, name, idx, rc, row);
+		err_cnt++;
+	}
+
+	return row;
+}
+
+// Verify that our own LPAR and z/VM guest are listed in the tables of the respective hypervisor layers,
+// with the same counts as in the LPAR layer
+static void verify_named_rows(void *hdl, int layers) {
+	int rc, row, layer, type, i, val, row_val, lpar = -1, zvm_hyp = -1, zvm_guest = -1;
+	enum qc_attr_id ids[] = {qc_num_cp_total, qc_num_ifl_total};
+	const char *name;
+
+	for (layer = 1; layer < layers; layer++) {
+		if (qc_get_attribute_int(hdl, qc_layer_type_num, layer, &type) <= 0)
+			continue;
+		if (type == QC_LAYER_TYPE_LPAR)
+			lpar = layer;
+		else if (type == QC_LAYER_TYPE_ZVM_HYPERVISOR)
+			zvm_hyp = layer;
+		else if (type == QC_LAYER_TYPE_ZVM_GUEST && zvm_hyp > zvm_guest)
+			zvm_guest = layer;
+	}
+	if (zvm_guest > zvm_hyp && qc_get_num_rows(hdl, qc_table_zvm_guests, zvm_hyp, &rc) > 0 &&
+	    qc_get_attribute_string(hdl, qc_layer_name, zvm_guest, &name) > 0 &&
+	    find_row(hdl, qc_table_zvm_guests, zvm_hyp, name) < 0) {
+		printf("Error: z/VM guest '%s' not found in table 'qc_table_zvm_guests'\n", name);
+		err_cnt++;
+	}
+	if (lpar < 0 || qc_get_num_rows(hdl, qc_table_lpars, 0, &rc) <= 0 ||
+	    qc_get_attribute_string(hdl, qc_layer_name, lpar, &name) <= 0)
+		return;
+	if ((row = find_row(hdl, qc_table_lpars, 0, name)) < 0) {
+		printf("Error: LPAR '%s' not found in table 'qc_table_lpars'\n", name);
+		err_cnt++;
+		return;
+	}
+	if (find_row(hdl, qc_table_lpars, 0, "NOSUCHLP") >= 0) {
+		printf("Error: Found non-existing LPAR in table 'qc_table_lpars'\n");
+		err_cnt++;
+	}
+	for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); i++) {
+		if (qc_get_attribute_int(hdl, ids[i], lpar, &val) <= 0 ||
+		    qc_get_row_attribute_int(hdl, qc_table_lpars, ids[i], 0, row, &row_val) <= 0)
+			continue;
+		if (val != row_val) {
+			printf("Error: '%s' mismatch between LPAR layer (%d) and table 'qc_table_lpars' (%d)\n",
+				attr2char(ids[i]), val, row_val);
+			err_cnt++;
+		}
+	}
+}
+
+// Verify that all KVM guests of the highest layer can be looked up by name, and that their
+// overcommit ratios add up to the one of the layer
+static void verify_kvm_guests(void *hdl, int layers) {
+	int rc, row, rows, layer = layers - 1;
+	float overcommit, sum = 0, f;
+	const char *name;
+
+	rows = qc_get_num_rows(hdl, qc_table_kvm_guests, layer, &rc);
+	for (row = 0; row < rows; row++) {
+		if (qc_get_row_attribute_string(hdl, qc_table_kvm_guests, qc_layer_name, layer, row, &name) <= 0 ||
+		    find_row(hdl, qc_table_kvm_guests, layer, name) != row) {
+			printf("Error: KVM guest in row %d not found in table 'qc_table_kvm_guests'\n", row);
+			err_cnt++;
+		}
+		if (qc_get_row_attribute_float(hdl, qc_table_kvm_guests, qc_overcommit, layer, row, &f) > 0)
+			sum += f;
+	}
+	if (rows > 0 && qc_get_attribute_float(hdl, qc_overcommit, layer, &overcommit) > 0 &&
+	    (sum - overcommit > 0.01 * rows || overcommit - sum > 0.01 * rows)) {
+		printf("Error: 'qc_overcommit' of KVM guests add up to %f, but layer reports %f\n", sum, overcommit);
+		err_cnt++;
+	}
+}
+
+// Verify that the CPU type names in all tables 'qc_table_cpus' match the respective CPU type numbers
+static void verify_cpu_types(void *hdl, int layers) {
+	const char *names[] = {"CP", NULL, "zAAP", "IFL", "ICF", "zIIP"};
+	int rc, layer, row, rows, num;
+	const char *type;
+
+	for (layer = 0; layer < layers; layer++) {
+		rows = qc_get_num_rows(hdl, qc_table_cpus, layer, &rc);
+		for (row = 0; row < rows; row++) {
+			if (qc_get_row_attribute_string(hdl, qc_table_cpus, qc_cpu_type, layer, row, &type) <= 0 ||
+			    qc_get_row_attribute_int(hdl, qc_table_cpus, qc_cpu_type_num, layer, row, &num) <= 0)
+				continue;
+			if (num < 0 || num >= (int)(sizeof(names) / sizeof(names[0])) || !names[num] ||
+			    strcmp(type, names[num])) {
+				printf("Error: CPU type '%s' does not match CPU type number %d in layer %d, row %d\n",
+				       type, num, layer, row);
+				err_cnt++;
+			}
+		}
+	}
+}
+
+// Verify that the polarization counts of the LPAR layer add up to the rows of its topology table
+static void verify_topology(void *hdl, int layers) {
+	enum qc_attr_id ids[] = {qc_num_cpu_horizontal, qc_num_cpu_vertical_low, qc_num_cpu_vertical_medium,
+				 qc_num_cpu_vertical_high};
+	int rc, rows, i, val, sum = 0, layer = layers - 1;
+
+	rows = qc_get_num_rows(hdl, qc_table_topology, layer, &rc);
+	if (rows <= 0)
+		return;
+	for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); i++) {
+		if (qc_get_attribute_int(hdl, ids[i], layer, &val) > 0)
+			sum += val;
+	}
+	if (sum > rows) {
+		printf("Error: Polarization counts add up to %d, but 'qc_table_topology' has %d row(s)\n", sum, rows);
+		err_cnt++;
+	}
+}
+
+// Verify that the effective capacity does not increase from one layer to the next, that the
+// guaranteed capacity does not exceed it, that the limiting layer is a layer below, that the
+// normalized capacities add up, and that the SMT equivalents are consistent
+static void verify_capacity(void *hdl, int layers) {
+	enum qc_attr_id ids[][5] = {{qc_cp_effective_capacity, qc_cp_guaranteed_capacity, qc_cp_limiting_layer,
+				     qc_cp_core_equivalent_capacity, qc_cp_thread_equivalent_capacity},
+				    {qc_ifl_effective_capacity, qc_ifl_guaranteed_capacity, qc_ifl_limiting_layer,
+				     qc_ifl_core_equivalent_capacity, qc_ifl_thread_equivalent_capacity}};
+	int i, layer, eff, prev_eff, guar, limiting;
+	float norm, cp_norm, ifl_norm, cores, threads, smt;
+
+	for (layer = 0; layer < layers; layer++) {
+		if (qc_get_attribute_float(hdl, qc_normalized_capacity, layer, &norm) <= 0)
+			continue;
+		if (qc_get_attribute_float(hdl, qc_cp_normalized_capacity, layer, &cp_norm) <= 0)
+			cp_norm = 0;
+		if (qc_get_attribute_float(hdl, qc_ifl_normalized_capacity, layer, &ifl_norm) <= 0)
+			ifl_norm = 0;
+		if (norm - cp_norm - ifl_norm > 0.001 || cp_norm + ifl_norm - norm > 0.001) {
+			printf("Error: '%s' in layer %d does not add up: %f != %f + %f\n", attr2char(qc_normalized_capacity),
+			       layer, norm, cp_norm, ifl_norm);
+			err_cnt++;
+		}
+	}
+
+	for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); i++) {
+		prev_eff = -1;
+		for (layer = 0; layer < layers; layer++) {
+			if (qc_get_attribute_int(hdl, ids[i][0], layer, &eff) <= 0)
+				continue;
+			if (prev_eff >= 0 && eff > prev_eff) {
+				printf("Error: '%s' in layer %d exceeds the layer below: %d > %d\n", attr2char(ids[i][0]),
+				       layer, eff, prev_eff);
+				err_cnt++;
+			}
+			if (qc_get_attribute_int(hdl, ids[i][1], layer, &guar) > 0 && guar > eff) {
+				printf("Error: '%s' in layer %d exceeds '%s': %d > %d\n", attr2char(ids[i][1]), layer,
+				       attr2char(ids[i][0]), guar, eff);
+				err_cnt++;
+			}
+			if (qc_get_attribute_int(hdl, ids[i][2], layer, &limiting) <= 0 || limiting > layer) {
+				printf("Error: '%s' in layer %d is invalid\n", attr2char(ids[i][2]), layer);
+				err_cnt++;
+			}
+			if (qc_get_attribute_float(hdl, ids[i][3], layer, &cores) <= 0 ||
+			    qc_get_attribute_float(hdl, ids[i][4], layer, &threads) <= 0) {
+				printf("Error: '%s' or '%s' in layer %d not set\n", attr2char(ids[i][3]), attr2char(ids[i][4]),
+				       layer);
+				err_cnt++;
+			} else if (eff > 0) {
+				// thread equivalents are a multiple of the effective capacity, and SMT never reduces capacity
+				smt = threads * 0x10000 / eff;
+				if (smt < 0.999 || smt - (int)(smt + 0.5) > 0.001 || (int)(smt + 0.5) - smt > 0.001 ||
+				    cores * 0x10000 < eff * 0.999) {
+					printf("Error: '%s' or '%s' in layer %d inconsistent with '%s': %f, %f, %d\n",
+					       attr2char(ids[i][3]), attr2char(ids[i][4]), layer, attr2char(ids[i][0]), cores,
+					       threads, eff);
+					err_cnt++;
+				}
+			}
+			prev_eff = eff;
+		}
+	}
+}
+
+// Print the recommended parallelism for all CPU types and policies, and verify that it is within range
+static void verify_parallelism(void *hdl, int layers) {
+	int types[] = {QC_CPU_TYPE_CP, QC_CPU_TYPE_IFL}, i, policy, num, rc, visible;
+
+	for (i = 0; i < (int)(sizeof(types) / sizeof(types[0])); i++) {
+		for (policy = QC_PARALLELISM_THROUGHPUT; policy <= QC_PARALLELISM_CONSERVATIVE; policy++) {
+			num = qc_recommend_parallelism(hdl, types[i], policy, &rc);
+			if (rc < 0 || (rc > 0 && num != 0)) {
+				printf("Error: qc_recommend_parallelism() for type %d and policy %d returned %d, rc=%d\n",
+				       types[i], policy, num, rc);
+				err_cnt++;
+				continue;
+			}
+			if (rc > 0)
+				continue;
+			printf("Recommended parallelism for %s with policy %d: %d\n", types[i] == QC_CPU_TYPE_CP ? "CPs" : "IFLs",
+			       policy, num);
+			if (qc_get_attribute_int(hdl, types[i] == QC_CPU_TYPE_CP ? qc_num_cp_total : qc_num_ifl_total,
+						 layers - 1, &visible) > 0 && (num < 1 || num > visible * 2)) {
+				printf("Error: Recommended parallelism %d is out of range\n", num);
+				err_cnt++;
+			}
+		}
+	}
+	if (qc_recommend_parallelism(hdl, QC_CPU_TYPE_ZIIP, QC_PARALLELISM_THROUGHPUT, &rc) != 0 || rc >= 0) {
+		printf("Error: qc_recommend_parallelism() for zIIPs did not fail\n");
+		err_cnt++;
+	}
+}
+
+// Verify that a simulation without changes yields the same capacity, that capping the LPAR at one IFL limits
+// all layers above while leaving the original configuration untouched, and that invalid changes are rejected
+static void verify_simulation(void *hdl, int layers) {
+	struct qc_change change = {-1, -1, 0, qc_ifl_absolute_capping, 0x10000};
+	int rc, layer, type, eff, sim_eff, cap, cap_rc, lpar = -1;
+	void *sim;
+
+	if ((sim = qc_simulate(hdl, NULL, 0, &rc)) == NULL || rc) {
+		printf("Error: qc_simulate() without changes failed, rc=%d\n", rc);
+		err_cnt++;
+		return;
+	}
+	for (layer = 0; layer < layers; layer++) {
+		if (qc_get_attribute_int(hdl, qc_ifl_effective_capacity, layer, &eff) > 0 &&
+		    (qc_get_attribute_int(sim, qc_ifl_effective_capacity, layer, &sim_eff) <= 0 || eff != sim_eff)) {
+			printf("Error: Simulation without changes differs in layer %d\n", layer);
+			err_cnt++;
+		}
+		if (qc_get_attribute_int(hdl, qc_layer_type_num, layer, &type) > 0 && type == QC_LAYER_TYPE_LPAR)
+			lpar = layer;
+	}
+	qc_close(sim);
+	if (lpar < 0)
+		return;
+	change.layer = lpar;
+	cap_rc = qc_get_attribute_int(hdl, qc_ifl_absolute_capping, lpar, &cap);
+	if ((sim = qc_simulate(hdl, &change, 1, &rc)) == NULL || rc) {
+		printf("Error: qc_simulate() failed to cap LPAR, rc=%d\n", rc);
+		err_cnt++;
+		return;
+	}
+	for (layer = lpar; layer < layers; layer++) {
+		if (qc_get_attribute_int(sim, qc_ifl_effective_capacity, layer, &sim_eff) > 0 && sim_eff > 0x10000) {
+			printf("Error: Simulated '%s' in layer %d exceeds capping: %d\n",
+				attr2char(qc_ifl_effective_capacity), layer, sim_eff);
+			err_cnt++;
+		}
+	}
+	qc_close(sim);
+	if (qc_get_attribute_int(hdl, qc_ifl_absolute_capping, lpar, &eff) != cap_rc || (cap_rc > 0 && eff != cap)) {
+		printf("Error: Simulation modified the original configuration\n");
+		err_cnt++;
+	}
+	change.id = qc_layer_name;
+	if ((sim = qc_simulate(hdl, &change, 1, &rc)) != NULL || rc >= 0) {
+		printf("Error: qc_simulate() with invalid change did not fail\n");
+		err_cnt++;
+		qc_close(sim);
+	}
+}
+
+// Verify that the members of our LPAR group include our own LPAR, are listed in the CEC layer's
+// table with the same group name, and that their cores add up to the group's counts
+static void verify_lpar_group(void *hdl, int layers) {
+	int rc, row, rows, layer, type, val, sum = 0, lpar = -1, group = -1;
+	const char *name, *grp, *lpar_name;
+
+	for (layer = 1; layer < layers; layer++) {
+		if (qc_get_attribute_int(hdl, qc_layer_type_num, layer, &type) <= 0)
+			continue;
+		if (type == QC_LAYER_TYPE_LPAR_GROUP)
+			group = layer;
+		else if (type == QC_LAYER_TYPE_LPAR)
+			lpar = layer;
+	}
+	if (group < 0 || lpar < 0 || (rows = qc_get_num_rows(hdl, qc_table_lpars, group, &rc)) <= 0 ||
+	    qc_get_attribute_string(hdl, qc_layer_name, group, &grp) <= 0)
+		return;
+	if (qc_get_attribute_string(hdl, qc_layer_name, lpar, &lpar_name) > 0 &&
+	    find_row(hdl, qc_table_lpars, group, lpar_name) < 0) {
+		printf("Error: LPAR '%s' not found among the members of LPAR group '%s'\n", lpar_name, grp);
+		err_cnt++;
+	}
+	for (row = 0; row < rows; row++) {
+		if (qc_get_row_attribute_string(hdl, qc_table_lpars, qc_layer_name, group, row, &name) <= 0 ||
+		    (rc = find_row(hdl, qc_table_lpars, 0, name)) < 0 ||
+		    qc_get_row_attribute_string(hdl, qc_table_lpars, qc_lpar_group_name, 0, rc, &name) <= 0 ||
+		    strcmp(name, grp)) {
+			printf("Error: Member in row %d of LPAR group '%s' not found in CEC layer\n", row, grp);
+			err_cnt++;
+		}
+		if (qc_get_row_attribute_int(hdl, qc_table_lpars, qc_num_cp_total, group, row, &val) > 0)
+			sum += val;
+	}
+	if (qc_get_attribute_int(hdl, qc_num_cp_total, group, &val) > 0 && val != sum) {
+		printf("Error: 'qc_num_cp_total' of LPAR group members add up to %d, but layer reports %d\n", sum, val);
+		err_cnt++;
+	}
+}
+
+// Verify that the entitlements of all LPARs on the CEC do not exceed the CEC's cores
+static void verify_entitlement(void *hdl, int layers) {
+	enum qc_attr_id ids[][2] = {{qc_num_cp_total, qc_cp_guaranteed_capacity},
+				    {qc_num_ifl_total, qc_ifl_guaranteed_capacity}};
+	int rc, row, rows, i, val, total;
+	long sum;
+
+	rows = qc_get_num_rows(hdl, qc_table_lpars, 0, &rc);
+	for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); i++) {
+		if (rows <= 0 || qc_get_attribute_int(hdl, ids[i][0], 0, &total) <= 0)
+			continue;
+		for (row = 0, sum = 0; row < rows; row++) {
+			if (qc_get_row_attribute_int(hdl, qc_table_lpars, ids[i][1], 0, row, &val) > 0)
+				sum += val;
+		}
+		if (sum > (long)total * 0x10000) {
+			printf("Error: '%s' of all LPARs add up to %ld, exceeding the CEC's %d core(s)\n",
+				attr2char(ids[i][1]), sum, total);
+			err_cnt++;
+		}
+	}
+}
+
+// Verify that the guaranteed capacity of all z/VM guests does not exceed the shared cores of their hypervisor
+static void verify_zvm_entitlement(void *hdl, int layers) {
+	enum qc_attr_id ids[][2] = {{qc_num_cp_shared, qc_cp_guaranteed_capacity},
+				    {qc_num_ifl_shared, qc_ifl_guaranteed_capacity}};
+	int rc, row, rows, i, val, shared, layer;
+	long sum;
+
+	for (layer = 0; layer < layers; layer++) {
+		if ((rows = qc_get_num_rows(hdl, qc_table_zvm_guests, layer, &rc)) <= 0)
+			continue;
+		for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); i++) {
+			if (qc_get_attribute_int(hdl, ids[i][0], layer, &shared) <= 0)
+				continue;
+			for (row = 0, sum = 0; row < rows; row++) {
+				if (qc_get_row_attribute_int(hdl, qc_table_zvm_guests, ids[i][1], layer, row, &val) > 0)
+					sum += val;
+			}
+			// allow for rounding per guest
+			if (sum > (long)shared * 0x10000 + rows) {
+				printf("Error: '%s' of all z/VM guests add up to %ld, exceeding the hypervisor's %d shared core(s)\n",
+					attr2char(ids[i][1]), sum, shared);
+				err_cnt++;
+			}
+		}
+	}
+}
+
+// Verify that the effective memory does not exceed any memory size or limit of its own and the lower layers
+static void verify_memory(void *hdl, int layers) {
+	enum qc_attr_id ids[] = {qc_mem_total, qc_mem_limit, qc_mem_max};
+	int64_t eff, prev = -1, val;
+	int layer, i, limiting;
+
+	for (layer = 0; layer < layers; layer++) {
+		for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); i++) {
+			if (qc_get_attribute_int64(hdl, ids[i], layer, &val) <= 0)
+				continue;
+			if (qc_get_attribute_int64(hdl, qc_mem_effective, layer, &eff) <= 0) {
+				printf("Error: '%s' set at layer %d, but 'qc_mem_effective' is not\n", attr2char(ids[i]), layer);
+				err_cnt++;
+			} else if (val > 0 && eff > val) {
+				printf("Error: Effective memory of %" PRId64 " KB at layer %d exceeds '%s' of %" PRId64 " KB\n",
+					eff, layer, attr2char(ids[i]), val);
+				err_cnt++;
+			}
+		}
+		if (qc_get_attribute_int64(hdl, qc_mem_effective, layer, &eff) <= 0)
+			continue;
+		if (prev >= 0 && eff > prev) {
+			printf("Error: Effective memory of %" PRId64 " KB at layer %d exceeds %" PRId64 " KB of a lower layer\n",
+				eff, layer, prev);
+			err_cnt++;
+		}
+		if (qc_get_attribute_int(hdl, qc_mem_limiting_layer, layer, &limiting) <= 0 ||
+		    limiting < 0 || limiting > layer) {
+			printf("Error: Effective memory at layer %d has an invalid limiting layer\n", layer);
+			err_cnt++;
+		}
+		prev = eff;
+	}
+}
+
+// Retrieve handle, dump data, and return *hdl to leave it at the caller's discretion when to close it.
+// If set, 'prev_hdl' is used to compute utilization values.
+static void *run_test(int quiet, int fulltest, void *prev_hdl) {
 	int indent = 0, layers, i, etype;
 	void *hdl = NULL, *hdl2 = NULL;
 
@@ -775,6 +1857,25 @@ static void *run_test(int quiet, int fulltest) {
 
 	if (sanity_checks(hdl, layers))
 		goto out;
+	if (getenv("QC_USE_DUMP")) {
+		verify_buffers(hdl, layers, getenv("QC_USE_DUMP"));
+		verify_corrupt_buffers(getenv("QC_USE_DUMP"));
+	}
+	verify_named_rows(hdl, layers);
+	verify_kvm_guests(hdl, layers);
+	verify_lpar_group(hdl, layers);
+	verify_entitlement(hdl, layers);
+	verify_zvm_entitlement(hdl, layers);
+	verify_cpu_types(hdl, layers);
+	verify_topology(hdl, layers);
+	verify_capacity(hdl, layers);
+	verify_memory(hdl, layers);
+	verify_parallelism(hdl, layers);
+	verify_simulation(hdl, layers);
+	if (prev_hdl)
+		verify_utilization(hdl, prev_hdl);
+	verify_statistics(hdl, layers);
+	verify_thresholds(hdl, layers);
 
 	for (i = 0; i < layers; i++) {
 		if (i > 0)
@@ -815,11 +1916,14 @@ static void *run_test(int quiet, int fulltest) {
 				"information available.\n\n", etype, i);
 			err_cnt++;
 		}
+		print_tables(hdl, i, indent + 2);
 	}
 	if (fulltest) {
 		// finally, get another handle before closing the existing one
 		if (get_handle(&hdl2, &layers, quiet) != 0)
 			err_cnt++;
+		else
+			verify_utilization(hdl2, hdl);
 	}
 
 out:
@@ -849,6 +1953,8 @@ static void print_help() {
 	printf("\n");
 	printf("Print live system information and perform self-test. Specify dumps to display\n");
 	printf("previously dumped data instead (but skipping a minor part of the self-test).\n");
+	printf("Utilization values are computed from the difference to the respective previous\n");
+	printf("dump.\n");
 	printf("\n");
 	printf("  -h, --help       Print usage information and exit\n");
 	printf("  -q, --quiet      Quiet mode: Only gather system informtion; skip self-test and\n");
@@ -883,13 +1989,13 @@ int main(int argc, char **argv) {
 		// dump(s) specified on command line - dump all, and close handles later on
 		for (j = 0, i = optind; i < argc; ++i, ++j) {
 			setenv("QC_USE_DUMP", argv[i], 1);
-			if ((hdls[j] = run_test(quiet, 0)) == NULL)
+			if ((hdls[j] = run_test(quiet, 0, j > 0 ? hdls[j - 1] : NULL)) == NULL)
 				rc++;
 		}
 		for (--j; j >= 0; --j)
 			qc_close(hdls[j]);
 	} else {
-		if ((hdls[0] = run_test(quiet, 1)) == NULL)
+		if ((hdls[0] = run_test(quiet, 1, NULL)) == NULL)
 			rc = 1;
 		qc_close(hdls[0]);
 	}
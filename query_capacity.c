@@ -4,7 +4,10 @@
 #define _GNU_SOURCE
 
 #include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 
 #include "query_capacity_int.h"
 #include "query_capacity_data.h"
@@ -13,13 +16,87 @@
 long  qc_dbg_level;
 FILE *qc_dbg_file;
 char *qc_dbg_dump_dir;
-int   qc_dbg_indent;
+__thread int qc_dbg_indent;
 char *qc_dbg_use_dump;
 int   qc_consistency_check_requested;
+FILE *qc_trace_file;
 static char	    *qc_dbg_file_name;
 static long	     qc_dbg_autodump;
 static unsigned int  qc_dbg_dump_idx;
-static iconv_t	     qc_cd = (iconv_t)-1;
+static float	     qc_smt_yield = QC_SMT_YIELD;
+static pthread_once_t qc_smt_yield_once = PTHREAD_ONCE_INIT;
+
+// Conversion table from IBM-1047 (EBCDIC) to ISO8859-1
+static const unsigned char qc_ebcdic_table[256] = {
+	0x00, 0x01, 0x02, 0x03, 0x9c, 0x09, 0x86, 0x7f,
+	0x97, 0x8d, 0x8e, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x9d, 0x85, 0x08, 0x87,
+	0x18, 0x19, 0x92, 0x8f, 0x1c, 0x1d, 0x1e, 0x1f,
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x0a, 0x17, 0x1b,
+	0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x05, 0x06, 0x07,
+	0x90, 0x91, 0x16, 0x93, 0x94, 0x95, 0x96, 0x04,
+	0x98, 0x99, 0x9a, 0x9b, 0x14, 0x15, 0x9e, 0x1a,
+	0x20, 0xa0, 0xe2, 0xe4, 0xe0, 0xe1, 0xe3, 0xe5,
+	0xe7, 0xf1, 0xa2, 0x2e, 0x3c, 0x28, 0x2b, 0x7c,
+	0x26, 0xe9, 0xea, 0xeb, 0xe8, 0xed, 0xee, 0xef,
+	0xec, 0xdf, 0x21, 0x24, 0x2a, 0x29, 0x3b, 0x5e,
+	0x2d, 0x2f, 0xc2, 0xc4, 0xc0, 0xc1, 0xc3, 0xc5,
+	0xc7, 0xd1, 0xa6, 0x2c, 0x25, 0x5f, 0x3e, 0x3f,
+	0xf8, 0xc9, 0xca, 0xcb, 0xc8, 0xcd, 0xce, 0xcf,
+	0xcc, 0x60, 0x3a, 0x23, 0x40, 0x27, 0x3d, 0x22,
+	0xd8, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+	0x68, 0x69, 0xab, 0xbb, 0xf0, 0xfd, 0xfe, 0xb1,
+	0xb0, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70,
+	0x71, 0x72, 0xaa, 0xba, 0xe6, 0xb8, 0xc6, 0xa4,
+	0xb5, 0x7e, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
+	0x79, 0x7a, 0xa1, 0xbf, 0xd0, 0x5b, 0xde, 0xae,
+	0xac, 0xa3, 0xa5, 0xb7, 0xa9, 0xa7, 0xb6, 0xbc,
+	0xbd, 0xbe, 0xdd, 0xa8, 0xaf, 0x5d, 0xb4, 0xd7,
+	0x7b, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+	0x48, 0x49, 0xad, 0xf4, 0xf6, 0xf2, 0xf3, 0xf5,
+	0x7d, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50,
+	0x51, 0x52, 0xb9, 0xfb, 0xfc, 0xf9, 0xfa, 0xff,
+	0x5c, 0xf7, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+	0x59, 0x5a, 0xb2, 0xd4, 0xd6, 0xd2, 0xd3, 0xd5,
+	0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+	0x38, 0x39, 0xb3, 0xdb, 0xdc, 0xd9, 0xda, 0x9f,
+};
+
+// Conversion table from ISO8859-1 to IBM-1047 (EBCDIC), the inverse of qc_ebcdic_table
+static const unsigned char qc_ascii_table[256] = {
+	0x00, 0x01, 0x02, 0x03, 0x37, 0x2d, 0x2e, 0x2f,
+	0x16, 0x05, 0x25, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x3c, 0x3d, 0x32, 0x26,
+	0x18, 0x19, 0x3f, 0x27, 0x1c, 0x1d, 0x1e, 0x1f,
+	0x40, 0x5a, 0x7f, 0x7b, 0x5b, 0x6c, 0x50, 0x7d,
+	0x4d, 0x5d, 0x5c, 0x4e, 0x6b, 0x60, 0x4b, 0x61,
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xf8, 0xf9, 0x7a, 0x5e, 0x4c, 0x7e, 0x6e, 0x6f,
+	0x7c, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+	0xc8, 0xc9, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6,
+	0xd7, 0xd8, 0xd9, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6,
+	0xe7, 0xe8, 0xe9, 0xad, 0xe0, 0xbd, 0x5f, 0x6d,
+	0x79, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+	0x88, 0x89, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96,
+	0x97, 0x98, 0x99, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+	0xa7, 0xa8, 0xa9, 0xc0, 0x4f, 0xd0, 0xa1, 0x07,
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x15, 0x06, 0x17,
+	0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x09, 0x0a, 0x1b,
+	0x30, 0x31, 0x1a, 0x33, 0x34, 0x35, 0x36, 0x08,
+	0x38, 0x39, 0x3a, 0x3b, 0x04, 0x14, 0x3e, 0xff,
+	0x41, 0xaa, 0x4a, 0xb1, 0x9f, 0xb2, 0x6a, 0xb5,
+	0xbb, 0xb4, 0x9a, 0x8a, 0xb0, 0xca, 0xaf, 0xbc,
+	0x90, 0x8f, 0xea, 0xfa, 0xbe, 0xa0, 0xb6, 0xb3,
+	0x9d, 0xda, 0x9b, 0x8b, 0xb7, 0xb8, 0xb9, 0xab,
+	0x64, 0x65, 0x62, 0x66, 0x63, 0x67, 0x9e, 0x68,
+	0x74, 0x71, 0x72, 0x73, 0x78, 0x75, 0x76, 0x77,
+	0xac, 0x69, 0xed, 0xee, 0xeb, 0xef, 0xec, 0xbf,
+	0x80, 0xfd, 0xfe, 0xfb, 0xfc, 0xba, 0xae, 0x59,
+	0x44, 0x45, 0x42, 0x46, 0x43, 0x47, 0x9c, 0x48,
+	0x54, 0x51, 0x52, 0x53, 0x58, 0x55, 0x56, 0x57,
+	0x8c, 0x49, 0xcd, 0xce, 0xcb, 0xcf, 0xcc, 0xe1,
+	0x70, 0xdd, 0xde, 0xdb, 0xdc, 0x8d, 0x8e, 0xdf,
+};
 
 struct qc_reg_hdl {
 	struct qc_handle	*hdl;
@@ -27,10 +104,14 @@ struct qc_reg_hdl {
 };
 
 static struct qc_reg_hdl *qc_hdls = NULL;
+// sysinfo needs to be handled first, or our LGM check later on will have loopholes
+static struct qc_data_src *qc_sources[] = {&sysinfo, &ocf, &hypfs, &sthyi, &topology, &procstat, &kvmhost, &meminfo, NULL};
+static pthread_mutex_t qc_hdls_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void qc_trace_close(void);
 
 static void __attribute__((destructor)) qc_destructor() {
-	if (qc_cd != (iconv_t)-1)
-		iconv_close(qc_cd);
+	qc_trace_close();
 }
 
 struct qc_handle *qc_get_cec_handle(struct qc_handle *hdl) {
@@ -232,6 +313,46 @@ out_err:
 	return rc;
 }
 
+/* Opens the trace file if env var QC_TRACE is set. Like the log file, the trace file remains
+   open across calls, so that a single timeline covers all invocations of the library. */
+static void qc_trace_init(void) {
+	char *s = getenv("QC_TRACE");
+
+	if (!s || qc_trace_file)
+		return;
+	qc_trace_file = fopen(s, "w");
+	if (!qc_trace_file) {
+		qc_debug(NULL, "Error: Could not open trace file '%s': %s\n", s, strerror(errno));
+		return;
+	}
+	// start with a metadata event, so that every subsequent event can be prefixed with a comma
+	fprintf(qc_trace_file, "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+				"\"args\":{\"name\":\"qclib\"}}", getpid());
+}
+
+static void qc_trace_close(void) {
+	if (!qc_trace_file)
+		return;
+	fprintf(qc_trace_file, "\n]\n");
+	fclose(qc_trace_file);
+	qc_trace_file = NULL;
+}
+
+static void qc_trace_deinit(void) {
+	if (!getenv("QC_TRACE"))
+		qc_trace_close();
+}
+
+void qc_trace_event(char phase, const char *src, const char *name) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	fprintf(qc_trace_file, ",\n{\"name\":\"%s%s%s\",\"cat\":\"qclib\",\"ph\":\"%c\","
+			"\"ts\":%lld.%03ld,\"pid\":%d,\"tid\":%ld}", src ? src : "", src ? " " : "",
+			name, phase, (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000,
+			ts.tv_nsec % 1000, getpid(), syscall(SYS_gettid));
+}
+
 void qc_debug_indent_inc(void) {
 	qc_dbg_indent += 2;
 }
@@ -257,55 +378,60 @@ void qc_mark_dump_incomplete(struct qc_handle *hdl, char *missing_component) {
 
 /* Convert EBCDIC input to ASCII in place, removing trailing whitespace */
 int qc_ebcdic_to_ascii(struct qc_handle *hdl, char *inbuf, size_t insz) {
-	char *outbuf, *outbuf_start, *inbuf_start = inbuf;
-	size_t len, outsz = insz, insz_orig, outsz_orig;
-	int rc = 0;
-
-	if (!(outbuf_start = malloc(outsz))) {
-		qc_debug(hdl, "Error: Failed to alloc tmp buffer of size %zd for iconv\n", outsz);
-		rc = -1;
-		goto out;
-	}
-	outbuf = outbuf_start;
-	insz_orig = insz;
-	outsz_orig = outsz;
-	len = iconv(qc_cd, &inbuf, &insz, &outbuf, &outsz);
-	if (len == (size_t)(-1)) {
-		qc_debug(hdl, "Error: iconv conversion failed: %s\n", strerror(errno));
-		rc = -2;
-		goto out;
-	}
+	size_t i;
 
-	// remove trailing whitespace
-	for (len = 0; len < outsz_orig - outsz; ++len)
-		if (outbuf_start[len] == ' ') {
-			outbuf_start[len] = '\0';
-			len++;
+	qc_trace_begin(NULL, "qc_ebcdic_to_ascii");
+	for (i = 0; i < insz; ++i) {
+		inbuf[i] = qc_ebcdic_table[(unsigned char)inbuf[i]];
+		if (inbuf[i] == ' ') {
+			inbuf[i] = '\0';
 			break;
 		}
-
-	if (len > insz_orig) {
-		qc_debug(hdl, "Error: iconv result exceeds target buffer (%zd > %zd)\n",
-				len, insz);
-		rc = -3;
-		goto out;
 	}
-	memcpy(inbuf_start, outbuf_start, len);
+	qc_trace_end(NULL, "qc_ebcdic_to_ascii");
 
-out:
-       	free(outbuf_start);
+	return 0;
+}
 
-	return rc;
+/* Convert ASCII input to EBCDIC, padded with blanks to 'outsz' characters */
+int qc_ascii_to_ebcdic(struct qc_handle *hdl, char *outbuf, const char *inbuf, size_t outsz) {
+	size_t i, len = strlen(inbuf);
+
+	if (len > outsz)
+		return -1;
+	for (i = 0; i < len; ++i)
+		outbuf[i] = qc_ascii_table[(unsigned char)inbuf[i]];
+	memset(outbuf + len, qc_ascii_table[' '], outsz - len);
+
+	return 0;
+}
+
+// Returns true if exactly one of 'a' and 'b' is NULL, or if both differ
+int qc_strings_differ(const char *a, const char *b) {
+	return (a == NULL) != (b == NULL) || (a && strcmp(a, b));
+}
+
+// Returns the last buffer of type 'type' in 'bufs', or NULL if not present
+const struct qc_source_buffer *qc_get_source_buffer(const struct qc_source_buffer *bufs, int num, int type) {
+	const struct qc_source_buffer *buf = NULL;
+	int i;
+
+	for (i = 0; i < num; ++i)
+		if (bufs[i].type == type && bufs[i].data)
+			buf = &bufs[i];
+
+	return buf;
 }
 
 // De-alloc hdl, leaving out the actual handle
-static void qc_hdl_reinit(struct qc_handle *hdl) {
+void qc_hdl_reinit(struct qc_handle *hdl) {
 	struct qc_handle *ptr = hdl, *arg = hdl;
 
 	while (ptr) {
 		free(ptr->layer);
 		free(ptr->attr_present);
 		free(ptr->src);
+		qc_free_tables(ptr);
 		hdl = ptr->next;
 		if (ptr == arg) {
 			memset(ptr, 0, sizeof(struct qc_handle));
@@ -367,10 +493,9 @@ static int qc_verify(struct qc_handle *hdl, enum qc_attr_id a, enum qc_attr_id b
 static int qc_consistency_check(struct qc_handle *hdl) {
 	int *etype, rc = 0;
 
-	if (!qc_consistency_check_requested)
-		return 0;
 	qc_debug(hdl, "Run consistency check\n");
 	qc_debug_indent_inc();
+	qc_trace_begin(NULL, "qc_consistency_check");
 	for (; hdl; hdl = hdl->next) {
 		if ((etype = qc_get_attr_value_int(hdl, qc_layer_type_num)) == NULL) {
 			rc = -1;
@@ -385,14 +510,18 @@ static int qc_consistency_check(struct qc_handle *hdl) {
 			    (rc = qc_verify(hdl, qc_num_ifl_dedicated,	 qc_num_cp_dedicated,	ATTR_UNDEF,	      qc_num_core_dedicated, 1)) ||
 			    (rc = qc_verify(hdl, qc_num_ifl_shared,	 qc_num_cp_shared,	ATTR_UNDEF,	      qc_num_core_shared, 1)) ||
 			    (rc = qc_verify(hdl, qc_num_cp_dedicated,    qc_num_cp_shared,	ATTR_UNDEF,	      qc_num_cp_total,  1)) ||
-			    (rc = qc_verify(hdl, qc_num_ifl_dedicated,   qc_num_ifl_shared,	ATTR_UNDEF,	      qc_num_ifl_total, 1)))
+			    (rc = qc_verify(hdl, qc_num_ifl_dedicated,   qc_num_ifl_shared,	ATTR_UNDEF,	      qc_num_ifl_total, 1)) ||
+			    (rc = qc_verify(hdl, qc_num_ziip_dedicated,  qc_num_ziip_shared,	ATTR_UNDEF,	      qc_num_ziip_total, 1)) ||
+			    (rc = qc_verify(hdl, qc_num_icf_dedicated,   qc_num_icf_shared,	ATTR_UNDEF,	      qc_num_icf_total, 1)))
 				goto out;
 			break;
 		case QC_LAYER_TYPE_LPAR:
 			if ((rc = qc_verify(hdl, qc_num_core_dedicated,  qc_num_core_shared,	ATTR_UNDEF,	     qc_num_core_total, 0)) ||
 			    (rc = qc_verify(hdl, qc_num_core_configured, qc_num_core_reserved,	qc_num_core_standby, qc_num_core_total, 0)) ||
 			    (rc = qc_verify(hdl, qc_num_cp_dedicated,	 qc_num_cp_shared,	ATTR_UNDEF,	     qc_num_cp_total,  1)) ||
-			    (rc = qc_verify(hdl, qc_num_ifl_dedicated,   qc_num_ifl_shared,	ATTR_UNDEF,	     qc_num_ifl_total, 1)))
+			    (rc = qc_verify(hdl, qc_num_ifl_dedicated,   qc_num_ifl_shared,	ATTR_UNDEF,	     qc_num_ifl_total, 1)) ||
+			    (rc = qc_verify(hdl, qc_num_ziip_dedicated,  qc_num_ziip_shared,	ATTR_UNDEF,	     qc_num_ziip_total, 1)) ||
+			    (rc = qc_verify(hdl, qc_num_icf_dedicated,   qc_num_icf_shared,	ATTR_UNDEF,	     qc_num_icf_total, 1)))
 				goto out;
 			break;
 		case QC_LAYER_TYPE_ZVM_HYPERVISOR:
@@ -433,6 +562,7 @@ static int qc_consistency_check(struct qc_handle *hdl) {
 	}
 
 out:
+	qc_trace_end(NULL, "qc_consistency_check");
 	qc_debug_indent_dec();
 
 	return rc;
@@ -523,9 +653,441 @@ out:
 	return rc;
 }
 
+/* Attributes that determine the capacity of a CPU type in the layers */
+struct qc_capacity_ids {
+	const char *name;
+	enum qc_attr_id num_total;
+	enum qc_attr_id num_dedicated;
+	enum qc_attr_id num_shared;
+	enum qc_attr_id num_threads;
+	enum qc_attr_id weight;
+	enum qc_attr_id absolute_capping;
+	enum qc_attr_id group_capping;
+	enum qc_attr_id weight_capping;
+	enum qc_attr_id capped_capacity;
+	enum qc_attr_id dispatch_limithard;
+	enum qc_attr_id limithard_cap;
+	enum qc_attr_id capacity_cap;
+	enum qc_attr_id effective_capacity;
+	enum qc_attr_id guaranteed_capacity;
+	enum qc_attr_id limiting_layer;
+	enum qc_attr_id capability;
+	enum qc_attr_id normalized_capacity;
+	enum qc_attr_id core_equivalent_capacity;
+	enum qc_attr_id thread_equivalent_capacity;
+	enum qc_attr_id consumption;
+};
+
+static const struct qc_capacity_ids qc_capacity_ids[] = {
+	{"CP", qc_num_cp_total, qc_num_cp_dedicated, qc_num_cp_shared, qc_num_cp_threads, qc_cp_weight,
+	 qc_cp_absolute_capping, qc_cp_group_capping, qc_cp_weight_capping, qc_cp_capped_capacity, qc_cp_dispatch_limithard,
+	 qc_cp_limithard_cap, qc_cp_capacity_cap, qc_cp_effective_capacity, qc_cp_guaranteed_capacity,
+	 qc_cp_limiting_layer, qc_capability, qc_cp_normalized_capacity,
+	 qc_cp_core_equivalent_capacity, qc_cp_thread_equivalent_capacity, qc_cp_consumption},
+	{"IFL", qc_num_ifl_total, qc_num_ifl_dedicated, qc_num_ifl_shared, qc_num_ifl_threads, qc_ifl_weight,
+	 qc_ifl_absolute_capping, qc_ifl_group_capping, qc_ifl_weight_capping, qc_ifl_capped_capacity, qc_ifl_dispatch_limithard,
+	 qc_ifl_limithard_cap, qc_ifl_capacity_cap, qc_ifl_effective_capacity, qc_ifl_guaranteed_capacity,
+	 qc_ifl_limiting_layer, qc_secondary_capability, qc_ifl_normalized_capacity,
+	 qc_ifl_core_equivalent_capacity, qc_ifl_thread_equivalent_capacity, qc_ifl_consumption},
+};
+
+// Returns the attributes of CPU type 'type', or NULL if not supported
+static const struct qc_capacity_ids *qc_get_capacity_ids(enum qc_cpu_types type) {
+	if (type == QC_CPU_TYPE_CP)
+		return &qc_capacity_ids[0];
+	if (type == QC_CPU_TYPE_IFL)
+		return &qc_capacity_ids[1];
+
+	return NULL;
+}
+
+static int qc_get_attr_int(struct qc_handle *hdl, enum qc_attr_id id, int dflt) {
+	int *i = qc_get_attr_value_int(hdl, id);
+
+	return i ? *i : dflt;
+}
+
+// Returns capacity 'val' limited to the range of the int attributes that hold it
+static int qc_clamp_capacity(int64_t val) {
+	return val > INT_MAX ? INT_MAX : val;
+}
+
+/* Sets the guaranteed capacity of all LPARs in table qc_table_lpars of the CEC layer: Their dedicated cores,
+   plus the share of the shared physical cores as defined by their weight, limited by their shared logical
+   cores as well as their absolute and group capping. Members of LPAR groups are updated accordingly. */
+static int qc_post_process_entitlement(struct qc_handle *hdl, const struct qc_capacity_ids *ids) {
+	int *ded, *shared, *weight, *cap, pool, row, i;
+	int64_t all_weight = 0, share;
+	struct qc_table *tbl, *grp;
+	char *name;
+
+	// the CEC's physical cores are only known in presence of GPD data
+	if ((tbl = qc_get_table(hdl, qc_table_lpars)) == NULL || qc_get_table(hdl, qc_table_cpus) == NULL ||
+	    (pool = qc_get_attr_int(hdl, ids->num_shared, -1)) < 0)
+		return 0;
+	qc_debug(hdl, "Determine %s entitlement of %d LPARs\n", ids->name, tbl->num_rows);
+	for (row = 0; row < tbl->num_rows; row++) {
+		if ((weight = qc_get_row_attr_value_int(tbl, row, ids->weight)) != NULL)
+			all_weight += *weight;
+	}
+	for (row = 0; row < tbl->num_rows; row++) {
+		ded = qc_get_row_attr_value_int(tbl, row, ids->num_dedicated);
+		shared = qc_get_row_attr_value_int(tbl, row, ids->num_shared);
+		weight = qc_get_row_attr_value_int(tbl, row, ids->weight);
+		if (!ded || !shared) {
+			qc_unset_row_attr(tbl, row, ids->guaranteed_capacity);
+			continue;
+		}
+		share = 0;
+		if (weight && all_weight) {
+			share = (int64_t)pool * 0x10000 * *weight / all_weight;
+			if (share > (int64_t)*shared * 0x10000)
+				share = (int64_t)*shared * 0x10000;
+			if ((cap = qc_get_row_attr_value_int(tbl, row, ids->absolute_capping)) != NULL && *cap > 0 && *cap < share)
+				share = *cap;
+			if ((cap = qc_get_row_attr_value_int(tbl, row, ids->group_capping)) != NULL && *cap > 0 && *cap < share)
+				share = *cap;
+		}
+		if (qc_set_row_attr_int(tbl, row, ids->guaranteed_capacity,
+					  qc_clamp_capacity((int64_t)*ded * 0x10000 + share)))
+			return -1;
+	}
+	// LPAR groups hold copies of their members' rows
+	for (; hdl; hdl = hdl->next) {
+		if (*(int *)(hdl->layer) != QC_LAYER_TYPE_LPAR_GROUP || (grp = qc_get_table(hdl, qc_table_lpars)) == NULL)
+			continue;
+		for (row = 0; row < grp->num_rows; row++) {
+			if ((name = qc_get_row_attr_value_string(grp, row, qc_layer_name)) == NULL ||
+			    (i = qc_find_row_string(tbl, qc_layer_name, name)) < 0 || qc_copy_row(grp, row, tbl, i))
+				return -2;
+		}
+	}
+
+	return 0;
+}
+
+/* Returns the sum of the guaranteed capacity of all LPARs in table qc_table_lpars whose attribute 'id'
+   matches the name of the layer, or -1 if unknown */
+static int qc_get_lpars_entitlement(struct qc_handle *hdl, const struct qc_capacity_ids *ids, enum qc_attr_id id) {
+	int row, found = 0, *val;
+	const char *name, *row_name;
+	int64_t sum = 0;
+	struct qc_table *tbl;
+
+	// only set in presence of GPD data
+	if ((tbl = qc_get_table(qc_get_cec_handle(hdl), qc_table_lpars)) == NULL ||
+	    (name = qc_get_attr_value_string(hdl, qc_layer_name)) == NULL)
+		return -1;
+	for (row = 0; row < tbl->num_rows; row++) {
+		if ((row_name = qc_get_row_attr_value_string(tbl, row, id)) == NULL || strcmp(row_name, name))
+			continue;
+		if ((val = qc_get_row_attr_value_int(tbl, row, ids->guaranteed_capacity)) == NULL)
+			return -1;
+		sum += *val;
+		found = 1;
+	}
+
+	return found ? qc_clamp_capacity(sum) : -1;
+}
+
+// Returns the LPAR's guaranteed capacity, or -1 if unknown
+static int qc_get_lpar_entitlement(struct qc_handle *hdl, const struct qc_capacity_ids *ids) {
+	int ded, shared;
+
+	ded = qc_get_attr_int(hdl, ids->num_dedicated, -1);
+	shared = qc_get_attr_int(hdl, ids->num_shared, -1);
+	if (ded < 0 || shared < 0)
+		return -1;
+	if (shared == 0)
+		return qc_clamp_capacity((int64_t)ded * 0x10000);
+
+	return qc_get_lpars_entitlement(hdl, ids, qc_layer_name);
+}
+
+/* Sets the guaranteed capacity of all guests in table qc_table_zvm_guests of z/VM hypervisor 'hyp': Their share of
+   the hypervisor's shared cores as defined by their relative share, limited by their virtual CPUs. The shared cores
+   count as far as covered by the hypervisor's guaranteed capacity 'guar', if known. Returns the entitlement of guest
+   'hdl' in 'ent', or -1 if unknown. */
+static int qc_post_process_zvm_entitlement(struct qc_handle *hyp, struct qc_handle *hdl,
+					   const struct qc_capacity_ids *ids, int guar, int threads, int *ent) {
+	int64_t all_shares = 0, pool, share, lim;
+	int *shares, *vcpus, ded, own_shared, own, row;
+	struct qc_table *tbl;
+	const char *name;
+
+	*ent = -1;
+	if ((tbl = qc_get_table(hyp, qc_table_zvm_guests)) == NULL ||
+	    (pool = qc_get_attr_int(hyp, ids->num_shared, -1)) < 0 ||
+	    (name = qc_get_attr_value_string(hdl, qc_layer_name)) == NULL)
+		return 0;
+	pool *= 0x10000;
+	if (guar >= 0 && (ded = qc_get_attr_int(hyp, ids->num_dedicated, -1)) >= 0 && guar - (int64_t)ded * 0x10000 < pool)
+		pool = guar > (int64_t)ded * 0x10000 ? guar - (int64_t)ded * 0x10000 : 0;
+	// other guests' CPU types are unknown, so all are assumed to compete for the shared cores of every type
+	own = qc_find_row_string(tbl, qc_layer_name, name);
+	qc_debug(hdl, "Determine %s entitlement of %d z/VM guests in a pool of %" PRId64 "\n", ids->name, tbl->num_rows,
+		 pool);
+	for (row = 0; row < tbl->num_rows; row++) {
+		if ((shares = qc_get_row_attr_value_int(tbl, row, qc_cpu_shares)) != NULL)
+			all_shares += *shares;
+	}
+	for (row = 0; row < tbl->num_rows; row++) {
+		shares = qc_get_row_attr_value_int(tbl, row, qc_cpu_shares);
+		vcpus = qc_get_row_attr_value_int(tbl, row, qc_num_cpu_total);
+		if (!shares || !vcpus || !all_shares) {
+			qc_unset_row_attr(tbl, row, ids->guaranteed_capacity);
+			continue;
+		}
+		share = pool * *shares / all_shares;
+		lim = (int64_t)*vcpus * 0x10000 / threads;
+		// for our own guest, the virtual CPUs of the respective type are known
+		if (row == own && (own_shared = qc_get_attr_int(hdl, ids->num_shared, -1)) >= 0)
+			lim = (int64_t)own_shared * 0x10000 / threads;
+		if (share > lim)
+			share = lim;
+		if (qc_set_row_attr_int(tbl, row, ids->guaranteed_capacity, qc_clamp_capacity(share)))
+			return -1;
+		if (row == own)
+			*ent = qc_clamp_capacity(share);
+	}
+
+	return 0;
+}
+
+// Returns the limit that the layer itself imposes on the capacity of a CPU type, or -1 if none
+static int qc_get_layer_capacity(struct qc_handle *hdl, const struct qc_capacity_ids *ids, int cores, int threads) {
+	int64_t lim = -1;
+	int val;
+
+	if ((val = qc_get_attr_int(hdl, ids->num_total, -1)) >= 0)
+		lim = cores ? (int64_t)val * 0x10000 : (int64_t)val * 0x10000 / threads;
+	if ((val = qc_get_attr_int(hdl, ids->absolute_capping, 0)) > 0 && (lim < 0 || val < lim))
+		lim = val;
+	if ((val = qc_get_attr_int(hdl, ids->weight_capping, 0)) > 0 && (lim < 0 || val < lim))
+		lim = val;
+	// capped capacity of z/VM guests and resource pools only limits in case of hard capping
+	if ((val = qc_get_attr_int(hdl, ids->capped_capacity, 0)) > 0 && (lim < 0 || val < lim) &&
+	    (qc_get_attr_int(hdl, ids->dispatch_limithard, 0) || qc_get_attr_int(hdl, ids->limithard_cap, 0) ||
+	     qc_get_attr_int(hdl, ids->capacity_cap, 0)))
+		lim = val;
+
+	return qc_clamp_capacity(lim);
+}
+
+static void qc_smt_yield_init(void) {
+	char *s, *end;
+
+	if ((s = getenv("QC_SMT_YIELD")) != NULL) {
+		qc_smt_yield = strtof(s, &end);
+		if (end == s || qc_smt_yield < 1) {
+			qc_debug(NULL, "Warning: Invalid value for QC_SMT_YIELD '%s', using default\n", s);
+			qc_smt_yield = QC_SMT_YIELD;
+		}
+	}
+}
+
+// Returns the SMT yield, with QC_SMT_YIELD evaluated once per process so that
+// concurrent opens, including qc_open_from_buffers() and qc_simulate(), agree
+static float qc_get_smt_yield(void) {
+	pthread_once(&qc_smt_yield_once, qc_smt_yield_init);
+
+	return qc_smt_yield;
+}
+
+/* Determines the effective and guaranteed capacity of a CPU type in all layers, starting at the CEC.
+   Counts up to the LPAR and in hypervisors running in an LPAR refer to cores, all others to CPUs, which
+   refer to threads in case of SMT. */
+static int qc_post_process_capacity(struct qc_handle *hdl, const struct qc_capacity_ids *ids) {
+	int eff = -1, guar = -1, limiting = -1, threads = 1, prev_type = -1, hyp_guar = -1;
+	int type, cores, lim, val, share, smt;
+	struct qc_handle *hyp = NULL;
+
+	qc_debug(hdl, "Determine %s capacity\n", ids->name);
+	qc_debug_indent_inc();
+	for (; hdl; hdl = hdl->next, prev_type = type) {
+		type = *(int *)(hdl->layer);
+		cores = type == QC_LAYER_TYPE_CEC || type == QC_LAYER_TYPE_LPAR_GROUP || type == QC_LAYER_TYPE_LPAR ||
+			prev_type == QC_LAYER_TYPE_LPAR;
+		// values are possibly derived anew, see qc_simulate()
+		qc_unset_attr(hdl, ids->effective_capacity);
+		qc_unset_attr(hdl, ids->guaranteed_capacity);
+		qc_unset_attr(hdl, ids->limiting_layer);
+		qc_unset_attr(hdl, ids->core_equivalent_capacity);
+		qc_unset_attr(hdl, ids->thread_equivalent_capacity);
+		lim = qc_get_layer_capacity(hdl, ids, cores, threads);
+		if (lim >= 0 && (eff < 0 || lim < eff)) {
+			eff = lim;
+			limiting = hdl->layer_no;
+		}
+		switch (type) {
+		case QC_LAYER_TYPE_CEC:
+			guar = eff;
+			break;
+		case QC_LAYER_TYPE_LPAR_GROUP:
+			guar = qc_get_lpars_entitlement(hdl, ids, qc_lpar_group_name);
+			break;
+		case QC_LAYER_TYPE_LPAR:
+			guar = qc_get_lpar_entitlement(hdl, ids);
+			break;
+		case QC_LAYER_TYPE_ZVM_HYPERVISOR:
+			hyp = hdl;
+			hyp_guar = guar > eff ? eff : guar;
+			break;
+		case QC_LAYER_TYPE_ZVM_GUEST:
+			// z/VM guests are entitled to their dedicated CPUs plus their share of the shared cores
+			share = -1;
+			if (hyp && qc_post_process_zvm_entitlement(hyp, hdl, ids, hyp_guar, threads, &share))
+				goto fail;
+			hyp = NULL;
+			if ((val = qc_get_attr_int(hdl, ids->num_dedicated, -1)) < 0)
+				guar = -1;
+			else if (share >= 0) {
+				// capped by resource pools via the effective capacity below
+				val = val * 0x10000 / threads + share;
+				if (guar < 0 || val < guar)
+					guar = val;
+			} else if (val == 0 || (guar >= 0 && val * 0x10000 / threads < guar))
+				guar = val * 0x10000 / threads;
+			break;
+		case QC_LAYER_TYPE_KVM_GUEST:
+			// KVM guests are entitled to their dedicated CPUs only
+			if ((val = qc_get_attr_int(hdl, ids->num_dedicated, -1)) < 0)
+				guar = -1;
+			else if (val == 0 || (guar >= 0 && val * 0x10000 / threads < guar))
+				guar = val * 0x10000 / threads;
+			break;
+		default:
+			break;
+		}
+		if (guar > eff)
+			guar = eff;
+		// CPUs of the CEC and LPAR groups are physical cores, guests' virtual CPUs are threads of the hypervisor
+		if (!cores)
+			smt = threads;
+		else if (type == QC_LAYER_TYPE_CEC || type == QC_LAYER_TYPE_LPAR_GROUP ||
+			 (smt = qc_get_attr_int(hdl, ids->num_threads, 0)) <= 0)
+			smt = 1;
+		if (cores && (val = qc_get_attr_int(hdl, ids->num_threads, 0)) > 0)
+			threads = val;
+		if (eff < 0)
+			continue;
+		qc_debug(hdl, "Layer %d: effective=%d, guaranteed=%d, limited by layer %d, %d thread(s) per core\n",
+			 hdl->layer_no, eff, guar, limiting, smt);
+		if (qc_set_attr_int(hdl, ids->effective_capacity, eff, ATTR_SRC_POSTPROC) ||
+		    qc_set_attr_int(hdl, ids->limiting_layer, limiting, ATTR_SRC_POSTPROC) ||
+		    (guar >= 0 && qc_set_attr_int(hdl, ids->guaranteed_capacity, guar, ATTR_SRC_POSTPROC)) ||
+		    qc_set_attr_float(hdl, ids->thread_equivalent_capacity, (float)eff / 0x10000 * smt, ATTR_SRC_POSTPROC) ||
+		    qc_set_attr_float(hdl, ids->core_equivalent_capacity,
+				      (float)eff / 0x10000 * (smt > 1 ? qc_get_smt_yield() : 1), ATTR_SRC_POSTPROC))
+			goto fail;
+	}
+	qc_debug_indent_dec();
+
+	return 0;
+fail:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+// Returns the capability rating of the CEC's cores of a CPU type, or 0 if unknown
+static float qc_get_capability(struct qc_handle *cec, const struct qc_capacity_ids *ids) {
+	float *val;
+
+	// secondary capability is only set if it differs
+	if ((val = qc_get_attr_value_float(cec, ids->capability)) == NULL || *val <= 0)
+		val = qc_get_attr_value_float(cec, qc_capability);
+
+	return val && *val > 0 ? *val : 0;
+}
+
+// Expresses the effective capacity of all layers in normalized capacity units, see qc_normalized_capacity
+static int qc_post_process_normalized_capacity(struct qc_handle *hdl) {
+	struct qc_handle *cec = hdl;
+	float capability, norm, sum;
+	unsigned int i;
+	int *eff, set;
+
+	for (; hdl; hdl = hdl->next) {
+		qc_unset_attr(hdl, qc_normalized_capacity);
+		for (i = 0, sum = 0, set = 0; i < sizeof(qc_capacity_ids) / sizeof(qc_capacity_ids[0]); i++) {
+			qc_unset_attr(hdl, qc_capacity_ids[i].normalized_capacity);
+			if ((capability = qc_get_capability(cec, &qc_capacity_ids[i])) == 0 ||
+			    (eff = qc_get_attr_value_int(hdl, qc_capacity_ids[i].effective_capacity)) == NULL)
+				continue;
+			norm = (float)*eff / 0x10000 * QC_CAPABILITY_REFERENCE / capability;
+			if (qc_set_attr_float(hdl, qc_capacity_ids[i].normalized_capacity, norm, ATTR_SRC_POSTPROC))
+				return -1;
+			sum += norm;
+			set = 1;
+		}
+		if (set && qc_set_attr_float(hdl, qc_normalized_capacity, sum, ATTR_SRC_POSTPROC))
+			return -1;
+	}
+
+	return 0;
+}
+
+// Derives the entitlements and capacities of all CPU types, starting at the CEC layer 'hdl'
+static int qc_derive_capacity(struct qc_handle *hdl) {
+	unsigned int i;
+
+	for (i = 0; i < sizeof(qc_capacity_ids) / sizeof(qc_capacity_ids[0]); i++) {
+		if (qc_post_process_entitlement(hdl, &qc_capacity_ids[i]) ||
+		    qc_post_process_capacity(hdl, &qc_capacity_ids[i]))
+			return -1;
+	}
+
+	return qc_post_process_normalized_capacity(hdl);
+}
+
+// Derives the upper limit of the memory from the memory sizes and limits of all layers, starting at the CEC layer 'hdl'
+static int qc_post_process_memory(struct qc_handle *hdl) {
+	enum qc_attr_id ids[] = {qc_mem_max, qc_mem_total, qc_mem_limit};
+	int64_t eff = -1, *val;
+	int limiting = -1;
+	unsigned int i;
+
+	qc_debug(hdl, "Determine memory limits\n");
+	qc_debug_indent_inc();
+	for (; hdl; hdl = hdl->next) {
+		qc_unset_attr(hdl, qc_mem_effective);
+		qc_unset_attr(hdl, qc_mem_limiting_layer);
+		for (i = 0; i < sizeof(ids) / sizeof(ids[0]); i++) {
+			if ((val = qc_get_attr_value_int64(hdl, ids[i])) != NULL && *val > 0 && (eff < 0 || *val < eff)) {
+				eff = *val;
+				limiting = hdl->layer_no;
+			}
+		}
+		switch (*(int *)(hdl->layer)) {
+		case QC_LAYER_TYPE_LPAR:
+		case QC_LAYER_TYPE_ZVM_GUEST:
+		case QC_LAYER_TYPE_KVM_HYPERVISOR:
+		case QC_LAYER_TYPE_KVM_GUEST:
+			break;
+		default:
+			continue;
+		}
+		if (eff < 0)
+			continue;
+		qc_debug(hdl, "Layer %d: effective=%" PRId64 " KB, limited by layer %d\n", hdl->layer_no, eff, limiting);
+		if (qc_set_attr_int64(hdl, qc_mem_effective, eff, ATTR_SRC_POSTPROC) ||
+		    qc_set_attr_int(hdl, qc_mem_limiting_layer, limiting, ATTR_SRC_POSTPROC)) {
+			qc_debug_indent_dec();
+			return -1;
+		}
+	}
+	qc_debug_indent_dec();
+
+	return 0;
+}
+
 static int qc_post_processing(struct qc_handle *hdl) {
+	struct qc_handle *root = hdl;
+
 	qc_debug(hdl, "Post processing: Fill KVM layers\n");
 	qc_debug_indent_inc();
+	qc_trace_begin(NULL, "qc_post_processing");
 	for (; hdl; hdl = hdl->next) {
 		switch(*(int *)(hdl->layer)) {
 		case QC_LAYER_TYPE_KVM_HYPERVISOR:
@@ -540,23 +1102,30 @@ static int qc_post_processing(struct qc_handle *hdl) {
 			break;
 		}
 	}
+	if (qc_derive_capacity(root) || qc_post_process_memory(root))
+		goto fail;
+	qc_trace_end(NULL, "qc_post_processing");
 	qc_debug_indent_dec();
 
 	return 0;
 fail:
+	qc_trace_end(NULL, "qc_post_processing");
 	qc_debug_indent_dec();
 
 	return -1;
 }
 
-static void *_qc_open(struct qc_handle *hdl, int *rc) {
-	// sysinfo needs to be handled first, or our LGM check later on will have loopholes
-	struct qc_data_src *src, *sources[] = {&sysinfo, &ocf, &hypfs, &sthyi, NULL};
+/* Retrieves the data from the running system, or from 'bufs' if set. Note that the latter
+   must not touch any global state. */
+static void *_qc_open(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num, int *rc) {
+	char *priv[sizeof(qc_sources) / sizeof(qc_sources[0])] = {NULL};
+	struct qc_data_src *src;
 	struct qc_handle *lparhdl;
 	int i;
 
 	qc_debug(hdl, "_qc_open()\n");
 	qc_debug_indent_inc();
+	qc_trace_begin(NULL, "_qc_open");
 	*rc = 0;
 	if (qc_new_handle(NULL, &hdl, 0, QC_LAYER_TYPE_CEC) ||
 	    qc_new_handle(hdl, &lparhdl, 1, QC_LAYER_TYPE_LPAR)) {
@@ -567,20 +1136,31 @@ static void *_qc_open(struct qc_handle *hdl, int *rc) {
 	lparhdl->root = hdl->root;
 
 	// open all data sources
-	for (i = 0; (src = sources[i]) != NULL; i++)
-		if (src->open(hdl, &src->priv))
+	for (i = 0; (src = qc_sources[i]) != NULL; i++) {
+		qc_trace_begin(src->name, "open");
+		if (bufs ? src->open_buf(hdl, bufs, num, &priv[i]) : src->open(hdl, &priv[i]))
 			*rc = -2;	// don't exit on error immediately, so we collect all data for a dump later on
+		qc_trace_end(src->name, "open");
+	}
 	if (*rc)
 		goto out;
 
 	// verify that we weren't migrated
-	if ((*rc = sysinfo.lgm_check(hdl, sysinfo.priv)) != 0)
-		goto out;
+	if (!bufs) {
+		qc_trace_begin(sysinfo.name, "lgm_check");
+		*rc = sysinfo.lgm_check(hdl, priv[0]);
+		qc_trace_end(sysinfo.name, "lgm_check");
+		if (*rc)
+			goto out;
+	}
 
 	// process data sources
-	for (i = 0; (src = sources[i]) != NULL; i++) {
+	for (i = 0; (src = qc_sources[i]) != NULL; i++) {
 		// Return values >0 will be left as is and passed back to caller
-		if ((*rc = src->process(hdl, src->priv)) < 0) {
+		qc_trace_begin(src->name, "process");
+		*rc = src->process(hdl, priv[i]);
+		qc_trace_end(src->name, "process");
+		if (*rc < 0) {
 			*rc = -3;	// match errors to a value that we can identify
 			goto out;
 		}
@@ -604,12 +1184,15 @@ static void *_qc_open(struct qc_handle *hdl, int *rc) {
 
 out:
 	// Possibly dump all data sources
-	if (qc_dbg_level > 1 || (qc_dbg_autodump && *rc < 0)) {
+	if (!bufs && (qc_dbg_level > 1 || (qc_dbg_autodump && *rc < 0))) {
 		qc_debug(hdl, "Create dump\n");
 		qc_debug_indent_inc();
 		if (qc_debug_open_dump_dir(hdl) == 0) {	// get a new dump directory
-			for (i = 0; (src = sources[i]) != NULL; i++)
-				src->dump(hdl, src->priv);
+			for (i = 0; (src = qc_sources[i]) != NULL; i++) {
+				qc_trace_begin(src->name, "dump");
+				src->dump(hdl, priv[i]);
+				qc_trace_end(src->name, "dump");
+			}
 			qc_debug_close_dump_dir(hdl);
 		} else
 			qc_debug(hdl, "Failed, could not open directory\n");
@@ -617,9 +1200,13 @@ out:
 	}
 
 	// Close all data sources
-	for (i = 0; (src = sources[i]) != NULL; i++)
-		src->close(hdl, src->priv);
+	for (i = 0; (src = qc_sources[i]) != NULL; i++) {
+		qc_trace_begin(src->name, "close");
+		src->close(hdl, priv[i]);
+		qc_trace_end(src->name, "close");
+	}
 	qc_debug(hdl, "Return rc=%d\n", *rc);
+	qc_trace_end(NULL, "_qc_open");
 	qc_debug_indent_dec();
 
 	return hdl;
@@ -634,11 +1221,13 @@ static int qc_register_hdl(struct qc_handle *hdl) {
 		return -1;
 	}
 	entry->hdl = hdl;
+	pthread_mutex_lock(&qc_hdls_lock);
 	if (qc_hdls)
 		entry->next = qc_hdls;
 	else
 		entry->next = NULL;
 	qc_hdls = entry;
+	pthread_mutex_unlock(&qc_hdls_lock);
 
 	return 0;
 }
@@ -648,10 +1237,14 @@ static int qc_verify_hdl(struct qc_handle *hdl, const char *func) {
 
 	if (!hdl)
 		return -1;
+	pthread_mutex_lock(&qc_hdls_lock);
 	for (entry = qc_hdls; entry != NULL; entry = entry->next) {
-		if (entry->hdl == hdl)
+		if (entry->hdl == hdl) {
+			pthread_mutex_unlock(&qc_hdls_lock);
 			return 0;
+		}
 	}
+	pthread_mutex_unlock(&qc_hdls_lock);
 	qc_debug(NULL, "Error: %s() called with unknown handle 0x%p\n", func, hdl);
 
 	return -1;
@@ -660,6 +1253,7 @@ static int qc_verify_hdl(struct qc_handle *hdl, const char *func) {
 static void qc_unregister_hdl(struct qc_handle *hdl) {
 	struct qc_reg_hdl *entry, *prev = NULL;
 
+	pthread_mutex_lock(&qc_hdls_lock);
 	for (entry = qc_hdls; entry != NULL; prev = entry, entry = entry->next) {
 		if (entry->hdl == hdl) {
 			if (prev && entry->next)
@@ -672,6 +1266,7 @@ static void qc_unregister_hdl(struct qc_handle *hdl) {
 			break;
 		}
 	}
+	pthread_mutex_unlock(&qc_hdls_lock);
 	return;
 }
 
@@ -681,6 +1276,8 @@ void *qc_open(int *rc) {
 	int i;
 
 	*rc = 0;
+	qc_trace_init();
+	qc_trace_begin(NULL, "qc_open");
 	if (qc_debug_init()) {
 		*rc = -1;
 		goto out;
@@ -688,16 +1285,6 @@ void *qc_open(int *rc) {
 	qc_debug(hdl, "qc_open()\n");
 	qc_debug_indent_inc();
 
-	if (qc_cd == (iconv_t)-1) {
-		qc_debug(hdl, "Initialize iconv\n");
-		qc_cd = iconv_open("ISO8859-1", "IBM-1047");
-		if (qc_cd == (iconv_t)-1) {
-			qc_debug(hdl, "Error: iconv setup failed: %s\n", strerror(errno));
-			*rc = -2;
-			goto out;
-		}
-	}
-
 	if ((s = getenv("QC_CHECK_CONSISTENCY")) != NULL) {
 		qc_consistency_check_requested = strtol(s, &end, 10);
 		if (end == s || qc_consistency_check_requested < 0)
@@ -712,8 +1299,8 @@ void *qc_open(int *rc) {
 			qc_debug(hdl, "Warning: Consistency check failed, retry %d\n", i);
 			qc_hdl_reinit(hdl);
 		}
-		hdl = _qc_open(hdl, rc);
-		if (*rc	|| ((*rc = qc_consistency_check(hdl)) <= 0))
+		hdl = _qc_open(hdl, NULL, 0, rc);
+		if (*rc	|| !qc_consistency_check_requested || ((*rc = qc_consistency_check(hdl)) <= 0))
 			break;
 	}
 	if (*rc > 0) {
@@ -724,6 +1311,7 @@ void *qc_open(int *rc) {
 
 out:
 	qc_debug(hdl, "Return %p, rc=%d\n", *rc ? NULL : hdl, *rc);
+	qc_trace_end(NULL, "qc_open");
 	qc_debug_indent_dec();
 	if (*rc) {
 		qc_close(hdl);
@@ -733,13 +1321,53 @@ out:
 	return hdl;
 }
 
+void *qc_open_from_buffers(const struct qc_source_buffer *bufs, int num, int *rc) {
+	struct qc_handle *hdl = NULL;
+
+	*rc = 0;
+	qc_trace_begin(NULL, "qc_open_from_buffers");
+	qc_debug(hdl, "qc_open_from_buffers(num=%d)\n", num);
+	qc_debug_indent_inc();
+	if (!bufs || num <= 0) {
+		qc_debug(hdl, "Error: No buffers provided\n");
+		*rc = -1;
+		goto out;
+	}
+	// No retries, as the data won't change
+	hdl = _qc_open(hdl, bufs, num, rc);
+	if (hdl)
+		hdl->buffered = 1;
+	if (*rc > 0)
+		*rc = 1;	// incomplete
+	if (*rc == 0 && (*rc = qc_consistency_check(hdl)) > 0)
+		*rc = 2;	// inconsistent
+	if (*rc == 0)
+		*rc = qc_register_hdl(hdl);
+
+out:
+	qc_debug(hdl, "Return %p, rc=%d\n", *rc ? NULL : hdl, *rc);
+	qc_debug_indent_dec();
+	qc_trace_end(NULL, "qc_open_from_buffers");
+	if (*rc && hdl) {
+		qc_hdl_reinit(hdl);
+		free(hdl);
+		hdl = NULL;
+	}
+
+	return hdl;
+}
+
 void qc_close(void *hdl) {
 	if (qc_verify_hdl(hdl, "qc_close"))
 		return;
 	qc_debug(hdl, "qc_close()\n");
 	qc_debug_indent_inc();
 
-	qc_debug_deinit(hdl);
+	// configurations opened from buffers must not touch any global state
+	if (!((struct qc_handle *)hdl)->buffered) {
+		qc_debug_deinit(hdl);
+		qc_trace_deinit();
+	}
 	qc_hdl_reinit(hdl);
 	qc_unregister_hdl(hdl);
 	free(hdl);
@@ -778,7 +1406,11 @@ static struct qc_handle *qc_get_layer_handle(void *config, int layer) {
 }
 
 static int qc_is_attr_id_valid(enum qc_attr_id id) {
-	return id <= qc_num_core_shared;
+	return id <= qc_mem_limiting_layer;
+}
+
+static int qc_is_table_id_valid(enum qc_table_id id) {
+	return id <= qc_table_topology;
 }
 
 int qc_get_attribute_string(void *cfg, enum qc_attr_id id, int layer, const char **value) {
@@ -859,6 +1491,47 @@ out:
 }
 
 
+int qc_get_attribute_int64(void *cfg, enum qc_attr_id id, int layer, int64_t *value) {
+	struct qc_handle *hdl;
+	void *ptr = NULL;
+	int rc;
+
+	*value = -EINVAL;
+	if (qc_verify_hdl(cfg, "qc_get_attribute_int64"))
+		return -4;
+	hdl = qc_get_layer_handle(cfg, layer);
+	qc_debug(cfg, "qc_get_attribute_int64(attr=%d, layer=%d)\n", id, layer);
+	qc_debug_indent_inc();
+	if (!hdl) {
+		rc = -1;
+		goto out;
+	}
+	if (!qc_is_attr_id_valid(id)) {
+		rc = -2;
+		goto out;
+	}
+	if ((ptr = qc_get_attr_value_int64(hdl, id))) {
+		qc_debug(cfg, "Attr '%s' from '%c' res=%" PRId64 "\n", qc_attr_id_to_char(cfg, id), qc_get_attr_value_src_int64(hdl, id), *(int64_t *)ptr);
+		rc = 1;
+		goto out;
+	}
+	// Attribute value not set - let's figure out why
+	if (qc_is_attr_set_int64(hdl, id) <= 0) {
+		qc_debug(cfg, "Attr '%s' not defined\n", qc_attr_id_to_char(cfg, id));
+		rc = 0;
+		goto out;
+	}
+	rc = -3;
+
+out:
+	if (ptr)
+		*value = *(int64_t *)ptr;
+	qc_debug(cfg, "Return value=%" PRId64 ", rc=%d\n", *value, rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
 int qc_get_attribute_float(void *cfg, enum qc_attr_id id, int layer, float *value) {
 	struct qc_handle *hdl;
 	void *ptr = NULL;
@@ -899,3 +1572,709 @@ out:
 
 	return rc;
 }
+
+int qc_compute_utilization(void *cfg, void *prev_cfg) {
+	struct qc_data_src *src;
+	int i, rc = 1, src_rc;
+
+	if (qc_verify_hdl(cfg, "qc_compute_utilization") || qc_verify_hdl(prev_cfg, "qc_compute_utilization"))
+		return -4;
+	qc_debug(cfg, "qc_compute_utilization(prev=%p)\n", prev_cfg);
+	qc_debug_indent_inc();
+	for (i = 0; (src = qc_sources[i]) != NULL; i++) {
+		if (!src->utilization)
+			continue;
+		src_rc = src->utilization(cfg, prev_cfg);
+		if (src_rc < 0) {
+			rc = -1;
+			goto out;
+		}
+		if (src_rc == 0)
+			rc = 0;
+	}
+
+out:
+	qc_debug(cfg, "Return rc=%d\n", rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+int qc_recommend_parallelism(void *cfg, enum qc_cpu_types type, enum qc_parallelism_policies policy, int *rc) {
+	int visible, threads = 1, prev_type = -1, layer_type, cores = 0, num = 0, *val, *eff, *guar, *capping;
+	const struct qc_capacity_ids *ids;
+	struct qc_handle *hdl;
+	int64_t cpus;
+
+	if (qc_verify_hdl(cfg, "qc_recommend_parallelism")) {
+		*rc = -4;
+		return 0;
+	}
+	qc_debug(cfg, "qc_recommend_parallelism(type=%d, policy=%d)\n", type, policy);
+	qc_debug_indent_inc();
+	if ((ids = qc_get_capacity_ids(type)) == NULL) {
+		qc_debug(cfg, "Error: Unsupported CPU type\n");
+		*rc = -1;
+		goto out;
+	}
+	if (policy != QC_PARALLELISM_THROUGHPUT && policy != QC_PARALLELISM_LATENCY &&
+	    policy != QC_PARALLELISM_CONSERVATIVE) {
+		qc_debug(cfg, "Error: Unsupported policy\n");
+		*rc = -2;
+		goto out;
+	}
+	// counts refer to cores in the LPAR and in hypervisors running in an LPAR, see qc_post_process_capacity()
+	for (hdl = cfg; hdl; hdl = hdl->next, prev_type = layer_type) {
+		layer_type = *(int *)(hdl->layer);
+		cores = layer_type == QC_LAYER_TYPE_LPAR || prev_type == QC_LAYER_TYPE_LPAR;
+		if (cores && (val = qc_get_attr_value_int(hdl, ids->num_threads)) != NULL && *val > 0)
+			threads = *val;
+		if (!hdl->next)
+			break;
+	}
+	if ((val = qc_get_attr_value_int(hdl, ids->num_total)) == NULL || *val <= 0) {
+		qc_debug(cfg, "No %ss visible\n", ids->name);
+		*rc = 1;
+		goto out;
+	}
+	visible = cores ? *val * threads : *val;
+	eff = qc_get_attr_value_int(hdl, ids->effective_capacity);
+	guar = qc_get_attr_value_int(hdl, ids->guaranteed_capacity);
+	capping = qc_get_attr_value_int(hdl, qc_capping_num);
+	switch (policy) {
+	case QC_PARALLELISM_THROUGHPUT:
+		if (!eff || (capping && *capping == QC_CAPPING_SOFT)) {
+			num = visible;
+			break;
+		}
+		// round up, since partially available CPUs still add throughput, see qc_cp_thread_equivalent_capacity
+		cpus = (int64_t)*eff * threads;
+		num = (cpus + 0xffff) / 0x10000;
+		break;
+	case QC_PARALLELISM_CONSERVATIVE:
+		// all threads of the guaranteed cores are guaranteed as well
+		if (guar) {
+			num = (int64_t)*guar * threads / 0x10000;
+			break;
+		}
+		/* fall through */
+	case QC_PARALLELISM_LATENCY:
+		num = eff ? *eff / 0x10000 : visible / threads;
+		break;
+	}
+	if (num > visible)
+		num = visible;
+	if (num < 1)
+		num = 1;
+	qc_debug(cfg, "%d %s(s) visible, %d thread(s) per core, recommend %d worker(s)\n", visible, ids->name,
+		 threads, num);
+	*rc = 0;
+
+out:
+	qc_debug(cfg, "Return %d, rc=%d\n", num, *rc);
+	qc_debug_indent_dec();
+
+	return num;
+}
+
+// Applies a single change of qc_simulate() to configuration 'sim'
+static int qc_apply_change(struct qc_handle *sim, const struct qc_change *change) {
+	struct qc_table *tbl;
+	struct qc_handle *hdl;
+	char *name;
+	int row;
+
+	if ((hdl = qc_get_layer_handle(sim, change->layer)) == NULL || !qc_is_attr_id_valid(change->id)) {
+		qc_debug(sim, "Error: Invalid layer or attribute\n");
+		return -1;
+	}
+	if (change->table >= 0) {
+		if (!qc_is_table_id_valid(change->table) || (tbl = qc_get_table(hdl, change->table)) == NULL ||
+		    qc_set_row_attr_int(tbl, change->row, change->id, change->value))
+			return -1;
+		return 0;
+	}
+	// unset first, so the consistency check won't object to the new value
+	qc_unset_attr(hdl, change->id);
+	if (qc_set_attr_int(hdl, change->id, change->value, ATTR_SRC_POSTPROC))
+		return -1;
+	// keep our LPAR's row in the CEC layer in sync, as it determines the LPAR's entitlement
+	if (*(int *)(hdl->layer) == QC_LAYER_TYPE_LPAR && (tbl = qc_get_table(sim, qc_table_lpars)) != NULL &&
+	    qc_has_row_attr_int(tbl, change->id) && (name = qc_get_attr_value_string(hdl, qc_layer_name)) != NULL &&
+	    (row = qc_find_row_string(tbl, qc_layer_name, name)) >= 0 &&
+	    qc_set_row_attr_int(tbl, row, change->id, change->value))
+		return -1;
+
+	return 0;
+}
+
+void *qc_simulate(void *cfg, const struct qc_change *changes, int num, int *rc) {
+	struct qc_handle *sim = NULL, *hdl, *tgt = NULL, *prev = NULL;
+	struct qc_table *tbl;
+	int i;
+
+	if (qc_verify_hdl(cfg, "qc_simulate")) {
+		*rc = -4;
+		return NULL;
+	}
+	qc_debug(cfg, "qc_simulate(num=%d)\n", num);
+	qc_debug_indent_inc();
+	*rc = 0;
+	if (num < 0 || (num > 0 && !changes)) {
+		qc_debug(cfg, "Error: No changes provided\n");
+		*rc = -1;
+		goto out;
+	}
+	// work on a copy, leaving the original configuration untouched
+	for (hdl = cfg; hdl; hdl = hdl->next) {
+		if (qc_copy_handle(sim, &tgt, hdl)) {
+			*rc = -2;
+			goto out;
+		}
+		if (prev)
+			prev->next = tgt;
+		else
+			sim = tgt;
+		prev = tgt;
+		for (tbl = hdl->tables; tbl; tbl = tbl->next) {
+			if (qc_copy_table(tgt, tbl)) {
+				*rc = -2;
+				goto out;
+			}
+		}
+	}
+	sim->buffered = 1;
+	for (i = 0; i < num; i++) {
+		qc_debug(cfg, "Change %d: Set attr '%s' at layer %d, table %d, row %d to %d\n", i,
+			 qc_attr_id_to_char(cfg, changes[i].id), changes[i].layer, changes[i].table, changes[i].row,
+			 changes[i].value);
+		if (qc_apply_change(sim, &changes[i])) {
+			qc_debug(cfg, "Error: Failed to apply change %d\n", i);
+			*rc = -1;
+			goto out;
+		}
+	}
+	if (qc_derive_capacity(sim)) {
+		*rc = -3;
+		goto out;
+	}
+	*rc = qc_register_hdl(sim);
+
+out:
+	if (*rc && sim) {
+		qc_hdl_reinit(sim);
+		free(sim);
+		sim = NULL;
+	}
+	qc_debug(cfg, "Return %p, rc=%d\n", sim, *rc);
+	qc_debug_indent_dec();
+
+	return sim;
+}
+
+#define QC_STATS_NUM_TYPES	(int)(sizeof(qc_capacity_ids) / sizeof(qc_capacity_ids[0]))
+
+// Samples of the consumption of a CPU type in a layer, see qc_stats_open()
+struct qc_stats_series {
+	int	*ring;		// 'window' samples
+	int	 num;		// number of valid samples
+	int	 next;		// index of the next sample to write
+	double	 ewma;
+	int	 eff;		// effective capacity of the latest sample, or -1 if unknown
+};
+
+// Condition as registered with qc_stats_add_threshold()
+struct qc_stats_threshold {
+	struct qc_threshold	 thr;
+	qc_threshold_cb		 cb;
+	void			*data;
+	int			 fd;
+	int			 active;
+};
+
+struct qc_stats {
+	struct qc_stats_config	 cfg;
+	int			 num_layers;
+	int			*layer_types;
+	struct qc_stats_series	*series;	// 'num_layers' * QC_STATS_NUM_TYPES entries
+	int			*ring;		// backs the rings of all series
+	int			*scratch;	// 'window' entries to determine percentiles
+	struct qc_stats_threshold *thresholds;
+	int			 num_thresholds;
+};
+
+// Returns the k-th smallest of the 'num' elements in 'a', reordering them in place. Unlike qsort(), this
+// is guaranteed not to allocate memory
+static int qc_select_int(int *a, int num, int k) {
+	int lo = 0, hi = num - 1, i, j, pivot, tmp;
+
+	while (lo < hi) {
+		pivot = a[(lo + hi) / 2];
+		for (i = lo, j = hi; i <= j;) {
+			while (a[i] < pivot)
+				i++;
+			while (a[j] > pivot)
+				j--;
+			if (i <= j) {
+				tmp = a[i];
+				a[i++] = a[j];
+				a[j--] = tmp;
+			}
+		}
+		if (k <= j)
+			hi = j;
+		else if (k >= i)
+			lo = i;
+		else
+			break;
+	}
+
+	return a[k];
+}
+
+void qc_stats_close(void *stats) {
+	struct qc_stats *st = stats;
+
+	if (!st)
+		return;
+	free(st->layer_types);
+	free(st->series);
+	free(st->ring);
+	free(st->scratch);
+	free(st->thresholds);
+	free(st);
+}
+
+void *qc_stats_open(void *cfg, const struct qc_stats_config *stats_cfg, int *rc) {
+	struct qc_stats_config dflt = {60, 0.3, 5};
+	struct qc_stats *st = NULL;
+	struct qc_handle *hdl;
+	int i;
+
+	if (qc_verify_hdl(cfg, "qc_stats_open")) {
+		*rc = -4;
+		return NULL;
+	}
+	qc_debug(cfg, "qc_stats_open()\n");
+	qc_debug_indent_inc();
+	*rc = 0;
+	if (!stats_cfg)
+		stats_cfg = &dflt;
+	if (stats_cfg->window < 1 || stats_cfg->alpha <= 0 || stats_cfg->alpha > 1 || stats_cfg->horizon < 0) {
+		qc_debug(cfg, "Error: Invalid settings\n");
+		*rc = -1;
+		goto out;
+	}
+	if ((st = calloc(1, sizeof(struct qc_stats))) == NULL) {
+		*rc = -2;
+		goto out;
+	}
+	st->cfg = *stats_cfg;
+	st->num_layers = qc_get_num_layers(cfg, rc);
+	st->layer_types = calloc(st->num_layers, sizeof(int));
+	st->series = calloc(st->num_layers * QC_STATS_NUM_TYPES, sizeof(struct qc_stats_series));
+	st->ring = calloc((size_t)st->num_layers * QC_STATS_NUM_TYPES * st->cfg.window, sizeof(int));
+	st->scratch = calloc(st->cfg.window, sizeof(int));
+	if (!st->layer_types || !st->series || !st->ring || !st->scratch) {
+		qc_debug(cfg, "Error: Failed to allocate statistics\n");
+		*rc = -2;
+		goto out;
+	}
+	for (hdl = cfg; hdl; hdl = hdl->next)
+		st->layer_types[hdl->layer_no] = *(int *)(hdl->layer);
+	for (i = 0; i < st->num_layers * QC_STATS_NUM_TYPES; i++) {
+		st->series[i].ring = st->ring + i * st->cfg.window;
+		st->series[i].eff = -1;
+	}
+	qc_debug(cfg, "Window of %d samples, alpha=%f, horizon of %d samples\n", st->cfg.window, st->cfg.alpha,
+		 st->cfg.horizon);
+
+out:
+	if (*rc) {
+		qc_stats_close(st);
+		st = NULL;
+	}
+	qc_debug(cfg, "Return %p, rc=%d\n", st, *rc);
+	qc_debug_indent_dec();
+
+	return st;
+}
+
+// Retrieves the value of integer or float attribute 'id' in 'val', returns -1 if not set
+static int qc_get_attr_number(struct qc_handle *hdl, enum qc_attr_id id, float *val) {
+	float *f;
+	int *i;
+
+	if ((i = qc_get_attr_value_int(hdl, id)) != NULL)
+		*val = *i;
+	else if ((f = qc_get_attr_value_float(hdl, id)) != NULL)
+		*val = *f;
+	else
+		return -1;
+
+	return 0;
+}
+
+// Evaluates all thresholds of 'st' against configuration 'cfg'
+static void qc_stats_eval_thresholds(struct qc_stats *st, struct qc_handle *cfg) {
+	struct qc_stats_threshold *th;
+	const __u64 one = 1;
+	struct qc_handle *hdl;
+	float val, ref;
+	int i, met;
+
+	for (i = 0; i < st->num_thresholds; i++) {
+		th = &st->thresholds[i];
+		if ((hdl = qc_get_layer_handle(cfg, th->thr.layer)) == NULL || qc_get_attr_number(hdl, th->thr.id, &val))
+			continue;
+		if (th->thr.ref_id >= 0) {
+			if (qc_get_attr_number(hdl, th->thr.ref_id, &ref) || ref <= 0)
+				continue;
+			val = val * 100 / ref;
+		}
+		if (th->active)
+			met = th->thr.above ? val >= th->thr.value - th->thr.hysteresis : val <= th->thr.value + th->thr.hysteresis;
+		else
+			met = th->thr.above ? val > th->thr.value : val < th->thr.value;
+		if (met == th->active)
+			continue;
+		th->active = met;
+		qc_debug(cfg, "Threshold %d %s at value %f\n", i, met ? "met" : "cleared", val);
+		if (th->cb)
+			th->cb(&th->thr, met, val, th->data);
+		if (met && th->fd >= 0 && write(th->fd, &one, sizeof(one)) != sizeof(one))
+			qc_debug(cfg, "Warning: Failed to notify fd %d: %s\n", th->fd, strerror(errno));
+	}
+}
+
+int qc_stats_add_threshold(void *stats, const struct qc_threshold *thr, qc_threshold_cb cb, void *data, int fd) {
+	struct qc_stats *st = stats;
+	struct qc_stats_threshold *th;
+
+	if (!st || !thr || thr->layer < 0 || thr->layer >= st->num_layers || !qc_is_attr_id_valid(thr->id) ||
+	    (thr->ref_id != -1 && !qc_is_attr_id_valid(thr->ref_id)) || thr->hysteresis < 0 || (!cb && fd < 0))
+		return -1;
+	th = realloc(st->thresholds, (st->num_thresholds + 1) * sizeof(struct qc_stats_threshold));
+	if (!th)
+		return -2;
+	st->thresholds = th;
+	th += st->num_thresholds;
+	th->thr = *thr;
+	th->cb = cb;
+	th->data = data;
+	th->fd = fd;
+	th->active = 0;
+
+	return st->num_thresholds++;
+}
+
+int qc_stats_update(void *stats, void *cfg) {
+	struct qc_stats *st = stats;
+	struct qc_stats_series *ser;
+	struct qc_handle *hdl;
+	int i, rc = 1, *cons;
+
+	if (!st || qc_verify_hdl(cfg, "qc_stats_update"))
+		return -4;
+	qc_debug(cfg, "qc_stats_update()\n");
+	qc_debug_indent_inc();
+	for (hdl = cfg; hdl; hdl = hdl->next) {
+		if (hdl->layer_no >= st->num_layers || st->layer_types[hdl->layer_no] != *(int *)(hdl->layer) ||
+		    (!hdl->next && hdl->layer_no != st->num_layers - 1)) {
+			qc_debug(cfg, "Layers differ from the statistics, skipping\n");
+			rc = 1;
+			goto out;
+		}
+	}
+	for (hdl = cfg; hdl; hdl = hdl->next) {
+		for (i = 0; i < QC_STATS_NUM_TYPES; i++) {
+			if ((cons = qc_get_attr_value_int(hdl, qc_capacity_ids[i].consumption)) == NULL)
+				continue;
+			ser = &st->series[hdl->layer_no * QC_STATS_NUM_TYPES + i];
+			ser->ring[ser->next] = *cons;
+			ser->next = (ser->next + 1) % st->cfg.window;
+			if (ser->num < st->cfg.window)
+				ser->num++;
+			if (ser->num == 1)
+				ser->ewma = *cons;
+			else
+				ser->ewma = st->cfg.alpha * *cons + (1 - st->cfg.alpha) * ser->ewma;
+			ser->eff = qc_get_attr_int(hdl, qc_capacity_ids[i].effective_capacity, -1);
+			rc = 0;
+		}
+	}
+	qc_stats_eval_thresholds(st, cfg);
+
+out:
+	qc_debug(cfg, "Return rc=%d\n", rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+// Returns the consumption expected 'horizon' samples after the latest one, using a least squares fit
+static double qc_stats_forecast(struct qc_stats *st, struct qc_stats_series *ser) {
+	double x_mean = (ser->num - 1) / 2.0, y_mean = 0, sxx = 0, sxy = 0, x;
+	int i, oldest = (ser->next - ser->num + st->cfg.window) % st->cfg.window;
+
+	for (i = 0; i < ser->num; i++)
+		y_mean += ser->ring[(oldest + i) % st->cfg.window];
+	y_mean /= ser->num;
+	for (i = 0; i < ser->num; i++) {
+		x = i - x_mean;
+		sxx += x * x;
+		sxy += x * (ser->ring[(oldest + i) % st->cfg.window] - y_mean);
+	}
+	if (sxx == 0)
+		return y_mean;
+
+	return y_mean + sxy / sxx * (ser->num - 1 + st->cfg.horizon - x_mean);
+}
+
+int qc_stats_get(void *stats, int layer, enum qc_cpu_types type, enum qc_statistics stat, int *value) {
+	const struct qc_capacity_ids *ids;
+	struct qc_stats *st = stats;
+	struct qc_stats_series *ser;
+	int64_t sum = 0;
+	double val = 0;
+	int i;
+
+	*value = -EINVAL;
+	if (!st || layer < 0 || layer >= st->num_layers || (ids = qc_get_capacity_ids(type)) == NULL ||
+	    stat < QC_STAT_EWMA || stat > QC_STAT_HEADROOM_FORECAST)
+		return -1;
+	ser = &st->series[layer * QC_STATS_NUM_TYPES + (ids - qc_capacity_ids)];
+	if (ser->num == 0)
+		return 0;
+	switch (stat) {
+	case QC_STAT_EWMA:
+		val = ser->ewma;
+		break;
+	case QC_STAT_MEAN:
+		for (i = 0; i < ser->num; i++)
+			sum += ser->ring[i];
+		val = (double)sum / ser->num;
+		break;
+	case QC_STAT_P95:
+		memcpy(st->scratch, ser->ring, ser->num * sizeof(int));
+		// nearest rank
+		val = qc_select_int(st->scratch, ser->num, (ser->num * 95 + 99) / 100 - 1);
+		break;
+	case QC_STAT_MAX:
+		for (i = 0, val = ser->ring[0]; i < ser->num; i++)
+			if (ser->ring[i] > val)
+				val = ser->ring[i];
+		break;
+	case QC_STAT_FORECAST:
+		val = qc_stats_forecast(st, ser);
+		break;
+	case QC_STAT_HEADROOM:
+	case QC_STAT_HEADROOM_FORECAST:
+		if (ser->eff < 0)
+			return 0;
+		val = ser->eff - (stat == QC_STAT_HEADROOM ? ser->ewma : qc_stats_forecast(st, ser));
+		break;
+	}
+	if (val < 0)
+		val = 0;
+	*value = val + 0.5;
+
+	return 1;
+}
+
+int qc_get_num_rows(void *cfg, enum qc_table_id table, int layer, int *rc) {
+	struct qc_handle *hdl;
+	struct qc_table *tbl;
+	int num = 0;
+
+	if (qc_verify_hdl(cfg, "qc_get_num_rows")) {
+		*rc = -4;
+		return 0;
+	}
+	hdl = qc_get_layer_handle(cfg, layer);
+	qc_debug(cfg, "qc_get_num_rows(table=%d, layer=%d)\n", table, layer);
+	qc_debug_indent_inc();
+	if (!hdl) {
+		*rc = -1;
+		goto out;
+	}
+	if (!qc_is_table_id_valid(table)) {
+		*rc = -2;
+		goto out;
+	}
+	if ((tbl = qc_get_table(hdl, table)) == NULL) {
+		qc_debug(cfg, "Table '%s' not defined\n", qc_table_id_to_char(cfg, table));
+		*rc = 0;
+		goto out;
+	}
+	num = tbl->num_rows;
+	*rc = 1;
+
+out:
+	qc_debug(cfg, "Return %d rows, rc=%d\n", num, *rc);
+	qc_debug_indent_dec();
+
+	return num;
+}
+
+int qc_get_row_by_name(void *cfg, enum qc_table_id table, int layer, const char *name, int *rc) {
+	struct qc_handle *hdl;
+	struct qc_table *tbl;
+	int row = -1;
+
+	if (qc_verify_hdl(cfg, "qc_get_row_by_name")) {
+		*rc = -4;
+		return -1;
+	}
+	hdl = qc_get_layer_handle(cfg, layer);
+	qc_debug(cfg, "qc_get_row_by_name(table=%d, layer=%d, name=%s)\n", table, layer, name ? name : "NULL");
+	qc_debug_indent_inc();
+	if (!hdl) {
+		*rc = -1;
+		goto out;
+	}
+	if (!qc_is_table_id_valid(table)) {
+		*rc = -2;
+		goto out;
+	}
+	if (!name) {
+		*rc = -3;
+		goto out;
+	}
+	if ((tbl = qc_get_table(hdl, table)) == NULL) {
+		qc_debug(cfg, "Table '%s' not defined\n", qc_table_id_to_char(cfg, table));
+		*rc = 0;
+		goto out;
+	}
+	row = qc_find_row_string(tbl, qc_layer_name, name);
+	*rc = row >= 0;
+
+out:
+	qc_debug(cfg, "Return row %d, rc=%d\n", row, *rc);
+	qc_debug_indent_dec();
+
+	return row;
+}
+
+// Returns >0 and the table in 'tbl' if 'row' of 'table' in 'layer' exists, or the
+// return code for the qc_get_row_attribute_*() calls otherwise
+static int qc_get_table_row(void *cfg, enum qc_table_id table, enum qc_attr_id id, int layer, int row,
+			    struct qc_table **tbl) {
+	struct qc_handle *hdl;
+
+	*tbl = NULL;
+	if ((hdl = qc_get_layer_handle(cfg, layer)) == NULL)
+		return -1;
+	if (!qc_is_table_id_valid(table) || !qc_is_attr_id_valid(id))
+		return -2;
+	if ((*tbl = qc_get_table(hdl, table)) == NULL) {
+		qc_debug(cfg, "Table '%s' not defined\n", qc_table_id_to_char(cfg, table));
+		return 0;
+	}
+	if (row < 0 || row >= (*tbl)->num_rows) {
+		qc_debug(cfg, "Error: Row %d out of range\n", row);
+		return -5;
+	}
+
+	return 1;
+}
+
+int qc_get_row_attribute_int(void *cfg, enum qc_table_id table, enum qc_attr_id id, int layer, int row, int *value) {
+	struct qc_table *tbl;
+	int rc, *ptr;
+
+	*value = -EINVAL;
+	if (qc_verify_hdl(cfg, "qc_get_row_attribute_int"))
+		return -4;
+	qc_debug(cfg, "qc_get_row_attribute_int(table=%d, attr=%d, layer=%d, row=%d)\n", table, id, layer, row);
+	qc_debug_indent_inc();
+	if ((rc = qc_get_table_row(cfg, table, id, layer, row, &tbl)) <= 0)
+		goto out;
+	if ((ptr = qc_get_row_attr_value_int(tbl, row, id)) == NULL) {
+		qc_debug(cfg, "Attr '%s' not defined\n", qc_attr_id_to_char(cfg, id));
+		rc = 0;
+		goto out;
+	}
+	*value = *ptr;
+
+out:
+	qc_debug(cfg, "Return value=%d, rc=%d\n", *value, rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+int qc_get_row_attribute_int64(void *cfg, enum qc_table_id table, enum qc_attr_id id, int layer, int row, int64_t *value) {
+	struct qc_table *tbl;
+	int64_t *ptr;
+	int rc;
+
+	*value = -EINVAL;
+	if (qc_verify_hdl(cfg, "qc_get_row_attribute_int64"))
+		return -4;
+	qc_debug(cfg, "qc_get_row_attribute_int64(table=%d, attr=%d, layer=%d, row=%d)\n", table, id, layer, row);
+	qc_debug_indent_inc();
+	if ((rc = qc_get_table_row(cfg, table, id, layer, row, &tbl)) <= 0)
+		goto out;
+	if ((ptr = qc_get_row_attr_value_int64(tbl, row, id)) == NULL) {
+		qc_debug(cfg, "Attr '%s' not defined\n", qc_attr_id_to_char(cfg, id));
+		rc = 0;
+		goto out;
+	}
+	*value = *ptr;
+
+out:
+	qc_debug(cfg, "Return value=%" PRId64 ", rc=%d\n", *value, rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+int qc_get_row_attribute_float(void *cfg, enum qc_table_id table, enum qc_attr_id id, int layer, int row, float *value) {
+	struct qc_table *tbl;
+	float *ptr;
+	int rc;
+
+	*value = -EINVAL;
+	if (qc_verify_hdl(cfg, "qc_get_row_attribute_float"))
+		return -4;
+	qc_debug(cfg, "qc_get_row_attribute_float(table=%d, attr=%d, layer=%d, row=%d)\n", table, id, layer, row);
+	qc_debug_indent_inc();
+	if ((rc = qc_get_table_row(cfg, table, id, layer, row, &tbl)) <= 0)
+		goto out;
+	if ((ptr = qc_get_row_attr_value_float(tbl, row, id)) == NULL) {
+		qc_debug(cfg, "Attr '%s' not defined\n", qc_attr_id_to_char(cfg, id));
+		rc = 0;
+		goto out;
+	}
+	*value = *ptr;
+
+out:
+	qc_debug(cfg, "Return value=%f, rc=%d\n", *value, rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+int qc_get_row_attribute_string(void *cfg, enum qc_table_id table, enum qc_attr_id id, int layer, int row, const char **value) {
+	struct qc_table *tbl;
+	int rc;
+
+	*value = NULL;
+	if (qc_verify_hdl(cfg, "qc_get_row_attribute_string"))
+		return -4;
+	qc_debug(cfg, "qc_get_row_attribute_string(table=%d, attr=%d, layer=%d, row=%d)\n", table, id, layer, row);
+	qc_debug_indent_inc();
+	if ((rc = qc_get_table_row(cfg, table, id, layer, row, &tbl)) <= 0)
+		goto out;
+	if ((*value = qc_get_row_attr_value_string(tbl, row, id)) == NULL) {
+		qc_debug(cfg, "Attr '%s' not defined\n", qc_attr_id_to_char(cfg, id));
+		rc = 0;
+	}
+
+out:
+	qc_debug(cfg, "Return value='%s', rc=%d\n", *value, rc);
+	qc_debug_indent_dec();
+
+	return rc;
+}
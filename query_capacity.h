@@ -5,12 +5,22 @@
 #ifndef QUERY_CAPACITY
 #define QUERY_CAPACITY
 
+#include <stddef.h>
+#include <stdint.h>
+
 
 /* Build Customization */
 #define CONFIG_DEBUG_TIMESTAMPS		// Print timestamps in log
 #define CONFIG_V1_COMPATIBILITY		// Support functionality deprecated in v1.x
 //#define CONFIG_TEXTUAL_HYPFS		// Use data from textual hypfs if available
 
+/** Capability rating of a core that provides one normalized capacity unit, see #qc_normalized_capacity */
+#define QC_CAPABILITY_REFERENCE		1000
+/** Default capacity of a core running with SMT relative to the same core running single-threaded, see
+    #qc_cp_core_equivalent_capacity. Only applies to cores running more than one thread. Use environment
+    variable \c QC_SMT_YIELD to override, see qc_open() */
+#define QC_SMT_YIELD			1.3
+
 /** \enum qc_attr_id
  * Defines the attributes retrievable by the API. Attributes can
  * exist for multiple layers. Also, attributes will only be valid if retrieved
@@ -26,6 +36,12 @@
  *            \c /sys/hypervisor/s390).
  *            Proper file access privileges required.
  *   - **h**: See H, but provided by \c debugfs exclusively.
+ *   - **p**: Provided by \c /proc/stat.
+ *   - **k**: Provided by the KVM guests' cgroups in \c /sys/fs/cgroup/machine.slice and their
+ *            qemu processes, as set up by libvirt.
+ *   - **t**: Provided by the CPU topology in \c /sys/devices/system/cpu.
+ *   - **m**: Provided by \c /proc/meminfo and the memory controller of the calling process'
+ *            control group in \c /sys/fs/cgroup, as listed in \c /proc/self/cgroup.
  *   - **V**: Provided by the STHYI instruction.
  *            - <i>z/VM Linux guests</i>: Requires z/VM 6.3 with APAR VM65419 or higher.
  *              UM34746 for z/VM 6.3.0 APAR VM65716 is required for LPAR groups support
@@ -101,12 +117,35 @@
  * #qc_num_ifl_total                   | int  |<CODE>&nbsp;HV</CODE>| Equals the sum of #qc_num_ifl_dedicated and #qc_num_ifl_shared<br>Reported in unit of cores<br><b>Note</b>: \b [4]
  * #qc_num_ifl_dedicated               | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
  * #qc_num_ifl_shared                  | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_num_ziip_total                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Equals the sum of #qc_num_ziip_dedicated and #qc_num_ziip_shared<br>Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_num_ziip_dedicated              | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_num_ziip_shared                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_num_icf_total                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Equals the sum of #qc_num_icf_dedicated and #qc_num_icf_shared<br>Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_num_icf_dedicated               | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_num_icf_shared                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
  * #qc_num_cp_threads                  | int  |<CODE>S&nbsp;&nbsp;</CODE>| Number of threads/CPUs per CP core that the CEC is capable of<br><b>Note</b>: Requires Linux kernel 4.4 or higher
  * #qc_num_ifl_threads                 | int  |<CODE>S&nbsp;&nbsp;</CODE>| Number of threads/CPUs per IFL core that the CEC is capable of<br><b>Note</b>: Requires Linux kernel 4.4 or higher
  * #qc_capability                      | float|<CODE>S&nbsp;&nbsp;</CODE>| \n
  * #qc_secondary_capability            | float|<CODE>S&nbsp;&nbsp;</CODE>| \n
  * #qc_capacity_adjustment_indication  | int  |<CODE>S&nbsp;&nbsp;</CODE>| \n
  * #qc_capacity_change_reason          | int  |<CODE>S&nbsp;&nbsp;</CODE>| \n
+ * #qc_cp_utilization                  | float|<CODE>&nbsp;h&nbsp;</CODE>| Utilization of the shared physical CPs<br><b>Note</b>: \b [4], \b [6]
+ * #qc_cp_consumption                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Capacity of the shared physical CPs in use, reported in unit of cores<br><b>Note</b>: \b [4], \b [6]
+ * #qc_ifl_utilization                 | float|<CODE>&nbsp;h&nbsp;</CODE>| Utilization of the shared physical IFLs<br><b>Note</b>: \b [4], \b [6]
+ * #qc_ifl_consumption                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Capacity of the shared physical IFLs in use, reported in unit of cores<br><b>Note</b>: \b [4], \b [6]
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
  *
  * Attributes for LPAR Groups          | Type | Src | Comment
  * ------------------------------------|------|-----|-------------------------------------
@@ -117,6 +156,29 @@
  * #qc_layer_name                      |string|<CODE>&nbsp;hV</CODE>| Name of LPAR group
  * #qc_cp_absolute_capping             | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores
  * #qc_ifl_absolute_capping            | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores
+ * #qc_num_cp_total                    | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of all member LPARs, see #qc_table_lpars<br><b>Note</b>: \b [4]
+ * #qc_num_cp_shared                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of all member LPARs<br><b>Note</b>: \b [4]
+ * #qc_num_ifl_total                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of all member LPARs<br><b>Note</b>: \b [4]
+ * #qc_num_ifl_shared                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of all member LPARs<br><b>Note</b>: \b [4]
+ * #qc_cp_weight                       | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of all member LPARs<br><b>Note</b>: \b [4]
+ * #qc_ifl_weight                      | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of all member LPARs<br><b>Note</b>: \b [4]
+ * #qc_cp_consumption                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Capacity of the CPs in use by all member LPARs, reported in unit of cores<br><b>Note</b>: \b [4], \b [6]
+ * #qc_cp_utilization                  | float|<CODE>&nbsp;h&nbsp;</CODE>| Share of #qc_cp_absolute_capping in use, only set if capped<br><b>Note</b>: \b [4], \b [6]
+ * #qc_ifl_consumption                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Capacity of the IFLs in use by all member LPARs, reported in unit of cores<br><b>Note</b>: \b [4], \b [6]
+ * #qc_ifl_utilization                 | float|<CODE>&nbsp;h&nbsp;</CODE>| Share of #qc_ifl_absolute_capping in use, only set if capped<br><b>Note</b>: \b [4], \b [6]
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
  *
  * Attributes for LPARs                | Type | Src | Comment
  * ------------------------------------|------|-----|-------------------------------------
@@ -143,12 +205,50 @@
  * #qc_num_ifl_total                   | int  |<CODE>&nbsp;HV</CODE>| Sum of #qc_num_ifl_dedicated and #qc_num_ifl_shared. Considers configured IFLs only.<br>Reported in unit of cores
  * #qc_num_ifl_dedicated               | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores
  * #qc_num_ifl_shared                  | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores
+ * #qc_num_ziip_total                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of #qc_num_ziip_dedicated and #qc_num_ziip_shared. Considers configured zIIPs only.<br>Reported in unit of cores
+ * #qc_num_ziip_dedicated              | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_ziip_shared                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_icf_total                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Sum of #qc_num_icf_dedicated and #qc_num_icf_shared. Considers configured ICFs only.<br>Reported in unit of cores
+ * #qc_num_icf_dedicated               | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_icf_shared                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
  * #qc_num_cp_threads                  | int  |<CODE>S&nbsp;&nbsp;</CODE>| Number of threads/CPUs per CP core configured for this LPAR<br><b>Note</b>: Requires Linux kernel 4.3 or higher
  * #qc_num_ifl_threads                 | int  |<CODE>S&nbsp;&nbsp;</CODE>| Number of threads/CPUs per IFL core configured for this LPAR<br><b>Note</b>: Requires Linux kernel 4.3 or higher
  * #qc_cp_absolute_capping             | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores
  * #qc_cp_weight_capping               | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
  * #qc_ifl_absolute_capping            | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores
  * #qc_ifl_weight_capping              | int  |<CODE>&nbsp;hV</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_ziip_absolute_capping           | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_ziip_weight_capping             | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_icf_absolute_capping            | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_icf_weight_capping              | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_cp_utilization                  | float|<CODE>&nbsp;h&nbsp;</CODE>| <b>Note</b>: \b [6]
+ * #qc_cp_consumption                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [6]
+ * #qc_ifl_utilization                 | float|<CODE>&nbsp;h&nbsp;</CODE>| <b>Note</b>: \b [6]
+ * #qc_ifl_consumption                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: \b [6]
+ * #qc_overcommit                      | float|<CODE>&nbsp;k&nbsp;</CODE>| <b>Note</b>: \b [7]
+ * #qc_num_cpu_horizontal              | int  |<CODE>&nbsp;t&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: \b [8]
+ * #qc_num_cpu_vertical_low            | int  |<CODE>&nbsp;t&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: \b [8]
+ * #qc_num_cpu_vertical_medium         | int  |<CODE>&nbsp;t&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: \b [8]
+ * #qc_num_cpu_vertical_high           | int  |<CODE>&nbsp;t&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: \b [8]
+ * #qc_num_drawers                     | int  |<CODE>&nbsp;t&nbsp;</CODE>| <b>Note</b>: \b [8]
+ * #qc_num_core_per_drawer             | int  |<CODE>&nbsp;t&nbsp;</CODE>| Largest number of cores within a single drawer<br><b>Note</b>: \b [8]
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_mem_total                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_limit                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_effective                   |int64 |     | <b>Note</b>: \b [13]
+ * #qc_mem_limiting_layer              | int  |     | <b>Note</b>: \b [13]
  *
  *
  * Attributes for z/VM hypervisors     | Type | Src | Comment
@@ -174,6 +274,19 @@
  * #qc_num_ifl_shared                  | int  |<CODE>&nbsp;&nbsp;V</CODE>| Reported in unit of cores unless run as a guest of another hypervisor other than LPAR
  * #qc_num_cp_threads                  | int  |<CODE>&nbsp;&nbsp;V</CODE>| Number of threads/CPUs per CP core in use
  * #qc_num_ifl_threads                 | int  |<CODE>&nbsp;&nbsp;V</CODE>| Number of threads/CPUs per IFL core in use
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
  *
  *
  * Attributes for z/VM resource pools  | Type | Src | Comment
@@ -189,6 +302,19 @@
  * #qc_ifl_limithard_cap               | int  |<CODE>&nbsp;&nbsp;V</CODE>| \n
  * #qc_ifl_capacity_cap                | int  |<CODE>&nbsp;&nbsp;V</CODE>| \n
  * #qc_ifl_capped_capacity             | int  |<CODE>&nbsp;&nbsp;V</CODE>| Reported in unit of cores unless run as a guest of another hypervisor other than LPAR
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
  *
  *
  * Attributes for z/VM guests          | Type | Src | Comment
@@ -220,6 +346,31 @@
  * #qc_ifl_dispatch_limithard          | int  |<CODE>&nbsp;&nbsp;V</CODE>| \n
  * #qc_ifl_dispatch_type               | int  |<CODE>&nbsp;&nbsp;V</CODE>| Only set in presence of IFLs
  * #qc_ifl_capped_capacity             | int  |<CODE>&nbsp;&nbsp;V</CODE>| Reported in unit of cores unless run as a guest of another hypervisor other than LPAR
+ * #qc_cpu_consumption                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: \b [6]
+ * #qc_cpu_delay                       | float|<CODE>&nbsp;h&nbsp;</CODE>| <b>Note</b>: \b [6]
+ * #qc_page_wait                       | float|<CODE>&nbsp;h&nbsp;</CODE>| <b>Note</b>: \b [6]
+ * #qc_overcommit                      | float|<CODE>&nbsp;k&nbsp;</CODE>| <b>Note</b>: \b [7]
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Dedicated CPs plus the guest's entitlement as listed in #qc_table_zvm_guests, limited by the capacity of the resource pool<br>Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Dedicated IFLs plus the guest's entitlement as listed in #qc_table_zvm_guests, limited by the capacity of the resource pool<br>Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_mem_min                         |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Row of the guest itself in #qc_table_zvm_guests
+ * #qc_mem_max                         |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Row of the guest itself in #qc_table_zvm_guests
+ * #qc_mem_share                       |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Row of the guest itself in #qc_table_zvm_guests
+ * #qc_mem_used                        |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Row of the guest itself in #qc_table_zvm_guests
+ * #qc_mem_total                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_limit                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_effective                   |int64 |     | <b>Note</b>: \b [13]
+ * #qc_mem_limiting_layer              | int  |     | <b>Note</b>: \b [13]
  *
  *
  * Attributes for KVM hypervisors      | Type | Src | Comment
@@ -239,6 +390,23 @@
  * #qc_num_ifl_total                   | int  |<CODE>SHV</CODE>| Sum of #qc_num_ifl_dedicated and #qc_num_ifl_shared<br>Reported in unit of cores unless run as a guest of another hypervisor other than LPAR
  * #qc_num_ifl_dedicated               | int  |<CODE>ShV</CODE>| Reported in unit of cores unless run as a guest of another hypervisor other than LPAR
  * #qc_num_ifl_shared                  | int  |<CODE>ShV</CODE>| Reported in unit of cores unless run as a guest of another hypervisor other than LPAR
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_mem_total                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_limit                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_effective                   |int64 |     | <b>Note</b>: \b [13]
+ * #qc_mem_limiting_layer              | int  |     | <b>Note</b>: \b [13]
  *
  *
  * Attributes for KVM guests           | Type | Src | Comment
@@ -260,6 +428,26 @@
  * #qc_num_ifl_dedicated               | int  |<CODE>S&nbsp;&nbsp;</CODE>| Reported in unit of CPUs
  * #qc_num_ifl_shared                  | int  |<CODE>S&nbsp;&nbsp;</CODE>| Reported in unit of CPUs
  * #qc_ifl_dispatch_type               | int  |<CODE>SHV</CODE>| \n
+ * #qc_utilization                     | float|<CODE>&nbsp;p&nbsp;</CODE>| Average utilization of the virtual CPUs<br><b>Note</b>: \b [6]
+ * #qc_cpu_consumption                 | int  |<CODE>&nbsp;p&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: \b [6]
+ * #qc_steal                           | float|<CODE>&nbsp;p&nbsp;</CODE>| Average steal time of the virtual CPUs<br><b>Note</b>: \b [6]
+ * #qc_cp_effective_capacity           | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_guaranteed_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_cp_limiting_layer               | int  |     | <b>Note</b>: \b [9]
+ * #qc_ifl_effective_capacity          | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_guaranteed_capacity         | int  |     | Reported in unit of cores<br><b>Note</b>: \b [9]
+ * #qc_ifl_limiting_layer              | int  |     | <b>Note</b>: \b [9]
+ * #qc_cp_normalized_capacity          | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_ifl_normalized_capacity         | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_normalized_capacity             | float|     | <b>Note</b>: \b [9], \b [10]
+ * #qc_cp_core_equivalent_capacity     | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_core_equivalent_capacity    | float|     | Reported in unit of cores<br><b>Note</b>: \b [9], \b [11]
+ * #qc_cp_thread_equivalent_capacity   | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_ifl_thread_equivalent_capacity  | float|     | Reported in unit of CPUs, i.e. threads in case of SMT<br><b>Note</b>: \b [9], \b [11]
+ * #qc_mem_total                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_limit                       |int64 |<CODE>&nbsp;m&nbsp;</CODE>| <b>Note</b>: \b [12]
+ * #qc_mem_effective                   |int64 |     | <b>Note</b>: \b [13]
+ * #qc_mem_limiting_layer              | int  |     | <b>Note</b>: \b [13]
  *
  * \b [1] Available starting with RHEL7.2 and SLES12SP1<br>
  * \b [2] <I>z/Architecture Principles of Operation</I>, SA22-7832<br>
@@ -267,7 +455,17 @@
  * \b [4] Requires global performance data to be enabled in the LPAR's activation profile<br>
  * \b [5] As of this writing, in LPARs with both CPs and IFLs defined in its activation profile, only CPs can become operational.
  *        Therefore, IFL counts would not appear in any of #qc_num_core_configured, #qc_num_core_standby, #qc_num_core_reserved,
- *        #qc_num_core_dedicated or #qc_num_core_shared
+ *        #qc_num_core_dedicated or #qc_num_core_shared<br>
+ * \b [6] Only set after a call to qc_compute_utilization()<br>
+ * \b [7] Only set in the highest layer if it runs a KVM hypervisor, see #qc_table_kvm_guests<br>
+ * \b [8] Only set if the LPAR is the highest layer, considers online CPUs only, see #qc_table_topology<br>
+ * \b [9] Derived from this and all lower layers after all data sources were processed, see #qc_cp_effective_capacity
+ *        and #qc_cp_guaranteed_capacity<br>
+ * \b [10] Requires #qc_capability in the CEC layer, see #qc_normalized_capacity<br>
+ * \b [11] Considers SMT as in effect for the CPUs of the layer, with #QC_SMT_YIELD applying only to cores running more
+ *        than one thread, see #qc_cp_core_equivalent_capacity and #qc_cp_thread_equivalent_capacity<br>
+ * \b [12] Only set in the highest layer<br>
+ * \b [13] Derived from this and all lower layers after all data sources were processed, see #qc_mem_effective
  */
 enum qc_layer_types {
 	/** CEC */
@@ -321,6 +519,117 @@ enum qc_cappings {
 	QC_CAPPING_HARD = 2,
 };
 
+/** \enum qc_cpu_types
+ * Numeric representation of CPU types, see #qc_cpu_type_num. */
+enum qc_cpu_types {
+	/** General purpose processor */
+	QC_CPU_TYPE_CP = 0,
+	/** z Application Assist Processor */
+	QC_CPU_TYPE_ZAAP = 2,
+	/** Integrated Facility for Linux */
+	QC_CPU_TYPE_IFL = 3,
+	/** Internal Coupling Facility */
+	QC_CPU_TYPE_ICF = 4,
+	/** z Integrated Information Processor */
+	QC_CPU_TYPE_ZIIP = 5,
+};
+
+/** \enum qc_polarizations
+ * Numeric representation of the polarization of a CPU, see #qc_polarization_num. */
+enum qc_polarizations {
+	/** CPU capacity is spread evenly across all CPUs */
+	QC_POLARIZATION_HORIZONTAL = 0,
+	/** CPU is not entitled to capacity, and runs on capacity unused by other LPARs only */
+	QC_POLARIZATION_VERTICAL_LOW = 1,
+	/** CPU is entitled to a share of a core */
+	QC_POLARIZATION_VERTICAL_MEDIUM = 2,
+	/** CPU is entitled to a full core */
+	QC_POLARIZATION_VERTICAL_HIGH = 3,
+};
+
+/** \enum qc_parallelism_policies
+ * Policies for qc_recommend_parallelism(). */
+enum qc_parallelism_policies {
+	/** Use all capacity that can be consumed: All visible CPUs up to the effective capacity, or all
+	    visible CPUs if capped softly only */
+	QC_PARALLELISM_THROUGHPUT = 0,
+	/** Avoid queueing behind cappings and SMT siblings: One worker per core of effective capacity */
+	QC_PARALLELISM_LATENCY = 1,
+	/** Use the capacity that is guaranteed even if all other guests compete for the shared CPUs:
+	    One worker per CPU of guaranteed capacity, i.e. considering all threads of the guaranteed cores, falling
+	    back to QC_PARALLELISM_LATENCY if unknown */
+	QC_PARALLELISM_CONSERVATIVE = 2,
+};
+
+/** \enum qc_statistics
+ * Statistics of the CP or IFL consumption of a layer as retrieved by qc_stats_get(). */
+enum qc_statistics {
+	/** Exponentially weighted moving average, see qc_stats_config::alpha */
+	QC_STAT_EWMA = 0,
+	/** Mean of the samples in the sliding window */
+	QC_STAT_MEAN = 1,
+	/** 95th percentile of the samples in the sliding window */
+	QC_STAT_P95 = 2,
+	/** Maximum of the samples in the sliding window */
+	QC_STAT_MAX = 3,
+	/** Consumption expected qc_stats_config::horizon samples ahead, following the linear trend of the
+	    samples in the sliding window */
+	QC_STAT_FORECAST = 4,
+	/** Smoothed available capacity: Effective capacity (see #qc_cp_effective_capacity) of the latest sample
+	    minus #QC_STAT_EWMA, or 0 if exhausted */
+	QC_STAT_HEADROOM = 5,
+	/** Available capacity expected qc_stats_config::horizon samples ahead: Effective capacity of the latest
+	    sample minus #QC_STAT_FORECAST, or 0 if exhausted */
+	QC_STAT_HEADROOM_FORECAST = 6,
+};
+
+/** \enum qc_source_types
+ * Types of source data that can be passed to qc_open_from_buffers(). */
+enum qc_source_types {
+	/** Content of \c /proc/sysinfo (mandatory) */
+	QC_SOURCE_SYSINFO = 1,
+	/** Content of \c /sys/firmware/ocf/cpc_name */
+	QC_SOURCE_OCF_CPC_NAME = 2,
+	/** Content of file \c s390_hypfs/diag_204 in \c debugfs (LPAR) */
+	QC_SOURCE_HYPFS_DIAG_204 = 3,
+	/** Content of file \c s390_hypfs/diag_2fc in \c debugfs (z/VM) */
+	QC_SOURCE_HYPFS_DIAG_2FC = 4,
+	/** Response buffer of the \c STHYI instruction */
+	QC_SOURCE_STHYI = 5,
+	/** Content of \c /proc/stat (KVM guests) */
+	QC_SOURCE_PROC_STAT = 6,
+	/** KVM guests of a KVM host, one line per guest: Number of virtual CPUs, CPU time and time
+	    since start of the guest in microseconds, and guest name, separated by blanks (KVM hosts) */
+	QC_SOURCE_KVM_GUESTS = 7,
+	/** Topology of the online CPUs, one line per CPU: CPU number, content of
+	    \c /sys/devices/system/cpu/cpuN/polarization, drawer, book, socket and core id (or -1 if
+	    not available), separated by blanks (LPAR) */
+	QC_SOURCE_TOPOLOGY = 8,
+	/** Memory of the calling process, one line: \c MemTotal as in \c /proc/meminfo and the memory
+	    limit of its control group (or \c max if not limited), in KB, separated by a blank */
+	QC_SOURCE_MEMORY = 9,
+};
+
+/** Source data as passed to qc_open_from_buffers() */
+struct qc_source_buffer {
+	/** Type of the data, see #qc_source_types */
+	int		 type;
+	/** Data in the exact format as provided by the respective source, e.g. as found in a dump */
+	const void	*data;
+	/** Length of \p data in bytes */
+	size_t		 len;
+};
+
+/** Settings of the statistics as passed to qc_stats_open() */
+struct qc_stats_config {
+	/** Number of samples in the sliding window, 1 or higher */
+	int		 window;
+	/** Weight of the latest sample in the exponentially weighted moving average, greater than 0 and up to 1 */
+	float		 alpha;
+	/** Number of samples ahead to forecast, 0 or higher */
+	int		 horizon;
+};
+
 /** \enum qc_attr_id */
 enum qc_attr_id {
 	/** The adjustment factor indicates the maximum percentage of the machine (in parts of 1000) that could be
@@ -456,6 +765,339 @@ enum qc_attr_id {
 	qc_num_core_dedicated = 61,
 	/** Sum of shared CP and IFL cores in layer */
 	qc_num_core_shared = 62,
+	/** Utilization of the layer's CPs in percent, where 100 means that all CPs were busy all the time */
+	qc_cp_utilization = 63,
+	/** Utilization of the layer's IFLs in percent, where 100 means that all IFLs were busy all the time */
+	qc_ifl_utilization = 64,
+	/** CP capacity consumed by the layer -- scaled value where 0x10000 equals to one core */
+	qc_cp_consumption = 65,
+	/** IFL capacity consumed by the layer -- scaled value where 0x10000 equals to one core */
+	qc_ifl_consumption = 66,
+	/** CPU address */
+	qc_cpu_address = 67,
+	/** CPU type: \c "CP", \c "zAAP", \c "IFL", \c "ICF" or \c "zIIP", see enum #qc_cpu_types */
+	qc_cpu_type = 68,
+	/** Numeric representation of CPU type, see enum #qc_cpu_types */
+	qc_cpu_type_num = 69,
+	/** 1 if dedicated,<BR> 0 if shared */
+	qc_dedicated = 70,
+	/** Accumulated time in microseconds during which a physical CPU was assigned to the CPU */
+	qc_cpu_time = 71,
+	/** Accumulated time in microseconds consumed by the hypervisor to manage the CPU */
+	qc_mgmt_time = 72,
+	/** Accumulated time in microseconds during which the CPU was online */
+	qc_online_time = 73,
+	/** Utilization in percent */
+	qc_utilization = 74,
+	/** Name of the LPAR group */
+	qc_lpar_group_name = 75,
+	/** Weight of the shared CPs */
+	qc_cp_weight = 76,
+	/** Weight of the shared IFLs */
+	qc_ifl_weight = 77,
+	/** Absolute capping of the CPs of the LPAR group -- scaled value where 0x10000 equals to one core */
+	qc_cp_group_capping = 78,
+	/** Absolute capping of the IFLs of the LPAR group -- scaled value where 0x10000 equals to one core */
+	qc_ifl_group_capping = 79,
+	/** Maximum CPU share of a z/VM guest as defined by \c SET \c SHARE, see \c #qc_capping */
+	qc_cpu_max = 80,
+	/** Relative CPU share of a z/VM guest as defined by \c SET \c SHARE */
+	qc_cpu_shares = 81,
+	/** Minimum memory in KB */
+	qc_mem_min = 82,
+	/** Maximum memory in KB */
+	qc_mem_max = 83,
+	/** Memory share in KB */
+	qc_mem_share = 84,
+	/** Memory in use in KB */
+	qc_mem_used = 85,
+	/** Capacity in use -- scaled value where 0x10000 equals to one CPU */
+	qc_cpu_consumption = 86,
+	/** Share of the samples in percent where the guest was ready to run, but waited for a CPU */
+	qc_cpu_delay = 87,
+	/** Share of the samples in percent where the guest waited for a page to be brought in */
+	qc_page_wait = 88,
+	/** Number of samples where the guest was running */
+	qc_cpu_use_samples = 89,
+	/** Number of samples where the guest was ready to run, but waited for a CPU */
+	qc_cpu_delay_samples = 90,
+	/** Number of samples where the guest waited for a page to be brought in */
+	qc_page_wait_samples = 91,
+	/** Number of samples where the guest was idle */
+	qc_idle_samples = 92,
+	/** Number of samples where the guest was in any other state */
+	qc_other_samples = 93,
+	/** Total number of samples taken */
+	qc_total_samples = 94,
+	/** Accumulated time in microseconds during which the CPU was runnable, but not dispatched by
+	    the hypervisor */
+	qc_steal_time = 95,
+	/** Share of the time in percent that the CPU was runnable, but not dispatched by the hypervisor */
+	qc_steal = 96,
+	/** Ratio of the virtual CPUs of the KVM guests to the shared cores of the KVM host */
+	qc_overcommit = 97,
+	/** Accumulated time in microseconds that the CPs were dispatched */
+	qc_cp_time = 98,
+	/** Accumulated time in microseconds that the IFLs were dispatched */
+	qc_ifl_time = 99,
+	/** Sum of all zIIPs (z Integrated Information Processors) in layer */
+	qc_num_ziip_total = 100,
+	/** Sum of dedicated zIIPs in layer */
+	qc_num_ziip_dedicated = 101,
+	/** Sum of shared zIIPs in layer */
+	qc_num_ziip_shared = 102,
+	/** Sum of all ICFs (Internal Coupling Facilities) in layer */
+	qc_num_icf_total = 103,
+	/** Sum of dedicated ICFs in layer */
+	qc_num_icf_dedicated = 104,
+	/** Sum of shared ICFs in layer */
+	qc_num_icf_shared = 105,
+	/** zIIP absolute capping value -- scaled value where 0x10000 equals to one core, or 0 if no capping set */
+	qc_ziip_absolute_capping = 106,
+	/** ICF absolute capping value -- scaled value where 0x10000 equals to one core, or 0 if no capping set */
+	qc_icf_absolute_capping = 107,
+	/** zIIP weight-based capping value -- scaled value where 0x10000 equals to one core, or 0 if no capping set */
+	qc_ziip_weight_capping = 108,
+	/** ICF weight-based capping value -- scaled value where 0x10000 equals to one core, or 0 if no capping set */
+	qc_icf_weight_capping = 109,
+	/** Weight of the shared zIIPs */
+	qc_ziip_weight = 110,
+	/** Weight of the shared ICFs */
+	qc_icf_weight = 111,
+	/** Polarization of the CPU as reported by Linux, e.g. \c "vertical:high" */
+	qc_polarization = 112,
+	/** Numeric representation of the polarization, see #qc_polarizations */
+	qc_polarization_num = 113,
+	/** Id of the drawer that the CPU resides in */
+	qc_drawer_id = 114,
+	/** Id of the book that the CPU resides in */
+	qc_book_id = 115,
+	/** Id of the socket that the CPU resides in */
+	qc_socket_id = 116,
+	/** Id of the core that the CPU runs on, which is shared by the CPUs of a core with SMT */
+	qc_core_id = 117,
+	/** Number of CPUs with horizontal polarization */
+	qc_num_cpu_horizontal = 118,
+	/** Number of CPUs with vertical low polarization, i.e. without entitlement */
+	qc_num_cpu_vertical_low = 119,
+	/** Number of CPUs with vertical medium polarization */
+	qc_num_cpu_vertical_medium = 120,
+	/** Number of CPUs with vertical high polarization */
+	qc_num_cpu_vertical_high = 121,
+	/** Number of drawers in use */
+	qc_num_drawers = 122,
+	/** Number of cores per drawer */
+	qc_num_core_per_drawer = 123,
+	/** Upper limit of the CP capacity available to the layer, considering the CP counts, SMT, and all cappings of the
+	    layer and all layers below -- scaled value where 0x10000 equals to one core */
+	qc_cp_effective_capacity = 124,
+	/** Upper limit of the IFL capacity available to the layer, considering the IFL counts, SMT, and all cappings of
+	    the layer and all layers below -- scaled value where 0x10000 equals to one core */
+	qc_ifl_effective_capacity = 125,
+	/** CP capacity that the layer is entitled to in any case, i.e. its dedicated CPs plus the share of the shared
+	    CPs as defined by its weight or z/VM share, limited by #qc_cp_effective_capacity and the layers below. Only set
+	    if the entitlement can be determined. Scaled value where 0x10000 equals to one core */
+	qc_cp_guaranteed_capacity = 126,
+	/** IFL capacity that the layer is entitled to in any case, i.e. its dedicated IFLs plus the share of the shared
+	    IFLs as defined by its weight or z/VM share, limited by #qc_ifl_effective_capacity and the layers below. Only set
+	    if the entitlement can be determined. Scaled value where 0x10000 equals to one core */
+	qc_ifl_guaranteed_capacity = 127,
+	/** Number of the lowest layer that imposes #qc_cp_effective_capacity */
+	qc_cp_limiting_layer = 128,
+	/** Number of the lowest layer that imposes #qc_ifl_effective_capacity */
+	qc_ifl_limiting_layer = 129,
+	/** #qc_cp_effective_capacity in normalized capacity units, i.e. scaled by the capability rating of the CPs,
+	    see #qc_normalized_capacity */
+	qc_cp_normalized_capacity = 130,
+	/** #qc_ifl_effective_capacity in normalized capacity units, i.e. scaled by the capability rating of the IFLs,
+	    see #qc_normalized_capacity */
+	qc_ifl_normalized_capacity = 131,
+	/** Sum of #qc_cp_normalized_capacity and #qc_ifl_normalized_capacity, to compare the capacity of layers across
+	    machine generations and capacity settings. The capability ratings of the CEC layer are inversely proportional
+	    to the capacity of a single core: #qc_capability applies to CPs, and #qc_secondary_capability (if set, or
+	    #qc_capability otherwise) to IFLs, as these run at full speed on sub-capacity models. One normalized
+	    capacity unit corresponds to a core with a capability rating of #QC_CAPABILITY_REFERENCE. SMT is
+	    considered as part of the effective capacity, i.e. all threads of a core add up to one core */
+	qc_normalized_capacity = 132,
+	/** #qc_cp_effective_capacity in unit of single-threaded cores, i.e. scaled by #QC_SMT_YIELD in case the CPs of
+	    the layer run with more than one thread per core, and unscaled otherwise, see #qc_cp_thread_equivalent_capacity */
+	qc_cp_core_equivalent_capacity = 133,
+	/** #qc_ifl_effective_capacity in unit of single-threaded cores, i.e. scaled by #QC_SMT_YIELD in case the IFLs of
+	    the layer run with more than one thread per core, and unscaled otherwise, see #qc_ifl_thread_equivalent_capacity */
+	qc_ifl_core_equivalent_capacity = 134,
+	/** #qc_cp_effective_capacity in unit of CPUs, i.e. the number of threads that can run concurrently. The CPUs of
+	    the CEC and LPAR group layers are cores. The CPs of an LPAR and of a hypervisor running in an LPAR run with
+	    #qc_num_cp_threads threads per core. The virtual CPUs of all layers above are threads of the hypervisor,
+	    e.g. a z/VM guest with 4 virtual CPs on an SMT-2 LPAR capped at one core has 2 thread equivalents */
+	qc_cp_thread_equivalent_capacity = 135,
+	/** #qc_ifl_effective_capacity in unit of CPUs, i.e. threads in case of SMT, see #qc_cp_thread_equivalent_capacity */
+	qc_ifl_thread_equivalent_capacity = 136,
+	/** Memory visible to Linux in KB as reported as \c MemTotal in \c /proc/meminfo */
+	qc_mem_total = 137,
+	/** Memory limit of the control group of the calling process in KB, considering all of its parent control
+	    groups, e.g. as set for a container. Not set if the memory is not limited */
+	qc_mem_limit = 138,
+	/** Nominal upper limit of the memory in KB as configured: The minimum of #qc_mem_total, #qc_mem_limit and
+	    #qc_mem_max of this and all lower layers. Use this instead of #qc_mem_total to size caches and heaps.
+	    <b>Note</b>: Hypervisors can overcommit memory, hence this is no guarantee that the memory is not paged
+	    out by a lower layer. E.g. a z/VM guest's #qc_mem_share and #qc_mem_used are not considered */
+	qc_mem_effective = 139,
+	/** Layer number of the layer that limits #qc_mem_effective */
+	qc_mem_limiting_layer = 140,
+};
+
+/** Hypothetical change of an integer attribute as passed to qc_simulate() */
+struct qc_change {
+	/** Layer of the attribute, see qc_get_attribute_int() */
+	int		 layer;
+	/** Table of the attribute as defined by #qc_table_id, or -1 to change an attribute of the layer itself */
+	int		 table;
+	/** Row of the attribute in \p table, ignored if \p table is -1 */
+	int		 row;
+	/** Attribute to change */
+	enum qc_attr_id	 id;
+	/** New value of the attribute */
+	int		 value;
+};
+
+/** Condition on an attribute as passed to qc_stats_add_threshold() */
+struct qc_threshold {
+	/** Layer of the attribute, see qc_get_attribute_int() */
+	int		 layer;
+	/** Integer or float attribute to watch */
+	enum qc_attr_id	 id;
+	/** Attribute that \p id is relative to, or -1. If set, the value of \p id is taken in percent of
+	    the value of this attribute */
+	int		 ref_id;
+	/** 1 if the condition is met when the value exceeds \p value, 0 if it falls below \p value */
+	int		 above;
+	/** Threshold that the value is compared to */
+	float		 value;
+	/** Margin that the value has to move back beyond \p value before the condition is cleared, 0 or higher */
+	float		 hysteresis;
+};
+
+/** Callback as passed to qc_stats_add_threshold(), called with the threshold \p thr, with \p active set to 1 if
+    its condition was met, or 0 if cleared, the value of the attribute \p value, and the caller's \p data */
+typedef void (*qc_threshold_cb)(const struct qc_threshold *thr, int active, float value, void *data);
+
+/** \enum qc_table_id
+ * Defines the tables retrievable by the API. Tables hold a variable number of rows, e.g.
+ * one row per CPU, and are attached to individual layers. Each row consists of attributes
+ * that are identified by #qc_attr_id just like the attributes of layers, and retrieved using
+ * qc_get_row_attribute_int() and its siblings. Use qc_get_num_rows() to retrieve the number
+ * of rows.
+ *
+ * The following tables detail which attributes of what types are available for what
+ * tables. See #qc_attr_id for an explanation of the '\c Src' column.
+ *
+ * Attributes for #qc_table_cpus       | Type | Src | Comment
+ * ------------------------------------|------|-----|-------------------------------------
+ * #qc_cpu_address                     | int  |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_cpu_type                        |string|<CODE>&nbsp;h&nbsp;</CODE>| Only set for the types listed in #qc_cpu_types
+ * #qc_cpu_type_num                    | int  |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_dedicated                       | int  |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_cpu_time                        |int64 |<CODE>&nbsp;hp</CODE>| Not set for physical cores
+ * #qc_mgmt_time                       |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Not set for virtual CPUs of KVM guests
+ * #qc_online_time                     |int64 |<CODE>&nbsp;hp</CODE>| Not set for physical cores
+ * #qc_utilization                     | float|<CODE>&nbsp;hp</CODE>| Share of the time that the CPU was busy<br><b>Note</b>: Only set after a call to qc_compute_utilization(), and not set for physical cores
+ * #qc_steal_time                      |int64 |<CODE>&nbsp;p&nbsp;</CODE>| Virtual CPUs of KVM guests only
+ * #qc_steal                           | float|<CODE>&nbsp;p&nbsp;</CODE>| Virtual CPUs of KVM guests only<br><b>Note</b>: Only set after a call to qc_compute_utilization()
+ *
+ * Attributes for #qc_table_lpars      | Type | Src | Comment
+ * ------------------------------------|------|-----|-------------------------------------
+ * #qc_layer_name                      |string|<CODE>&nbsp;h&nbsp;</CODE>| LPAR name
+ * #qc_lpar_group_name                 |string|<CODE>&nbsp;h&nbsp;</CODE>| Only set for members of an LPAR group
+ * #qc_num_cp_total                    | int  |<CODE>&nbsp;h&nbsp;</CODE>| Configured CPs, reported in unit of cores
+ * #qc_num_cp_dedicated                | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_cp_shared                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_ifl_total                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Configured IFLs, reported in unit of cores
+ * #qc_num_ifl_dedicated               | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_ifl_shared                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_cp_weight                       | int  |<CODE>&nbsp;h&nbsp;</CODE>| Only set in presence of shared CPs
+ * #qc_ifl_weight                      | int  |<CODE>&nbsp;h&nbsp;</CODE>| Only set in presence of shared IFLs
+ * #qc_cp_absolute_capping             | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores, 0 if not capped
+ * #qc_ifl_absolute_capping            | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores, 0 if not capped
+ * #qc_num_ziip_total                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Configured zIIPs, reported in unit of cores
+ * #qc_num_ziip_dedicated              | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_ziip_shared                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_icf_total                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Configured ICFs, reported in unit of cores
+ * #qc_num_icf_dedicated               | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_num_icf_shared                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores
+ * #qc_ziip_weight                     | int  |<CODE>&nbsp;h&nbsp;</CODE>| Only set in presence of shared zIIPs
+ * #qc_icf_weight                      | int  |<CODE>&nbsp;h&nbsp;</CODE>| Only set in presence of shared ICFs
+ * #qc_ziip_absolute_capping           | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores, 0 if not capped
+ * #qc_icf_absolute_capping            | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores, 0 if not capped
+ * #qc_cp_group_capping                | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores, 0 if not capped<br>Only set for members of an LPAR group
+ * #qc_ifl_group_capping               | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores, 0 if not capped<br>Only set for members of an LPAR group
+ * #qc_cp_time                         |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Summed up across all CPs of the LPAR
+ * #qc_ifl_time                        |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Summed up across all IFLs of the LPAR
+ * #qc_cp_consumption                  | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: Only set after a call to qc_compute_utilization()
+ * #qc_ifl_consumption                 | int  |<CODE>&nbsp;h&nbsp;</CODE>| Reported in unit of cores<br><b>Note</b>: Only set after a call to qc_compute_utilization()
+ * #qc_cp_guaranteed_capacity          | int  |<CODE>&nbsp;h&nbsp;</CODE>| Dedicated CPs plus the share of the shared physical CPs as defined by the weight, limited by the shared CPs and cappings<br>Reported in unit of cores<br><b>Note</b>: \b [4]
+ * #qc_ifl_guaranteed_capacity         | int  |<CODE>&nbsp;h&nbsp;</CODE>| Dedicated IFLs plus the share of the shared physical IFLs as defined by the weight, limited by the shared IFLs and cappings<br>Reported in unit of cores<br><b>Note</b>: \b [4]
+ *
+ * Attributes for #qc_table_zvm_guests | Type | Src | Comment
+ * ------------------------------------|------|-----|-------------------------------------
+ * #qc_layer_name                      |string|<CODE>&nbsp;h&nbsp;</CODE>| Guest name
+ * #qc_num_cpu_total                   | int  |<CODE>&nbsp;h&nbsp;</CODE>| Virtual CPUs
+ * #qc_cpu_time                        |int64 |<CODE>&nbsp;h&nbsp;</CODE>| CPU time consumed since logon
+ * #qc_online_time                     |int64 |<CODE>&nbsp;h&nbsp;</CODE>| Time elapsed since logon
+ * #qc_cpu_max                         | int  |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_cpu_shares                      | int  |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_mem_min                         |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_mem_max                         |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_mem_share                       |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_mem_used                        |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_cpu_use_samples                 |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_cpu_delay_samples               |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_page_wait_samples               |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_idle_samples                    |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_other_samples                   |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_total_samples                   |int64 |<CODE>&nbsp;h&nbsp;</CODE>| \n
+ * #qc_cp_guaranteed_capacity          | int  |<CODE>&nbsp;hV</CODE>| Share of the z/VM hypervisor's shared CPs as defined by #qc_cpu_shares relative to the sum of all guests, limited by the guest's virtual CPUs. The shared CPs count as far as covered by the guaranteed capacity of the LPAR, if known<br>Reported in unit of cores
+ * #qc_ifl_guaranteed_capacity         | int  |<CODE>&nbsp;hV</CODE>| Share of the z/VM hypervisor's shared IFLs as defined by #qc_cpu_shares relative to the sum of all guests, limited by the guest's virtual CPUs. The shared IFLs count as far as covered by the guaranteed capacity of the LPAR, if known<br>Reported in unit of cores
+ *
+ * Attributes for #qc_table_kvm_guests | Type | Src | Comment
+ * ------------------------------------|------|-----|-------------------------------------
+ * #qc_layer_name                      |string|<CODE>&nbsp;k&nbsp;</CODE>| Guest name
+ * #qc_num_cpu_total                   | int  |<CODE>&nbsp;k&nbsp;</CODE>| Virtual CPUs
+ * #qc_cpu_time                        |int64 |<CODE>&nbsp;k&nbsp;</CODE>| CPU time consumed since start of the guest
+ * #qc_online_time                     |int64 |<CODE>&nbsp;k&nbsp;</CODE>| Time elapsed since start of the guest
+ * #qc_overcommit                      | float|<CODE>&nbsp;k&nbsp;</CODE>| Ratio of the guest's virtual CPUs to the KVM host's shared cores
+ * #qc_cpu_consumption                 | int  |<CODE>&nbsp;k&nbsp;</CODE>| Reported in unit of CPUs<br><b>Note</b>: Only set after a call to qc_compute_utilization()
+ * #qc_utilization                     | float|<CODE>&nbsp;k&nbsp;</CODE>| Average utilization of the guest's virtual CPUs<br><b>Note</b>: Only set after a call to qc_compute_utilization()
+ *
+ * Attributes for #qc_table_topology   | Type | Src | Comment
+ * ------------------------------------|------|-----|-------------------------------------
+ * #qc_cpu_address                     | int  |<CODE>&nbsp;t&nbsp;</CODE>| Logical CPU number in Linux
+ * #qc_polarization                    |string|<CODE>&nbsp;t&nbsp;</CODE>| \n
+ * #qc_polarization_num                | int  |<CODE>&nbsp;t&nbsp;</CODE>| Only set for the polarizations listed in #qc_polarizations
+ * #qc_drawer_id                       | int  |<CODE>&nbsp;t&nbsp;</CODE>| Requires Linux kernel 4.7 or higher
+ * #qc_book_id                         | int  |<CODE>&nbsp;t&nbsp;</CODE>| \n
+ * #qc_socket_id                       | int  |<CODE>&nbsp;t&nbsp;</CODE>| \n
+ * #qc_core_id                         | int  |<CODE>&nbsp;t&nbsp;</CODE>| \n
+ */
+enum qc_table_id {
+	/** Configured CPUs of the layer. Available for layers of type \c #QC_LAYER_TYPE_LPAR,
+	    listing the LPAR's logical cores, \c #QC_LAYER_TYPE_CEC, listing the physical cores
+	    (requires global performance data to be enabled in the LPAR's activation profile), and
+	    \c #QC_LAYER_TYPE_KVM_GUEST, listing the virtual CPUs of the highest layer. */
+	qc_table_cpus = 0,
+	/** All LPARs of the CEC, in the order reported by the LPAR hypervisor. Available for layers
+	    of type \c #QC_LAYER_TYPE_CEC, and of type \c #QC_LAYER_TYPE_LPAR_GROUP, listing the
+	    members of the group only. Lists our own LPAR only unless global performance data
+	    is enabled in the LPAR's activation profile. */
+	qc_table_lpars = 1,
+	/** All guests of the z/VM hypervisor that the highest z/VM guest layer runs on. Available
+	    for layers of type \c #QC_LAYER_TYPE_ZVM_HYPERVISOR. Requires binary hypfs. */
+	qc_table_zvm_guests = 2,
+	/** All KVM guests that the highest layer runs as a KVM hypervisor. Available for the highest
+	    layer if it is of type \c #QC_LAYER_TYPE_LPAR or \c #QC_LAYER_TYPE_ZVM_GUEST. */
+	qc_table_kvm_guests = 3,
+	/** Topology and polarization of the online CPUs that Linux runs on. Available for layers of
+	    type \c #QC_LAYER_TYPE_LPAR if it is the highest layer. */
+	qc_table_topology = 4,
 };
 
 
@@ -491,6 +1133,14 @@ enum qc_attr_id {
  *   environment variable to a directory containing the dump data.
  * - \c QC_CHECK_CONSISTENCY: Check data for consistency. Recommended for debugging
  *   scenarios only.
+ * - \c QC_SMT_YIELD: Set to a floating point value >=1 to override #QC_SMT_YIELD, e.g.
+ *   \c 1.2 if workloads gain 20% throughput per core by SMT. Evaluated once per process,
+ *   and applies to qc_open_from_buffers() and qc_simulate() as well.
+ * - \c QC_TRACE: Set to a filename to have a timeline of the steps within qc_open()
+ *   written in Chrome trace event format, e.g. for use with \c chrome://tracing
+ *   or Perfetto. Events of subsequent calls are appended to the same file, which
+ *   is completed on the first call to qc_close() with \c QC_TRACE unset, or on
+ *   program exit.
  *
  * @see qc_close()
  *
@@ -505,16 +1155,44 @@ enum qc_attr_id {
  */
 void *qc_open(int *rc);
 
+/**
+ * Opens a configuration from source data provided by the caller instead of
+ * the running system, e.g. to process data collected on other systems.
+ * The data is processed exactly as within qc_open(), except that the
+ * consistency check is always performed, and that neither data is read from
+ * nor written to the filesystem.<BR>
+ * Unlike qc_open(), this function does not evaluate any environment variables,
+ * nor does it modify any state shared between configurations. Therefore,
+ * multiple threads can call it concurrently. Logging and tracing remain subject
+ * to the settings of previous calls to qc_open(), if any.<BR>
+ * The buffers are copied and can be released by the caller once this function
+ * returns. If multiple buffers of the same type are passed, the last one is used.
+ * The returned configuration has to be closed using qc_close().
+ *
+ * @see qc_open()
+ *
+ * @param bufs Array of source data. Must contain a buffer of type
+ *        #QC_SOURCE_SYSINFO at a minimum.
+ * @param num Number of elements in \p bufs.
+ * @param rc Return parameter indicating the return code. Set to
+ * - 0 on success,
+ * - <0 in case of an error,
+ * - 1 if the data is incomplete, and
+ * - 2 if the data is inconsistent.
+ * @return Returns a configuration handle on success, or NULL otherwise.
+ */
+void *qc_open_from_buffers(const struct qc_source_buffer *bufs, int num, int *rc);
+
 /**
  * Closes the configuration handle and releases all memory allocated when the
  * configuration was opened. The configuration handle is invalid after
  * calling this function, as are any returned pointers of previous capacity
  * function calls.
  *
- * If logging or autodumping was enabled on qc_open(), environment variables
+ * If logging, autodumping or tracing was enabled on qc_open(), environment variables
  * \c QC_DEBUG and \c QC_AUTODUMP need to be set to integers <=0 on the final
  * call to qc_close() (or whenever neither functionality is not required
- * anymore) to correctly free up all resources.
+ * anymore), and \c QC_TRACE unset, to correctly free up all resources.
  *
  * @param hdl Handle of the configuration to close.
  */
@@ -562,6 +1240,7 @@ int qc_get_attribute_string(void *hdl, enum qc_attr_id id, int layer, const char
  * or another error occurred, return parameter \p valid will be set accordingly.
  *
  * @see qc_get_attribute_string()
+ * @see qc_get_attribute_int64()
  * @see qc_get_attribute_float()
  *
  * @param hdl Handle of the configuration to use.
@@ -579,6 +1258,11 @@ int qc_get_attribute_string(void *hdl, enum qc_attr_id id, int layer, const char
  */
 int qc_get_attribute_int(void *hdl, enum qc_attr_id id, int layer, int *value);
 
+/**
+ * Like qc_get_attribute_int(), but for attributes of type int64.
+ */
+int qc_get_attribute_int64(void *hdl, enum qc_attr_id id, int layer, int64_t *value);
+
 /**
  * Returns the attribute of type float designated by \p id. If the attribute is
  * not available at the specified layer, the attribute is not of type float,
@@ -601,4 +1285,227 @@ int qc_get_attribute_int(void *hdl, enum qc_attr_id id, int layer, int *value);
  */
 int qc_get_attribute_float(void *hdl, enum qc_attr_id id, int layer, float *value);
 
+
+/**
+ * Computes utilization values for the configuration in \p hdl based on the
+ * difference to an earlier configuration \p prev_hdl of the same system, e.g.
+ * as retrieved by a previous call of qc_open(). Values are normalized by the
+ * elapsed time between the two snapshots. Sets attributes
+ * #qc_cp_utilization, #qc_ifl_utilization, #qc_cp_consumption and
+ * #qc_ifl_consumption in the CEC and LPAR layers, as well as #qc_utilization
+ * in table #qc_table_cpus of the LPAR layer in \p hdl. In the CEC layer, the
+ * values refer to the shared physical cores, i.e. indicate how contended they
+ * are by all LPARs. See \b [6] in #qc_attr_id for the attributes set in other
+ * layers, and the tables' descriptions in #qc_table_id for their columns.
+ * Values from a previous call will be replaced.
+ * Requires hypfs, \c /proc/stat in KVM guests, or cgroups in KVM hosts to be
+ * available.
+ *
+ * @param hdl Handle of the configuration to update.
+ * @param prev_hdl Handle of an earlier configuration of the same system.
+ * @return Indicating success as follows:
+ * -  0  success
+ * - >0  no utilization data available, e.g. since \p prev_hdl is not older than \p hdl,
+ *       originates from a different system, or none of the above are available
+ * - <0  an error occurred
+ */
+int qc_compute_utilization(void *hdl, void *prev_hdl);
+
+/**
+ * Recommends the number of workers, e.g. threads in a thread pool, to run in the highest layer on
+ * CPUs of type \p type. Other than the number of CPUs visible to the highest layer, the
+ * recommendation considers #qc_cp_effective_capacity and #qc_cp_guaranteed_capacity (or the
+ * respective IFL attributes), the SMT thread counts, and whether a z/VM guest is capped
+ * softly only (see #qc_capping_num). The guaranteed capacity reflects dedicated and shared CPUs.
+ *
+ * @param hdl Handle of the configuration to use.
+ * @param type CPU type to run on, either \c #QC_CPU_TYPE_CP or \c #QC_CPU_TYPE_IFL.
+ * @param policy Policy to apply, see #qc_parallelism_policies.
+ * @param rc Return code indicating success as follows:
+ * -  0  success
+ * - >0  no CPUs of type \p type are visible to the highest layer, or their number is unknown
+ * - <0  an error occurred
+ * @return Recommended number of workers between 1 and the number of visible CPUs, or 0 if
+ * \p rc is not 0.
+ */
+int qc_recommend_parallelism(void *hdl, enum qc_cpu_types type, enum qc_parallelism_policies policy, int *rc);
+
+/**
+ * Simulates hypothetical changes to the configuration in \p hdl, e.g. to answer what capacity a
+ * guest would have if its resource pool was capped. The changes are applied to a copy of the
+ * configuration in the given order, and the entitlements and capacities of all layers are derived
+ * anew just like in qc_open(): #qc_cp_effective_capacity, #qc_cp_guaranteed_capacity,
+ * #qc_cp_limiting_layer, the respective IFL attributes, and the guaranteed capacities in table
+ * #qc_table_lpars of the CEC layer. Changes to attributes of the LPAR layer also apply to the
+ * LPAR's row in table #qc_table_lpars of the CEC layer. All other attributes are left as is and
+ * need to be changed consistently by the caller, e.g. #qc_num_ifl_total along with
+ * #qc_num_ifl_shared, or #qc_ifl_weight_capping along with #qc_ifl_weight.<BR>
+ * Examples:
+ * - Change an LPAR's weight: Set #qc_ifl_weight in its row of table #qc_table_lpars
+ *   at layer 0, or in the LPAR layer in case of our own LPAR.
+ * - Cap a z/VM resource pool: Set #qc_ifl_limithard_cap to 1 and #qc_ifl_capped_capacity in
+ *   the resource pool layer.
+ * - Move a z/VM guest to another resource pool: Set the cappings of the resource pool layer
+ *   to the ones of the other pool.
+ * - Switch off SMT: Set #qc_num_ifl_threads to 1 in the CEC, LPAR and hypervisor layers.
+ *
+ * The simulated configuration is retrieved like any other, but qc_compute_utilization()
+ * does not apply. It has to be closed using qc_close(), and remains valid after \p hdl was closed.
+ *
+ * @param hdl Handle of the configuration to start from, which remains unmodified.
+ * @param changes Array of changes to apply.
+ * @param num Number of elements in \p changes.
+ * @param rc Return parameter indicating the return code. Set to
+ * - 0 on success,
+ * - <0 in case of an error, e.g. -1 if a change refers to an attribute that does not exist.
+ * @return Returns a handle of the simulated configuration on success, or NULL in case of an error.
+ */
+void *qc_simulate(void *hdl, const struct qc_change *changes, int num, int *rc);
+
+/**
+ * Sets up statistics of the CP and IFL consumption (see #qc_cp_consumption and #qc_ifl_consumption) of
+ * all layers of configurations like \p hdl, e.g. to retrieve smoothed values of the available capacity
+ * without keeping a history of configurations. All memory is allocated in this function, and
+ * released by qc_stats_close(). Samples are added using qc_stats_update(), and statistics are
+ * retrieved using qc_stats_get().<BR>
+ * The statistics are not protected against concurrent use by multiple threads.
+ *
+ * @param hdl Handle of a configuration, defining the layers to collect statistics for.
+ * @param cfg Settings of the statistics. Pass NULL to use a sliding window of 60 samples,
+ *        a weight of 0.3 for the latest sample, and a forecast 5 samples ahead.
+ * @param rc Return parameter indicating the return code. Set to
+ * - 0 on success,
+ * - <0 in case of an error, e.g. -1 if \p cfg is invalid.
+ * @return Returns a handle of the statistics on success, or NULL in case of an error.
+ */
+void *qc_stats_open(void *hdl, const struct qc_stats_config *cfg, int *rc);
+
+/**
+ * Adds the CP and IFL consumption of all layers of configuration \p hdl as a new sample to statistics
+ * \p stats. Requires a prior call of qc_compute_utilization() for \p hdl, and is meant to be called
+ * once for every configuration, e.g. after periodic calls of qc_open(). Layers without consumption
+ * data are skipped. Evaluates the conditions registered with qc_stats_add_threshold() thereafter.
+ * Does not allocate any memory.
+ *
+ * @param stats Handle of the statistics to update.
+ * @param hdl Handle of the configuration to add.
+ * @return Indicating success as follows:
+ * -  0  success
+ * - >0  no sample added, since \p hdl provides no consumption data, or its layers differ from
+ *       the configuration passed to qc_stats_open()
+ * - <0  an error occurred
+ */
+int qc_stats_update(void *stats, void *hdl);
+
+/**
+ * Returns statistic \p stat of the consumption of CPU type \p type in layer \p layer. All values
+ * are scaled where 0x10000 equals to one core.
+ *
+ * @param stats Handle of the statistics to use.
+ * @param layer Layer as in qc_get_attribute_int().
+ * @param type CPU type, either \c #QC_CPU_TYPE_CP or \c #QC_CPU_TYPE_IFL.
+ * @param stat Statistic to retrieve, see #qc_statistics.
+ * @param value Return parameter returning the value.
+ * @return Indicating validity of the value as follows:
+ * - >0  value is valid
+ * -  0  no samples available
+ * - <0  an error occurred, e.g. invalid parameters
+ */
+int qc_stats_get(void *stats, int layer, enum qc_cpu_types type, enum qc_statistics stat, int *value);
+
+/**
+ * Registers a condition on an attribute of configurations added to statistics \p stats, which is evaluated
+ * on every call of qc_stats_update() without allocating memory. When the condition is met, \p cb is called
+ * and an 8-byte counter of 1 is written to \p fd, e.g. an \c eventfd. When it is cleared again, i.e. the
+ * value moved back beyond the threshold by more than the hysteresis, \p cb is called. Conditions are not
+ * evaluated while the attribute is not set. Examples:
+ * - Effective capacity drops below 2 IFLs: #qc_ifl_effective_capacity below 0x20000.
+ * - Layer hits its cappings: #qc_ifl_consumption above 95 percent of #qc_ifl_effective_capacity.
+ * - z/VM guest suffers from CPU delay: #qc_cpu_delay above 10.
+ *
+ * @param stats Handle of the statistics to use.
+ * @param thr Condition to watch. Will be copied.
+ * @param cb Function to call, or NULL.
+ * @param data Passed to \p cb.
+ * @param fd File descriptor to write to, or -1.
+ * @return Number of the threshold (0 or higher) on success, or <0 in case of an error.
+ */
+int qc_stats_add_threshold(void *stats, const struct qc_threshold *thr, qc_threshold_cb cb, void *data, int fd);
+
+/**
+ * Releases all memory of statistics \p stats, which is invalid afterwards.
+ *
+ * @param stats Handle of the statistics to close.
+ */
+void qc_stats_close(void *stats);
+
+/**
+ * Get the number of rows of table \p table at layer \p layer.
+ *
+ * @param hdl Handle of the configuration to use.
+ * @param table Table to query.
+ * @param layer Layer of the table, see qc_get_attribute_int().
+ * @param rc Return code indicating success as follows:
+ * - >0  table exists
+ * -  0  table is not available at this layer
+ * - <0  an error occurred
+ * @return Number of rows, or 0 in case the table does not exist.
+ */
+int qc_get_num_rows(void *hdl, enum qc_table_id table, int layer, int *rc);
+
+/**
+ * Get the row of table \p table at layer \p layer with attribute #qc_layer_name set to \p name,
+ * e.g. to look up an LPAR in table #qc_table_lpars. Tables #qc_table_lpars,
+ * #qc_table_zvm_guests and #qc_table_kvm_guests are indexed by name, so the lookup takes
+ * constant time.
+ *
+ * @param hdl Handle of the configuration to use.
+ * @param table Table to query.
+ * @param layer Layer of the table, see qc_get_attribute_int().
+ * @param name Name to look up.
+ * @param rc Return code indicating success as follows:
+ * - >0  row found
+ * -  0  table is not available at this layer, or no row matches
+ * - <0  an error occurred
+ * @return Index of the row, or -1 in case there is no matching row.
+ */
+int qc_get_row_by_name(void *hdl, enum qc_table_id table, int layer, const char *name, int *rc);
+
+/**
+ * Returns the attribute of type integer designated by \p id in row \p row of table
+ * \p table at layer \p layer.
+ *
+ * @see qc_get_row_attribute_int64()
+ * @see qc_get_row_attribute_float()
+ * @see qc_get_row_attribute_string()
+ *
+ * @param hdl Handle of the configuration to use.
+ * @param table Table to query.
+ * @param id Attribute to retrieve.
+ * @param layer Layer of the table, see qc_get_attribute_int().
+ * @param row Row of the table, starting at 0.
+ * @param value Return parameter returning the integer attribute's value or undefined
+ * in case of an error.
+ @return Indicating validity of the queried attribute as follows:
+ * - >0  attribute is valid
+ * -  0  attribute exists but is not set
+ * - <0  an error occurred retrieving the attribute, e.g. -5 if \p row is out of range
+ */
+int qc_get_row_attribute_int(void *hdl, enum qc_table_id table, enum qc_attr_id id, int layer, int row, int *value);
+
+/**
+ * Like qc_get_row_attribute_int(), but for attributes of type int64.
+ */
+int qc_get_row_attribute_int64(void *hdl, enum qc_table_id table, enum qc_attr_id id, int layer, int row, int64_t *value);
+
+/**
+ * Like qc_get_row_attribute_int(), but for attributes of type float.
+ */
+int qc_get_row_attribute_float(void *hdl, enum qc_table_id table, enum qc_attr_id id, int layer, int row, float *value);
+
+/**
+ * Like qc_get_row_attribute_int(), but for attributes of type string.
+ */
+int qc_get_row_attribute_string(void *hdl, enum qc_table_id table, enum qc_attr_id id, int layer, int row, const char **value);
+
 #endif
@@ -41,12 +41,35 @@ struct qc_cec_values {
 	int num_ifl_total;
 	int num_ifl_dedicated;
 	int num_ifl_shared;
+	int num_ziip_total;
+	int num_ziip_dedicated;
+	int num_ziip_shared;
+	int num_icf_total;
+	int num_icf_dedicated;
+	int num_icf_shared;
 	int num_cp_threads;
 	int num_ifl_threads;
 	float capability;
 	float secondary_capability;
 	int capacity_adjustment_indication;
 	int capacity_change_reason;
+	float cp_utilization;
+	float ifl_utilization;
+	int cp_consumption;
+	int ifl_consumption;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
 };
 
 /*
@@ -60,6 +83,29 @@ struct qc_lpar_group_values {
 	char layer_name[9];
 	int cp_absolute_capping;
 	int ifl_absolute_capping;
+	int num_cp_total;
+	int num_cp_shared;
+	int num_ifl_total;
+	int num_ifl_shared;
+	int cp_weight;
+	int ifl_weight;
+	float cp_utilization;
+	float ifl_utilization;
+	int cp_consumption;
+	int ifl_consumption;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
 };
 
 /*
@@ -95,6 +141,44 @@ struct qc_lpar_values {
 	int ifl_absolute_capping;
 	int cp_weight_capping;
 	int ifl_weight_capping;
+	int num_ziip_total;
+	int num_ziip_dedicated;
+	int num_ziip_shared;
+	int num_icf_total;
+	int num_icf_dedicated;
+	int num_icf_shared;
+	int ziip_absolute_capping;
+	int icf_absolute_capping;
+	int ziip_weight_capping;
+	int icf_weight_capping;
+	float cp_utilization;
+	float ifl_utilization;
+	int cp_consumption;
+	int ifl_consumption;
+	float overcommit;
+	int num_cpu_horizontal;
+	int num_cpu_vertical_low;
+	int num_cpu_vertical_medium;
+	int num_cpu_vertical_high;
+	int num_drawers;
+	int num_core_per_drawer;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
+	int64_t mem_total;
+	int64_t mem_limit;
+	int64_t mem_effective;
+	int mem_limiting_layer;
 };
 
 struct qc_zvm_pool_values {
@@ -109,6 +193,19 @@ struct qc_zvm_pool_values {
 	int ifl_capacity_cap;
 	int cp_capped_capacity;
 	int ifl_capped_capacity;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
 };
 
 struct qc_zvm_hypervisor_values {
@@ -133,6 +230,19 @@ struct qc_zvm_hypervisor_values {
 	int num_ifl_shared;
 	int num_cp_threads;
 	int num_ifl_threads;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
 };
 
 struct qc_zvm_guest_values {
@@ -167,6 +277,31 @@ struct qc_zvm_guest_values {
 	int ifl_dispatch_limithard;
 	int ifl_dispatch_type;
 	int ifl_capped_capacity;
+	int cpu_consumption;
+	float cpu_delay;
+	float page_wait;
+	float overcommit;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
+	int64_t mem_min;
+	int64_t mem_max;
+	int64_t mem_share;
+	int64_t mem_used;
+	int64_t mem_total;
+	int64_t mem_limit;
+	int64_t mem_effective;
+	int mem_limiting_layer;
 };
 
 struct qc_kvm_hypervisor_values {
@@ -185,6 +320,23 @@ struct qc_kvm_hypervisor_values {
 	int num_ifl_total;
 	int num_ifl_dedicated;
 	int num_ifl_shared;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
+	int64_t mem_total;
+	int64_t mem_limit;
+	int64_t mem_effective;
+	int mem_limiting_layer;
 };
 
 struct qc_kvm_guest_values {
@@ -205,20 +357,146 @@ struct qc_kvm_guest_values {
 	int num_ifl_dedicated;
 	int num_ifl_shared;
 	int ifl_dispatch_type;
+	float utilization;
+	int cpu_consumption;
+	float steal;
+	int cp_effective_capacity;
+	int ifl_effective_capacity;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+	int cp_limiting_layer;
+	int ifl_limiting_layer;
+	float cp_normalized_capacity;
+	float ifl_normalized_capacity;
+	float normalized_capacity;
+	float cp_core_equivalent_capacity;
+	float ifl_core_equivalent_capacity;
+	float cp_thread_equivalent_capacity;
+	float ifl_thread_equivalent_capacity;
+	int64_t mem_total;
+	int64_t mem_limit;
+	int64_t mem_effective;
+	int mem_limiting_layer;
+};
+
+/*
+ * rows of table "cpus"
+ */
+struct qc_cpu_row {
+	int cpu_address;
+	char cpu_type[8];
+	int cpu_type_num;
+	int dedicated;
+	int64_t cpu_time;
+	int64_t mgmt_time;
+	int64_t online_time;
+	float utilization;
+	int64_t steal_time;
+	float steal;
+};
+
+/*
+ * rows of table "lpars"
+ */
+struct qc_lpar_row {
+	char layer_name[9];
+	char lpar_group_name[9];
+	int num_cp_total;
+	int num_cp_dedicated;
+	int num_cp_shared;
+	int num_ifl_total;
+	int num_ifl_dedicated;
+	int num_ifl_shared;
+	int cp_weight;
+	int ifl_weight;
+	int cp_absolute_capping;
+	int ifl_absolute_capping;
+	int cp_group_capping;
+	int ifl_group_capping;
+	int64_t cp_time;
+	int64_t ifl_time;
+	int cp_consumption;
+	int ifl_consumption;
+	int num_ziip_total;
+	int num_ziip_dedicated;
+	int num_ziip_shared;
+	int num_icf_total;
+	int num_icf_dedicated;
+	int num_icf_shared;
+	int ziip_weight;
+	int icf_weight;
+	int ziip_absolute_capping;
+	int icf_absolute_capping;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+};
+
+/*
+ * rows of table "zvm_guests"
+ */
+struct qc_zvm_guest_row {
+	char layer_name[9];
+	int num_cpu_total;
+	int64_t cpu_time;
+	int64_t online_time;
+	int cpu_max;
+	int cpu_shares;
+	int64_t mem_min;
+	int64_t mem_max;
+	int64_t mem_share;
+	int64_t mem_used;
+	int64_t cpu_use_samples;
+	int64_t cpu_delay_samples;
+	int64_t page_wait_samples;
+	int64_t idle_samples;
+	int64_t other_samples;
+	int64_t total_samples;
+	int cp_guaranteed_capacity;
+	int ifl_guaranteed_capacity;
+};
+
+/*
+ * rows of table "kvm_guests"
+ */
+struct qc_kvm_guest_row {
+	char layer_name[65];
+	int num_cpu_total;
+	int64_t cpu_time;
+	int64_t online_time;
+	float overcommit;
+	int cpu_consumption;
+	float utilization;
+};
+
+/*
+ * rows of table "topology"
+ */
+struct qc_topology_row {
+	int cpu_address;
+	char polarization[16];
+	int polarization_num;
+	int drawer_id;
+	int book_id;
+	int socket_id;
+	int core_id;
 };
 
 enum qc_data_type {
 	string,
 	integer,
-	floatingpoint
+	floatingpoint,
+	integer64
 };
 
 struct qc_attr {
 	enum qc_attr_id id;
 	enum qc_data_type type;
 	int offset;
+	int size;	// size of string columns in table rows, including the terminating zero
 };
 
+#define COLUMN_SIZE(row, member)	sizeof(((struct row *)0)->member)
+
 static struct qc_attr cec_attrs[]  =  {
 	{qc_layer_type_num, integer, offsetof(struct qc_cec_values, layer_type_num)},
 	{qc_layer_category_num, integer, offsetof(struct qc_cec_values, layer_category_num)},
@@ -243,12 +521,35 @@ static struct qc_attr cec_attrs[]  =  {
 	{qc_num_ifl_total, integer, offsetof(struct qc_cec_values, num_ifl_total)},
 	{qc_num_ifl_dedicated, integer, offsetof(struct qc_cec_values, num_ifl_dedicated)},
 	{qc_num_ifl_shared, integer, offsetof(struct qc_cec_values, num_ifl_shared)},
+	{qc_num_ziip_total, integer, offsetof(struct qc_cec_values, num_ziip_total)},
+	{qc_num_ziip_dedicated, integer, offsetof(struct qc_cec_values, num_ziip_dedicated)},
+	{qc_num_ziip_shared, integer, offsetof(struct qc_cec_values, num_ziip_shared)},
+	{qc_num_icf_total, integer, offsetof(struct qc_cec_values, num_icf_total)},
+	{qc_num_icf_dedicated, integer, offsetof(struct qc_cec_values, num_icf_dedicated)},
+	{qc_num_icf_shared, integer, offsetof(struct qc_cec_values, num_icf_shared)},
 	{qc_num_cp_threads, integer, offsetof(struct qc_cec_values, num_cp_threads)},
 	{qc_num_ifl_threads, integer, offsetof(struct qc_cec_values, num_ifl_threads)},
 	{qc_capability, floatingpoint, offsetof(struct qc_cec_values, capability)},
 	{qc_secondary_capability, floatingpoint, offsetof(struct qc_cec_values, secondary_capability)},
 	{qc_capacity_adjustment_indication, integer, offsetof(struct qc_cec_values, capacity_adjustment_indication)},
 	{qc_capacity_change_reason, integer, offsetof(struct qc_cec_values, capacity_change_reason)},
+	{qc_cp_utilization, floatingpoint, offsetof(struct qc_cec_values, cp_utilization)},
+	{qc_ifl_utilization, floatingpoint, offsetof(struct qc_cec_values, ifl_utilization)},
+	{qc_cp_consumption, integer, offsetof(struct qc_cec_values, cp_consumption)},
+	{qc_ifl_consumption, integer, offsetof(struct qc_cec_values, ifl_consumption)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_cec_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_cec_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_cec_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_cec_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_cec_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_cec_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_cec_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_cec_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_cec_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_cec_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_cec_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_cec_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_cec_values, ifl_thread_equivalent_capacity)},
 	{-1, string, -1}
 };
 
@@ -260,6 +561,29 @@ static struct qc_attr lpar_group_attrs[] = {
 	{qc_layer_name, string, offsetof(struct qc_lpar_group_values, layer_name)},
 	{qc_cp_absolute_capping, integer, offsetof(struct qc_lpar_group_values, cp_absolute_capping)},
 	{qc_ifl_absolute_capping, integer, offsetof(struct qc_lpar_group_values, ifl_absolute_capping)},
+	{qc_num_cp_total, integer, offsetof(struct qc_lpar_group_values, num_cp_total)},
+	{qc_num_cp_shared, integer, offsetof(struct qc_lpar_group_values, num_cp_shared)},
+	{qc_num_ifl_total, integer, offsetof(struct qc_lpar_group_values, num_ifl_total)},
+	{qc_num_ifl_shared, integer, offsetof(struct qc_lpar_group_values, num_ifl_shared)},
+	{qc_cp_weight, integer, offsetof(struct qc_lpar_group_values, cp_weight)},
+	{qc_ifl_weight, integer, offsetof(struct qc_lpar_group_values, ifl_weight)},
+	{qc_cp_utilization, floatingpoint, offsetof(struct qc_lpar_group_values, cp_utilization)},
+	{qc_ifl_utilization, floatingpoint, offsetof(struct qc_lpar_group_values, ifl_utilization)},
+	{qc_cp_consumption, integer, offsetof(struct qc_lpar_group_values, cp_consumption)},
+	{qc_ifl_consumption, integer, offsetof(struct qc_lpar_group_values, ifl_consumption)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_lpar_group_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_lpar_group_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_lpar_group_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_lpar_group_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_lpar_group_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_lpar_group_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_group_values, ifl_thread_equivalent_capacity)},
 	{-1, string, -1}
 };
 
@@ -293,6 +617,44 @@ static struct qc_attr lpar_attrs[] = {
 	{qc_ifl_absolute_capping, integer, offsetof(struct qc_lpar_values, ifl_absolute_capping)},
 	{qc_cp_weight_capping, integer, offsetof(struct qc_lpar_values, cp_weight_capping)},
 	{qc_ifl_weight_capping, integer, offsetof(struct qc_lpar_values, ifl_weight_capping)},
+	{qc_num_ziip_total, integer, offsetof(struct qc_lpar_values, num_ziip_total)},
+	{qc_num_ziip_dedicated, integer, offsetof(struct qc_lpar_values, num_ziip_dedicated)},
+	{qc_num_ziip_shared, integer, offsetof(struct qc_lpar_values, num_ziip_shared)},
+	{qc_num_icf_total, integer, offsetof(struct qc_lpar_values, num_icf_total)},
+	{qc_num_icf_dedicated, integer, offsetof(struct qc_lpar_values, num_icf_dedicated)},
+	{qc_num_icf_shared, integer, offsetof(struct qc_lpar_values, num_icf_shared)},
+	{qc_ziip_absolute_capping, integer, offsetof(struct qc_lpar_values, ziip_absolute_capping)},
+	{qc_icf_absolute_capping, integer, offsetof(struct qc_lpar_values, icf_absolute_capping)},
+	{qc_ziip_weight_capping, integer, offsetof(struct qc_lpar_values, ziip_weight_capping)},
+	{qc_icf_weight_capping, integer, offsetof(struct qc_lpar_values, icf_weight_capping)},
+	{qc_cp_utilization, floatingpoint, offsetof(struct qc_lpar_values, cp_utilization)},
+	{qc_ifl_utilization, floatingpoint, offsetof(struct qc_lpar_values, ifl_utilization)},
+	{qc_cp_consumption, integer, offsetof(struct qc_lpar_values, cp_consumption)},
+	{qc_ifl_consumption, integer, offsetof(struct qc_lpar_values, ifl_consumption)},
+	{qc_overcommit, floatingpoint, offsetof(struct qc_lpar_values, overcommit)},
+	{qc_num_cpu_horizontal, integer, offsetof(struct qc_lpar_values, num_cpu_horizontal)},
+	{qc_num_cpu_vertical_low, integer, offsetof(struct qc_lpar_values, num_cpu_vertical_low)},
+	{qc_num_cpu_vertical_medium, integer, offsetof(struct qc_lpar_values, num_cpu_vertical_medium)},
+	{qc_num_cpu_vertical_high, integer, offsetof(struct qc_lpar_values, num_cpu_vertical_high)},
+	{qc_num_drawers, integer, offsetof(struct qc_lpar_values, num_drawers)},
+	{qc_num_core_per_drawer, integer, offsetof(struct qc_lpar_values, num_core_per_drawer)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_lpar_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_lpar_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_lpar_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_lpar_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_lpar_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_lpar_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_lpar_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_lpar_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_lpar_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_lpar_values, ifl_thread_equivalent_capacity)},
+	{qc_mem_total, integer64, offsetof(struct qc_lpar_values, mem_total)},
+	{qc_mem_limit, integer64, offsetof(struct qc_lpar_values, mem_limit)},
+	{qc_mem_effective, integer64, offsetof(struct qc_lpar_values, mem_effective)},
+	{qc_mem_limiting_layer, integer, offsetof(struct qc_lpar_values, mem_limiting_layer)},
 	{-1, string, -1}
 };
 
@@ -318,6 +680,19 @@ static struct qc_attr zvm_hv_attrs[] = {
 	{qc_num_ifl_shared, integer, offsetof(struct qc_zvm_hypervisor_values, num_ifl_shared)},
 	{qc_num_cp_threads, integer, offsetof(struct qc_zvm_hypervisor_values, num_cp_threads)},
 	{qc_num_ifl_threads, integer, offsetof(struct qc_zvm_hypervisor_values, num_ifl_threads)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_zvm_hypervisor_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_zvm_hypervisor_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_zvm_hypervisor_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_zvm_hypervisor_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_zvm_hypervisor_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_zvm_hypervisor_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_hypervisor_values, ifl_thread_equivalent_capacity)},
 	{-1, string, -1}
 };
 
@@ -337,6 +712,23 @@ static struct qc_attr kvm_hv_attrs[] = {
 	{qc_num_ifl_total, integer, offsetof(struct qc_kvm_hypervisor_values, num_ifl_total)},
 	{qc_num_ifl_dedicated, integer, offsetof(struct qc_kvm_hypervisor_values, num_ifl_dedicated)},
 	{qc_num_ifl_shared, integer, offsetof(struct qc_kvm_hypervisor_values, num_ifl_shared)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_kvm_hypervisor_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_kvm_hypervisor_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_kvm_hypervisor_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_kvm_hypervisor_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_kvm_hypervisor_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_kvm_hypervisor_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_hypervisor_values, ifl_thread_equivalent_capacity)},
+	{qc_mem_total, integer64, offsetof(struct qc_kvm_hypervisor_values, mem_total)},
+	{qc_mem_limit, integer64, offsetof(struct qc_kvm_hypervisor_values, mem_limit)},
+	{qc_mem_effective, integer64, offsetof(struct qc_kvm_hypervisor_values, mem_effective)},
+	{qc_mem_limiting_layer, integer, offsetof(struct qc_kvm_hypervisor_values, mem_limiting_layer)},
 	{-1, string, -1}
 };
 
@@ -352,6 +744,19 @@ static struct qc_attr zvm_pool_attrs[] = {
 	{qc_ifl_capacity_cap, integer, offsetof(struct qc_zvm_pool_values, ifl_capacity_cap)},
 	{qc_cp_capped_capacity, integer, offsetof(struct qc_zvm_pool_values, cp_capped_capacity)},
 	{qc_ifl_capped_capacity, integer, offsetof(struct qc_zvm_pool_values, ifl_capped_capacity)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_zvm_pool_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_zvm_pool_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_zvm_pool_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_zvm_pool_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_zvm_pool_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_zvm_pool_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_pool_values, ifl_thread_equivalent_capacity)},
 	{-1, string, -1}
 };
 
@@ -383,6 +788,31 @@ static struct qc_attr zvm_guest_attrs[] = {
 	{qc_ifl_capped_capacity, integer, offsetof(struct qc_zvm_guest_values, ifl_capped_capacity)},
 	{qc_cp_dispatch_type, integer, offsetof(struct qc_zvm_guest_values, cp_dispatch_type)},
 	{qc_ifl_dispatch_type, integer, offsetof(struct qc_zvm_guest_values, ifl_dispatch_type)},
+	{qc_cpu_consumption, integer, offsetof(struct qc_zvm_guest_values, cpu_consumption)},
+	{qc_cpu_delay, floatingpoint, offsetof(struct qc_zvm_guest_values, cpu_delay)},
+	{qc_page_wait, floatingpoint, offsetof(struct qc_zvm_guest_values, page_wait)},
+	{qc_overcommit, floatingpoint, offsetof(struct qc_zvm_guest_values, overcommit)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_zvm_guest_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_zvm_guest_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_zvm_guest_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_zvm_guest_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_zvm_guest_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_zvm_guest_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_zvm_guest_values, ifl_thread_equivalent_capacity)},
+	{qc_mem_min, integer64, offsetof(struct qc_zvm_guest_values, mem_min)},
+	{qc_mem_max, integer64, offsetof(struct qc_zvm_guest_values, mem_max)},
+	{qc_mem_share, integer64, offsetof(struct qc_zvm_guest_values, mem_share)},
+	{qc_mem_used, integer64, offsetof(struct qc_zvm_guest_values, mem_used)},
+	{qc_mem_total, integer64, offsetof(struct qc_zvm_guest_values, mem_total)},
+	{qc_mem_limit, integer64, offsetof(struct qc_zvm_guest_values, mem_limit)},
+	{qc_mem_effective, integer64, offsetof(struct qc_zvm_guest_values, mem_effective)},
+	{qc_mem_limiting_layer, integer, offsetof(struct qc_zvm_guest_values, mem_limiting_layer)},
 	{-1, string, -1}
 };
 
@@ -404,6 +834,118 @@ static struct qc_attr kvm_guest_attrs[] = {
 	{qc_num_ifl_dedicated, integer, offsetof(struct qc_kvm_guest_values, num_ifl_dedicated)},
 	{qc_num_ifl_shared, integer, offsetof(struct qc_kvm_guest_values, num_ifl_shared)},
 	{qc_ifl_dispatch_type, integer, offsetof(struct qc_kvm_guest_values, ifl_dispatch_type)},
+	{qc_utilization, floatingpoint, offsetof(struct qc_kvm_guest_values, utilization)},
+	{qc_cpu_consumption, integer, offsetof(struct qc_kvm_guest_values, cpu_consumption)},
+	{qc_steal, floatingpoint, offsetof(struct qc_kvm_guest_values, steal)},
+	{qc_cp_effective_capacity, integer, offsetof(struct qc_kvm_guest_values, cp_effective_capacity)},
+	{qc_ifl_effective_capacity, integer, offsetof(struct qc_kvm_guest_values, ifl_effective_capacity)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_kvm_guest_values, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_kvm_guest_values, ifl_guaranteed_capacity)},
+	{qc_cp_limiting_layer, integer, offsetof(struct qc_kvm_guest_values, cp_limiting_layer)},
+	{qc_ifl_limiting_layer, integer, offsetof(struct qc_kvm_guest_values, ifl_limiting_layer)},
+	{qc_cp_normalized_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, cp_normalized_capacity)},
+	{qc_ifl_normalized_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, ifl_normalized_capacity)},
+	{qc_normalized_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, normalized_capacity)},
+	{qc_cp_core_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, cp_core_equivalent_capacity)},
+	{qc_ifl_core_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, ifl_core_equivalent_capacity)},
+	{qc_cp_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, cp_thread_equivalent_capacity)},
+	{qc_ifl_thread_equivalent_capacity, floatingpoint, offsetof(struct qc_kvm_guest_values, ifl_thread_equivalent_capacity)},
+	{qc_mem_total, integer64, offsetof(struct qc_kvm_guest_values, mem_total)},
+	{qc_mem_limit, integer64, offsetof(struct qc_kvm_guest_values, mem_limit)},
+	{qc_mem_effective, integer64, offsetof(struct qc_kvm_guest_values, mem_effective)},
+	{qc_mem_limiting_layer, integer, offsetof(struct qc_kvm_guest_values, mem_limiting_layer)},
+	{-1, string, -1}
+};
+
+static struct qc_attr cpu_columns[] = {
+	{qc_cpu_address, integer, offsetof(struct qc_cpu_row, cpu_address)},
+	{qc_cpu_type, string, offsetof(struct qc_cpu_row, cpu_type), COLUMN_SIZE(qc_cpu_row, cpu_type)},
+	{qc_cpu_type_num, integer, offsetof(struct qc_cpu_row, cpu_type_num)},
+	{qc_dedicated, integer, offsetof(struct qc_cpu_row, dedicated)},
+	{qc_cpu_time, integer64, offsetof(struct qc_cpu_row, cpu_time)},
+	{qc_mgmt_time, integer64, offsetof(struct qc_cpu_row, mgmt_time)},
+	{qc_online_time, integer64, offsetof(struct qc_cpu_row, online_time)},
+	{qc_utilization, floatingpoint, offsetof(struct qc_cpu_row, utilization)},
+	{qc_steal_time, integer64, offsetof(struct qc_cpu_row, steal_time)},
+	{qc_steal, floatingpoint, offsetof(struct qc_cpu_row, steal)},
+	{-1, string, -1}
+};
+
+static struct qc_attr lpar_columns[] = {
+	{qc_layer_name, string, offsetof(struct qc_lpar_row, layer_name), COLUMN_SIZE(qc_lpar_row, layer_name)},
+	{qc_lpar_group_name, string, offsetof(struct qc_lpar_row, lpar_group_name), COLUMN_SIZE(qc_lpar_row, lpar_group_name)},
+	{qc_num_cp_total, integer, offsetof(struct qc_lpar_row, num_cp_total)},
+	{qc_num_cp_dedicated, integer, offsetof(struct qc_lpar_row, num_cp_dedicated)},
+	{qc_num_cp_shared, integer, offsetof(struct qc_lpar_row, num_cp_shared)},
+	{qc_num_ifl_total, integer, offsetof(struct qc_lpar_row, num_ifl_total)},
+	{qc_num_ifl_dedicated, integer, offsetof(struct qc_lpar_row, num_ifl_dedicated)},
+	{qc_num_ifl_shared, integer, offsetof(struct qc_lpar_row, num_ifl_shared)},
+	{qc_cp_weight, integer, offsetof(struct qc_lpar_row, cp_weight)},
+	{qc_ifl_weight, integer, offsetof(struct qc_lpar_row, ifl_weight)},
+	{qc_cp_absolute_capping, integer, offsetof(struct qc_lpar_row, cp_absolute_capping)},
+	{qc_ifl_absolute_capping, integer, offsetof(struct qc_lpar_row, ifl_absolute_capping)},
+	{qc_cp_group_capping, integer, offsetof(struct qc_lpar_row, cp_group_capping)},
+	{qc_ifl_group_capping, integer, offsetof(struct qc_lpar_row, ifl_group_capping)},
+	{qc_cp_time, integer64, offsetof(struct qc_lpar_row, cp_time)},
+	{qc_ifl_time, integer64, offsetof(struct qc_lpar_row, ifl_time)},
+	{qc_cp_consumption, integer, offsetof(struct qc_lpar_row, cp_consumption)},
+	{qc_ifl_consumption, integer, offsetof(struct qc_lpar_row, ifl_consumption)},
+	{qc_num_ziip_total, integer, offsetof(struct qc_lpar_row, num_ziip_total)},
+	{qc_num_ziip_dedicated, integer, offsetof(struct qc_lpar_row, num_ziip_dedicated)},
+	{qc_num_ziip_shared, integer, offsetof(struct qc_lpar_row, num_ziip_shared)},
+	{qc_num_icf_total, integer, offsetof(struct qc_lpar_row, num_icf_total)},
+	{qc_num_icf_dedicated, integer, offsetof(struct qc_lpar_row, num_icf_dedicated)},
+	{qc_num_icf_shared, integer, offsetof(struct qc_lpar_row, num_icf_shared)},
+	{qc_ziip_weight, integer, offsetof(struct qc_lpar_row, ziip_weight)},
+	{qc_icf_weight, integer, offsetof(struct qc_lpar_row, icf_weight)},
+	{qc_ziip_absolute_capping, integer, offsetof(struct qc_lpar_row, ziip_absolute_capping)},
+	{qc_icf_absolute_capping, integer, offsetof(struct qc_lpar_row, icf_absolute_capping)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_lpar_row, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_lpar_row, ifl_guaranteed_capacity)},
+	{-1, string, -1}
+};
+
+static struct qc_attr zvm_guest_columns[] = {
+	{qc_layer_name, string, offsetof(struct qc_zvm_guest_row, layer_name), COLUMN_SIZE(qc_zvm_guest_row, layer_name)},
+	{qc_num_cpu_total, integer, offsetof(struct qc_zvm_guest_row, num_cpu_total)},
+	{qc_cpu_time, integer64, offsetof(struct qc_zvm_guest_row, cpu_time)},
+	{qc_online_time, integer64, offsetof(struct qc_zvm_guest_row, online_time)},
+	{qc_cpu_max, integer, offsetof(struct qc_zvm_guest_row, cpu_max)},
+	{qc_cpu_shares, integer, offsetof(struct qc_zvm_guest_row, cpu_shares)},
+	{qc_mem_min, integer64, offsetof(struct qc_zvm_guest_row, mem_min)},
+	{qc_mem_max, integer64, offsetof(struct qc_zvm_guest_row, mem_max)},
+	{qc_mem_share, integer64, offsetof(struct qc_zvm_guest_row, mem_share)},
+	{qc_mem_used, integer64, offsetof(struct qc_zvm_guest_row, mem_used)},
+	{qc_cpu_use_samples, integer64, offsetof(struct qc_zvm_guest_row, cpu_use_samples)},
+	{qc_cpu_delay_samples, integer64, offsetof(struct qc_zvm_guest_row, cpu_delay_samples)},
+	{qc_page_wait_samples, integer64, offsetof(struct qc_zvm_guest_row, page_wait_samples)},
+	{qc_idle_samples, integer64, offsetof(struct qc_zvm_guest_row, idle_samples)},
+	{qc_other_samples, integer64, offsetof(struct qc_zvm_guest_row, other_samples)},
+	{qc_total_samples, integer64, offsetof(struct qc_zvm_guest_row, total_samples)},
+	{qc_cp_guaranteed_capacity, integer, offsetof(struct qc_zvm_guest_row, cp_guaranteed_capacity)},
+	{qc_ifl_guaranteed_capacity, integer, offsetof(struct qc_zvm_guest_row, ifl_guaranteed_capacity)},
+	{-1, string, -1}
+};
+
+static struct qc_attr kvm_guest_columns[] = {
+	{qc_layer_name, string, offsetof(struct qc_kvm_guest_row, layer_name), COLUMN_SIZE(qc_kvm_guest_row, layer_name)},
+	{qc_num_cpu_total, integer, offsetof(struct qc_kvm_guest_row, num_cpu_total)},
+	{qc_cpu_time, integer64, offsetof(struct qc_kvm_guest_row, cpu_time)},
+	{qc_online_time, integer64, offsetof(struct qc_kvm_guest_row, online_time)},
+	{qc_overcommit, floatingpoint, offsetof(struct qc_kvm_guest_row, overcommit)},
+	{qc_cpu_consumption, integer, offsetof(struct qc_kvm_guest_row, cpu_consumption)},
+	{qc_utilization, floatingpoint, offsetof(struct qc_kvm_guest_row, utilization)},
+	{-1, string, -1}
+};
+
+static struct qc_attr topology_columns[] = {
+	{qc_cpu_address, integer, offsetof(struct qc_topology_row, cpu_address)},
+	{qc_polarization, string, offsetof(struct qc_topology_row, polarization), COLUMN_SIZE(qc_topology_row, polarization)},
+	{qc_polarization_num, integer, offsetof(struct qc_topology_row, polarization_num)},
+	{qc_drawer_id, integer, offsetof(struct qc_topology_row, drawer_id)},
+	{qc_book_id, integer, offsetof(struct qc_topology_row, book_id)},
+	{qc_socket_id, integer, offsetof(struct qc_topology_row, socket_id)},
+	{qc_core_id, integer, offsetof(struct qc_topology_row, core_id)},
 	{-1, string, -1}
 };
 
@@ -473,6 +1015,84 @@ const char *qc_attr_id_to_char(struct qc_handle *hdl, enum qc_attr_id id) {
 	case qc_num_core_reserved: return "num_core_reserved";
 	case qc_num_core_dedicated: return "num_core_dedicated";
 	case qc_num_core_shared: return "num_core_shared";
+	case qc_cp_utilization: return "cp_utilization";
+	case qc_ifl_utilization: return "ifl_utilization";
+	case qc_cp_consumption: return "cp_consumption";
+	case qc_ifl_consumption: return "ifl_consumption";
+	case qc_cpu_address: return "cpu_address";
+	case qc_cpu_type: return "cpu_type";
+	case qc_cpu_type_num: return "cpu_type_num";
+	case qc_dedicated: return "dedicated";
+	case qc_cpu_time: return "cpu_time";
+	case qc_mgmt_time: return "mgmt_time";
+	case qc_online_time: return "online_time";
+	case qc_utilization: return "utilization";
+	case qc_lpar_group_name: return "lpar_group_name";
+	case qc_cp_weight: return "cp_weight";
+	case qc_ifl_weight: return "ifl_weight";
+	case qc_cp_group_capping: return "cp_group_capping";
+	case qc_ifl_group_capping: return "ifl_group_capping";
+	case qc_cpu_max: return "cpu_max";
+	case qc_cpu_shares: return "cpu_shares";
+	case qc_mem_min: return "mem_min";
+	case qc_mem_max: return "mem_max";
+	case qc_mem_share: return "mem_share";
+	case qc_mem_used: return "mem_used";
+	case qc_cpu_consumption: return "cpu_consumption";
+	case qc_cpu_delay: return "cpu_delay";
+	case qc_page_wait: return "page_wait";
+	case qc_cpu_use_samples: return "cpu_use_samples";
+	case qc_cpu_delay_samples: return "cpu_delay_samples";
+	case qc_page_wait_samples: return "page_wait_samples";
+	case qc_idle_samples: return "idle_samples";
+	case qc_other_samples: return "other_samples";
+	case qc_total_samples: return "total_samples";
+	case qc_steal_time: return "steal_time";
+	case qc_steal: return "steal";
+	case qc_overcommit: return "overcommit";
+	case qc_cp_time: return "cp_time";
+	case qc_ifl_time: return "ifl_time";
+	case qc_num_ziip_total: return "num_ziip_total";
+	case qc_num_ziip_dedicated: return "num_ziip_dedicated";
+	case qc_num_ziip_shared: return "num_ziip_shared";
+	case qc_num_icf_total: return "num_icf_total";
+	case qc_num_icf_dedicated: return "num_icf_dedicated";
+	case qc_num_icf_shared: return "num_icf_shared";
+	case qc_ziip_absolute_capping: return "ziip_absolute_capping";
+	case qc_icf_absolute_capping: return "icf_absolute_capping";
+	case qc_ziip_weight_capping: return "ziip_weight_capping";
+	case qc_icf_weight_capping: return "icf_weight_capping";
+	case qc_ziip_weight: return "ziip_weight";
+	case qc_icf_weight: return "icf_weight";
+	case qc_polarization: return "polarization";
+	case qc_polarization_num: return "polarization_num";
+	case qc_drawer_id: return "drawer_id";
+	case qc_book_id: return "book_id";
+	case qc_socket_id: return "socket_id";
+	case qc_core_id: return "core_id";
+	case qc_num_cpu_horizontal: return "num_cpu_horizontal";
+	case qc_num_cpu_vertical_low: return "num_cpu_vertical_low";
+	case qc_num_cpu_vertical_medium: return "num_cpu_vertical_medium";
+	case qc_num_cpu_vertical_high: return "num_cpu_vertical_high";
+	case qc_num_drawers: return "num_drawers";
+	case qc_num_core_per_drawer: return "num_core_per_drawer";
+	case qc_cp_effective_capacity: return "cp_effective_capacity";
+	case qc_ifl_effective_capacity: return "ifl_effective_capacity";
+	case qc_cp_guaranteed_capacity: return "cp_guaranteed_capacity";
+	case qc_ifl_guaranteed_capacity: return "ifl_guaranteed_capacity";
+	case qc_cp_limiting_layer: return "cp_limiting_layer";
+	case qc_ifl_limiting_layer: return "ifl_limiting_layer";
+	case qc_cp_normalized_capacity: return "cp_normalized_capacity";
+	case qc_ifl_normalized_capacity: return "ifl_normalized_capacity";
+	case qc_normalized_capacity: return "normalized_capacity";
+	case qc_cp_core_equivalent_capacity: return "cp_core_equivalent_capacity";
+	case qc_ifl_core_equivalent_capacity: return "ifl_core_equivalent_capacity";
+	case qc_cp_thread_equivalent_capacity: return "cp_thread_equivalent_capacity";
+	case qc_ifl_thread_equivalent_capacity: return "ifl_thread_equivalent_capacity";
+	case qc_mem_total: return "mem_total";
+	case qc_mem_limit: return "mem_limit";
+	case qc_mem_effective: return "mem_effective";
+	case qc_mem_limiting_layer: return "mem_limiting_layer";
 	default: break;
 	}
 	qc_debug(hdl, "Error: Cannot convert unknown attribute '%d' to char*\n", id);
@@ -480,6 +1100,20 @@ const char *qc_attr_id_to_char(struct qc_handle *hdl, enum qc_attr_id id) {
 	return NULL;
 }
 
+const char *qc_table_id_to_char(struct qc_handle *hdl, enum qc_table_id id) {
+	switch (id) {
+	case qc_table_cpus: return "cpus";
+	case qc_table_lpars: return "lpars";
+	case qc_table_zvm_guests: return "zvm_guests";
+	case qc_table_kvm_guests: return "kvm_guests";
+	case qc_table_topology: return "topology";
+	default: break;
+	}
+	qc_debug(hdl, "Error: Cannot convert unknown table '%d' to char*\n", id);
+
+	return NULL;
+}
+
 // 'hdl' is for error reporting, as 'tgthdl' might not be part of the pointer lists yet
 int qc_new_handle(struct qc_handle *hdl, struct qc_handle **tgthdl, int layer_no,
 		  int layer_type_num) {
@@ -583,6 +1217,7 @@ int qc_new_handle(struct qc_handle *hdl, struct qc_handle **tgthdl, int layer_no
 		return -3;
 	}
 	memset((*tgthdl)->layer, 0, layer_sz);
+	(*tgthdl)->layer_sz = layer_sz;
 	(*tgthdl)->attr_present = calloc(num_attrs, sizeof(int));
 	(*tgthdl)->src = calloc(num_attrs, sizeof(int));
 	if (!(*tgthdl)->attr_present || !(*tgthdl)->src) {
@@ -631,6 +1266,20 @@ int qc_append_handle(struct qc_handle *hdl, struct qc_handle **appended_hdl, int
 	return 0;
 }
 
+int qc_copy_handle(struct qc_handle *hdl, struct qc_handle **tgthdl, struct qc_handle *src) {
+	int num_attrs;
+
+	if (qc_new_handle(hdl, tgthdl, src->layer_no, *(int *)(src->layer)))
+		return -1;
+	for (num_attrs = 0; src->attr_list[num_attrs].offset >= 0; ++num_attrs);
+	num_attrs++;
+	memcpy((*tgthdl)->layer, src->layer, src->layer_sz);
+	memcpy((*tgthdl)->attr_present, src->attr_present, num_attrs * sizeof(int));
+	memcpy((*tgthdl)->src, src->src, num_attrs);
+
+	return 0;
+}
+
 #ifdef CONFIG_V1_COMPATIBILITY
 /* Maps qc_num_cpu_* to qc_num_core_* attributes where required to preserve backwards compatibility.
  * Should be removed in a qclib v2.0 release. */
@@ -726,6 +1375,24 @@ int qc_set_attr_float(struct qc_handle *hdl, enum qc_attr_id id, float val, char
 	return 0;
 }
 
+// Sets attribute 'id' in layer as pointed to by 'hdl'
+int qc_set_attr_int64(struct qc_handle *hdl, enum qc_attr_id id, int64_t val, char src) {
+	char orig_src = qc_get_attr_value_src_int64(hdl, id);
+	int64_t *ptr;
+	int prev_set;
+
+	if ((ptr = (int64_t *)qc_set_attr(hdl, id, integer64, src, &prev_set)) == NULL)
+		return -1;
+	if (qc_consistency_check_requested && prev_set && *ptr != val) {
+		qc_debug(hdl, "Error: Consistency at layer %d: Attr %s had value %" PRId64 " from %c, try to set to %" PRId64 " from %c\n",
+			 hdl->layer_no, qc_attr_id_to_char(hdl, id), *ptr, orig_src, val, src);
+		return -2;
+	}
+	*ptr = val;
+
+	return 0;
+}
+
 // Sets string attribute 'id' in layer as pointed to by 'hdl', stripping trailing blanks, but
 // leaving the original string unmodified
 int qc_set_attr_string(struct qc_handle *hdl, enum qc_attr_id id, const char *str, unsigned int str_len, char src) {
@@ -782,6 +1449,15 @@ int qc_set_attr_ebcdic_string(struct qc_handle *hdl, enum qc_attr_id id, unsigne
 	return rc;
 }
 
+void qc_unset_attr(struct qc_handle *hdl, enum qc_attr_id id) {
+	struct qc_attr *attr_list = hdl->attr_list;
+	int count;
+
+	for (count = 0; attr_list[count].offset >= 0; ++count)
+		if (attr_list[count].id == id)
+			hdl->attr_present[count] = 0;
+}
+
 int qc_is_nonempty_ebcdic(__u64 *str) {
 	// CPU Pools in STHYI have all EBCDIC spaces if not set
 	return *str != 0x0 && *str != 0x4040404040404040ULL;
@@ -805,6 +1481,10 @@ int qc_is_attr_set_int(struct qc_handle *hdl, enum qc_attr_id id) {
 	return qc_is_attr_set(hdl, id, integer);
 }
 
+int qc_is_attr_set_int64(struct qc_handle *hdl, enum qc_attr_id id) {
+	return qc_is_attr_set(hdl, id, integer64);
+}
+
 int qc_is_attr_set_float(struct qc_handle *hdl, enum qc_attr_id id) {
 	return qc_is_attr_set(hdl, id, floatingpoint);
 }
@@ -857,6 +1537,10 @@ int *qc_get_attr_value_int(struct qc_handle *hdl, enum qc_attr_id id) {
 	return (int *)qc_get_attr_value(hdl, id, integer);
 }
 
+int64_t *qc_get_attr_value_int64(struct qc_handle *hdl, enum qc_attr_id id) {
+	return (int64_t *)qc_get_attr_value(hdl, id, integer64);
+}
+
 float *qc_get_attr_value_float(struct qc_handle *hdl, enum qc_attr_id id) {
 	return (float *)qc_get_attr_value(hdl, id, floatingpoint);
 }
@@ -881,6 +1565,10 @@ char qc_get_attr_value_src_int(struct qc_handle *hdl, enum qc_attr_id id) {
 	return qc_get_attr_value_src(hdl, id, integer);
 }
 
+char qc_get_attr_value_src_int64(struct qc_handle *hdl, enum qc_attr_id id) {
+	return qc_get_attr_value_src(hdl, id, integer64);
+}
+
 char qc_get_attr_value_src_float(struct qc_handle *hdl, enum qc_attr_id id) {
 	return qc_get_attr_value_src(hdl, id, floatingpoint);
 }
@@ -888,3 +1576,318 @@ char qc_get_attr_value_src_float(struct qc_handle *hdl, enum qc_attr_id id) {
 char qc_get_attr_value_src_string(struct qc_handle *hdl, enum qc_attr_id id) {
 	return qc_get_attr_value_src(hdl, id, string);
 }
+
+// Allocates table 'id' with 'num_rows' empty rows, and attaches it to layer 'hdl'
+int qc_new_table(struct qc_handle *hdl, enum qc_table_id id, int num_rows, struct qc_table **tbl) {
+	struct qc_attr *attrs;
+	size_t row_sz;
+
+	switch (id) {
+	case qc_table_cpus:
+		row_sz = sizeof(struct qc_cpu_row);
+		attrs = cpu_columns;
+		break;
+	case qc_table_lpars:
+		row_sz = sizeof(struct qc_lpar_row);
+		attrs = lpar_columns;
+		break;
+	case qc_table_zvm_guests:
+		row_sz = sizeof(struct qc_zvm_guest_row);
+		attrs = zvm_guest_columns;
+		break;
+	case qc_table_kvm_guests:
+		row_sz = sizeof(struct qc_kvm_guest_row);
+		attrs = kvm_guest_columns;
+		break;
+	case qc_table_topology:
+		row_sz = sizeof(struct qc_topology_row);
+		attrs = topology_columns;
+		break;
+	default:
+		qc_debug(hdl, "Error: Unhandled table in qc_new_table()\n");
+		return -1;
+	}
+	*tbl = malloc(sizeof(struct qc_table));
+	if (!*tbl) {
+		qc_debug(hdl, "Error: Failed to allocate table\n");
+		return -2;
+	}
+	memset(*tbl, 0, sizeof(struct qc_table));
+	(*tbl)->id = id;
+	(*tbl)->hdl = hdl;
+	(*tbl)->attr_list = attrs;
+	for ((*tbl)->num_attrs = 0; attrs[(*tbl)->num_attrs].offset >= 0; ++(*tbl)->num_attrs);
+	(*tbl)->row_sz = row_sz;
+	(*tbl)->num_rows = num_rows;
+	// allocate at least one row, so we can tell allocation errors apart
+	(*tbl)->rows = calloc(num_rows ? num_rows : 1, row_sz);
+	(*tbl)->attr_present = calloc(num_rows ? num_rows * (*tbl)->num_attrs : 1, sizeof(char));
+	if (!(*tbl)->rows || !(*tbl)->attr_present) {
+		qc_debug(hdl, "Error: Failed to allocate %d rows of table %s\n", num_rows, qc_table_id_to_char(hdl, id));
+		free((*tbl)->rows);
+		free((*tbl)->attr_present);
+		free(*tbl);
+		*tbl = NULL;
+		return -3;
+	}
+	(*tbl)->next = hdl->tables;
+	hdl->tables = *tbl;
+
+	return 0;
+}
+
+// Attaches a copy of table 'src' to layer 'hdl'
+int qc_copy_table(struct qc_handle *hdl, struct qc_table *src) {
+	struct qc_table *tbl;
+
+	if (qc_new_table(hdl, src->id, src->num_rows, &tbl))
+		return -1;
+	memcpy(tbl->rows, src->rows, src->num_rows * src->row_sz);
+	memcpy(tbl->attr_present, src->attr_present, src->num_rows * src->num_attrs);
+	tbl->timestamp = src->timestamp;
+	tbl->shared_cp_time = src->shared_cp_time;
+	tbl->shared_ifl_time = src->shared_ifl_time;
+	if (src->index && qc_index_table(tbl, src->index_id))
+		return -2;
+
+	return 0;
+}
+
+struct qc_table *qc_get_table(struct qc_handle *hdl, enum qc_table_id id) {
+	struct qc_table *tbl;
+
+	for (tbl = hdl->tables; tbl && tbl->id != id; tbl = tbl->next);
+
+	return tbl;
+}
+
+void qc_free_tables(struct qc_handle *hdl) {
+	struct qc_table *tbl, *next;
+
+	for (tbl = hdl->tables; tbl; tbl = next) {
+		next = tbl->next;
+		free(tbl->rows);
+		free(tbl->attr_present);
+		free(tbl->index);
+		free(tbl);
+	}
+	hdl->tables = NULL;
+}
+
+static int qc_get_row_attr_idx(struct qc_table *tbl, enum qc_attr_id id, enum qc_data_type type) {
+	int idx;
+
+	for (idx = 0; idx < tbl->num_attrs; ++idx)
+		if (tbl->attr_list[idx].id == id && tbl->attr_list[idx].type == type)
+			return idx;
+
+	return -1;
+}
+
+// Indicates the attribute in row 'row' as 'set', returning a ptr to its content
+static char *qc_set_row_attr(struct qc_table *tbl, int row, enum qc_attr_id id, enum qc_data_type type) {
+	int idx;
+
+	if (row < 0 || row >= tbl->num_rows || (idx = qc_get_row_attr_idx(tbl, id, type)) < 0) {
+		qc_debug(tbl->hdl, "Error: Failed to set attr=%s in row %d of table %s (not found)\n",
+			 qc_attr_id_to_char(tbl->hdl, id), row, qc_table_id_to_char(tbl->hdl, tbl->id));
+		return NULL;
+	}
+	tbl->attr_present[row * tbl->num_attrs + idx] = 1;
+
+	return tbl->rows + row * tbl->row_sz + tbl->attr_list[idx].offset;
+}
+
+int qc_set_row_attr_int(struct qc_table *tbl, int row, enum qc_attr_id id, int val) {
+	int *ptr;
+
+	if ((ptr = (int *)qc_set_row_attr(tbl, row, id, integer)) == NULL)
+		return -1;
+	*ptr = val;
+
+	return 0;
+}
+
+int qc_set_row_attr_int64(struct qc_table *tbl, int row, enum qc_attr_id id, int64_t val) {
+	int64_t *ptr;
+
+	if ((ptr = (int64_t *)qc_set_row_attr(tbl, row, id, integer64)) == NULL)
+		return -1;
+	*ptr = val;
+
+	return 0;
+}
+
+int qc_set_row_attr_float(struct qc_table *tbl, int row, enum qc_attr_id id, float val) {
+	float *ptr;
+
+	if ((ptr = (float *)qc_set_row_attr(tbl, row, id, floatingpoint)) == NULL)
+		return -1;
+	*ptr = val;
+
+	return 0;
+}
+
+// Note: 'str' is truncated to the size of the column
+int qc_set_row_attr_string(struct qc_table *tbl, int row, enum qc_attr_id id, const char *str) {
+	char *ptr, *s;
+	int size;
+
+	if ((ptr = qc_set_row_attr(tbl, row, id, string)) == NULL)
+		return -1;
+	size = tbl->attr_list[qc_get_row_attr_idx(tbl, id, string)].size;
+	if ((int)strlen(str) >= size)
+		qc_debug(tbl->hdl, "Warning: Truncating '%s' to %d characters in attr=%s of table %s\n", str, size - 1,
+			 qc_attr_id_to_char(tbl->hdl, id), qc_table_id_to_char(tbl->hdl, tbl->id));
+	snprintf(ptr, size, "%s", str);
+	// strip trailing blanks
+	for (s = ptr + strlen(ptr); s > ptr && (s[-1] == ' ' || s[-1] == '\n'); --s)
+		s[-1] = '\0';
+
+	return 0;
+}
+
+int qc_set_row_attr_ebcdic_string(struct qc_table *tbl, int row, enum qc_attr_id id, unsigned char *str,
+				  unsigned int str_len) {
+	char buf[STR_BUF_SIZE];
+	int rc;
+
+	if (str_len >= STR_BUF_SIZE)
+		return -1;
+	memset(buf, '\0', str_len + 1);
+	memcpy(buf, str, str_len);
+	if ((rc = qc_ebcdic_to_ascii(tbl->hdl, buf, str_len)) == 0) {
+		if (strlen(buf) && qc_set_row_attr_string(tbl, row, id, buf))
+			rc = -2;
+	}
+
+	return rc;
+}
+
+void qc_unset_row_attr(struct qc_table *tbl, int row, enum qc_attr_id id) {
+	int idx;
+
+	for (idx = 0; idx < tbl->num_attrs; ++idx)
+		if (tbl->attr_list[idx].id == id)
+			tbl->attr_present[row * tbl->num_attrs + idx] = 0;
+}
+
+static void *qc_get_row_attr_value(struct qc_table *tbl, int row, enum qc_attr_id id, enum qc_data_type type) {
+	int idx;
+
+	if (row < 0 || row >= tbl->num_rows || (idx = qc_get_row_attr_idx(tbl, id, type)) < 0 ||
+	    !tbl->attr_present[row * tbl->num_attrs + idx])
+		return NULL;
+
+	return tbl->rows + row * tbl->row_sz + tbl->attr_list[idx].offset;
+}
+
+int *qc_get_row_attr_value_int(struct qc_table *tbl, int row, enum qc_attr_id id) {
+	return (int *)qc_get_row_attr_value(tbl, row, id, integer);
+}
+
+int64_t *qc_get_row_attr_value_int64(struct qc_table *tbl, int row, enum qc_attr_id id) {
+	return (int64_t *)qc_get_row_attr_value(tbl, row, id, integer64);
+}
+
+float *qc_get_row_attr_value_float(struct qc_table *tbl, int row, enum qc_attr_id id) {
+	return (float *)qc_get_row_attr_value(tbl, row, id, floatingpoint);
+}
+
+char *qc_get_row_attr_value_string(struct qc_table *tbl, int row, enum qc_attr_id id) {
+	return (char *)qc_get_row_attr_value(tbl, row, id, string);
+}
+
+int qc_has_row_attr_int(struct qc_table *tbl, enum qc_attr_id id) {
+	return qc_get_row_attr_idx(tbl, id, integer) >= 0;
+}
+
+int qc_has_row_attr_int64(struct qc_table *tbl, enum qc_attr_id id) {
+	return qc_get_row_attr_idx(tbl, id, integer64) >= 0;
+}
+
+int qc_has_row_attr_float(struct qc_table *tbl, enum qc_attr_id id) {
+	return qc_get_row_attr_idx(tbl, id, floatingpoint) >= 0;
+}
+
+int qc_has_row_attr_string(struct qc_table *tbl, enum qc_attr_id id) {
+	return qc_get_row_attr_idx(tbl, id, string) >= 0;
+}
+
+int qc_copy_row(struct qc_table *tgt, int tgt_row, struct qc_table *src, int src_row) {
+	if (tgt->attr_list != src->attr_list) {
+		qc_debug(tgt->hdl, "Error: Cannot copy row between tables %s and %s\n",
+			 qc_table_id_to_char(tgt->hdl, tgt->id), qc_table_id_to_char(src->hdl, src->id));
+		return -1;
+	}
+	memcpy(tgt->rows + tgt_row * tgt->row_sz, src->rows + src_row * src->row_sz, src->row_sz);
+	memcpy(tgt->attr_present + tgt_row * tgt->num_attrs, src->attr_present + src_row * src->num_attrs,
+	       src->num_attrs);
+
+	return 0;
+}
+
+int qc_find_row_int(struct qc_table *tbl, enum qc_attr_id id, int val) {
+	int row, *ptr;
+
+	for (row = 0; row < tbl->num_rows; ++row)
+		if ((ptr = qc_get_row_attr_value_int(tbl, row, id)) != NULL && *ptr == val)
+			return row;
+
+	return -1;
+}
+
+// FNV-1a
+static unsigned int qc_hash_string(const char *str) {
+	unsigned int hash = 2166136261u;
+
+	for (; *str; ++str)
+		hash = (hash ^ (unsigned char)*str) * 16777619u;
+
+	return hash;
+}
+
+int qc_index_table(struct qc_table *tbl, enum qc_attr_id id) {
+	int row, sz, slot;
+	char *str;
+
+	if (qc_get_row_attr_idx(tbl, id, string) < 0)
+		return -1;
+	// keep the load factor below 50% so that probe sequences remain short
+	for (sz = 8; sz < 2 * tbl->num_rows; sz <<= 1);
+	free(tbl->index);
+	tbl->index = malloc(sz * sizeof(int));
+	if (!tbl->index) {
+		qc_debug(tbl->hdl, "Error: Failed to allocate index of table %s\n", qc_table_id_to_char(tbl->hdl, tbl->id));
+		return -2;
+	}
+	memset(tbl->index, -1, sz * sizeof(int));
+	tbl->index_sz = sz;
+	tbl->index_id = id;
+	for (row = 0; row < tbl->num_rows; ++row) {
+		if ((str = qc_get_row_attr_value_string(tbl, row, id)) == NULL)
+			continue;
+		for (slot = qc_hash_string(str) & (sz - 1); tbl->index[slot] >= 0; slot = (slot + 1) & (sz - 1));
+		tbl->index[slot] = row;
+	}
+
+	return 0;
+}
+
+int qc_find_row_string(struct qc_table *tbl, enum qc_attr_id id, const char *val) {
+	int row, slot;
+	char *str;
+
+	if (tbl->index && tbl->index_id == id) {
+		for (slot = qc_hash_string(val) & (tbl->index_sz - 1); (row = tbl->index[slot]) >= 0;
+		     slot = (slot + 1) & (tbl->index_sz - 1))
+			if (strcmp(qc_get_row_attr_value_string(tbl, row, id), val) == 0)
+				return row;
+		return -1;
+	}
+	for (row = 0; row < tbl->num_rows; ++row)
+		if ((str = qc_get_row_attr_value_string(tbl, row, id)) != NULL && strcmp(str, val) == 0)
+			return row;
+
+	return -1;
+}
@@ -14,21 +14,63 @@
 
 /* Functions to set and get attributes */
 int qc_set_attr_int(struct qc_handle *hdl, enum qc_attr_id id, int val, char src);
+int qc_set_attr_int64(struct qc_handle *hdl, enum qc_attr_id id, int64_t val, char src);
 int qc_set_attr_float(struct qc_handle *hdl, enum qc_attr_id id, float val, char src);
 int qc_set_attr_string(struct qc_handle *hdl, enum qc_attr_id id, const char *val, unsigned int val_len, char src);
 int qc_set_attr_ebcdic_string(struct qc_handle *hdl, enum qc_attr_id id, unsigned char *val, unsigned int val_len, char src);
 int qc_is_attr_set_int(struct qc_handle *hdl, enum qc_attr_id id);
+int qc_is_attr_set_int64(struct qc_handle *hdl, enum qc_attr_id id);
 int qc_is_attr_set_float(struct qc_handle *hdl, enum qc_attr_id id);
 int qc_is_attr_set_string(struct qc_handle *hdl, enum qc_attr_id id);
 
 const char *qc_attr_id_to_char(struct qc_handle *hdl, enum qc_attr_id id);
 
 int   *qc_get_attr_value_int(struct qc_handle *hdl, enum qc_attr_id id);
+int64_t *qc_get_attr_value_int64(struct qc_handle *hdl, enum qc_attr_id id);
 float *qc_get_attr_value_float(struct qc_handle *hdl, enum qc_attr_id id);
 char  *qc_get_attr_value_string(struct qc_handle *hdl, enum qc_attr_id id);
 
+// Marks attribute 'id' as unset, e.g. for recomputed values
+void qc_unset_attr(struct qc_handle *hdl, enum qc_attr_id id);
+
 // Result is undefined in case attribute doesn't exist
 char qc_get_attr_value_src_int(struct qc_handle *hdl, enum qc_attr_id id);
+char qc_get_attr_value_src_int64(struct qc_handle *hdl, enum qc_attr_id id);
 char qc_get_attr_value_src_float(struct qc_handle *hdl, enum qc_attr_id id);
 char qc_get_attr_value_src_string(struct qc_handle *hdl, enum qc_attr_id id);
+
+/* Functions to handle tables */
+int qc_new_table(struct qc_handle *hdl, enum qc_table_id id, int num_rows, struct qc_table **tbl);
+struct qc_table *qc_get_table(struct qc_handle *hdl, enum qc_table_id id);
+int qc_copy_table(struct qc_handle *hdl, struct qc_table *src);
+void qc_free_tables(struct qc_handle *hdl);
+const char *qc_table_id_to_char(struct qc_handle *hdl, enum qc_table_id id);
+
+int qc_set_row_attr_int(struct qc_table *tbl, int row, enum qc_attr_id id, int val);
+int qc_set_row_attr_int64(struct qc_table *tbl, int row, enum qc_attr_id id, int64_t val);
+int qc_set_row_attr_float(struct qc_table *tbl, int row, enum qc_attr_id id, float val);
+int qc_set_row_attr_string(struct qc_table *tbl, int row, enum qc_attr_id id, const char *val);
+int qc_set_row_attr_ebcdic_string(struct qc_table *tbl, int row, enum qc_attr_id id, unsigned char *val, unsigned int val_len);
+void qc_unset_row_attr(struct qc_table *tbl, int row, enum qc_attr_id id);
+
+// Return NULL if the table has no such column, or the attribute is not set
+int     *qc_get_row_attr_value_int(struct qc_table *tbl, int row, enum qc_attr_id id);
+int64_t *qc_get_row_attr_value_int64(struct qc_table *tbl, int row, enum qc_attr_id id);
+float   *qc_get_row_attr_value_float(struct qc_table *tbl, int row, enum qc_attr_id id);
+char    *qc_get_row_attr_value_string(struct qc_table *tbl, int row, enum qc_attr_id id);
+// Returns whether table 'tbl' has a column 'id' of the respective type
+int qc_has_row_attr_int(struct qc_table *tbl, enum qc_attr_id id);
+int qc_has_row_attr_int64(struct qc_table *tbl, enum qc_attr_id id);
+int qc_has_row_attr_float(struct qc_table *tbl, enum qc_attr_id id);
+int qc_has_row_attr_string(struct qc_table *tbl, enum qc_attr_id id);
+
+// Copies row 'src_row' of table 'src' to row 'tgt_row' of table 'tgt' of the same type
+int qc_copy_row(struct qc_table *tgt, int tgt_row, struct qc_table *src, int src_row);
+// Returns the index of the first row with int attribute 'id' set to 'val', or -1 if there is none
+int qc_find_row_int(struct qc_table *tbl, enum qc_attr_id id, int val);
+// Builds a hash index on string attribute 'id', speeding up qc_find_row_string().
+// Must be called after all rows are filled in.
+int qc_index_table(struct qc_table *tbl, enum qc_attr_id id);
+// Returns the index of the first row with string attribute 'id' set to 'val', or -1 if there is none
+int qc_find_row_string(struct qc_table *tbl, enum qc_attr_id id, const char *val);
 #endif
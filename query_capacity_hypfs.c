@@ -17,8 +17,6 @@
 #define QC_HYPFS_LPAR		"/s390_hypfs/diag_204"
 #define QC_HYPFS_ZVM		"/s390_hypfs/diag_2fc"
 #define QC_NAME_LEN		8
-#define QC_CPU_TYPE_CP		0
-#define QC_CPU_TYPE_IFL		3
 
 #define QC_FLAG_PHYS		0x80
 #define QC_CPU_DEDICATED	0xffff
@@ -364,14 +362,113 @@ out:
 }
 #endif
 
+// Returns the name of CPU type 'ctidx', or NULL if unknown
+static const char *qc_get_cpu_type_name(int ctidx) {
+	switch (ctidx) {
+	case QC_CPU_TYPE_CP: return "CP";
+	case QC_CPU_TYPE_ZAAP: return "zAAP";
+	case QC_CPU_TYPE_IFL: return "IFL";
+	case QC_CPU_TYPE_ICF: return "ICF";
+	case QC_CPU_TYPE_ZIIP: return "zIIP";
+	default: break;
+	}
+
+	return NULL;
+}
+
+// Fills in table 'cpus' with the configured CPUs of the LPAR described by 'sys_hdr', or
+// with the physical CPUs if 'phys' is set
+static int qc_fill_in_hypfs_cpu_table(struct qc_handle *hdl, struct dfs_info_blk_hdr *time_hdr,
+				      struct dfs_sys_hdr *sys_hdr, int phys, struct qc_table **tbl) {
+	int i, num = 0, row = 0, num_cpus;
+	struct dfs_cpu_info *cpu;
+	const char *type;
+	__u64 acc, lp;
+
+	// physical CPUs have no flags, and the accumulated time is the management time
+	num_cpus = phys ? sys_hdr->cpus : sys_hdr->rcpus;
+	cpu = (struct dfs_cpu_info *)(sys_hdr + 1);
+	for (i = 0; i < num_cpus; ++i, ++cpu)
+		if (phys || cpu->cflag & QC_CPU_CONFIGURED)
+			num++;
+	if (qc_new_table(hdl, qc_table_cpus, num, tbl))
+		return -1;
+	// TOD clock bit 51 is incremented every microsecond
+	(*tbl)->timestamp = htobe64(time_hdr->curtod1) >> 12;
+	cpu = (struct dfs_cpu_info *)(sys_hdr + 1);
+	for (i = 0; i < num_cpus; ++i, ++cpu) {
+		if (!phys && !(cpu->cflag & QC_CPU_CONFIGURED))
+			continue;
+		acc = htobe64(cpu->acc_time);
+		lp = htobe64(cpu->lp_time);
+		if (qc_set_row_attr_int(*tbl, row, qc_cpu_address, htobe16(cpu->cpu_addr)) ||
+		    qc_set_row_attr_int(*tbl, row, qc_cpu_type_num, cpu->ctidx) ||
+		    qc_set_row_attr_int(*tbl, row, qc_dedicated, cpu->weight == QC_CPU_DEDICATED))
+			return -2;
+		if (phys) {
+			if (qc_set_row_attr_int64(*tbl, row, qc_mgmt_time, acc))
+				return -3;
+		} else if (qc_set_row_attr_int64(*tbl, row, qc_cpu_time, lp) ||
+			   qc_set_row_attr_int64(*tbl, row, qc_mgmt_time, acc > lp ? acc - lp : 0) ||
+			   qc_set_row_attr_int64(*tbl, row, qc_online_time, htobe64(cpu->online_time)))
+			return -4;
+		if ((type = qc_get_cpu_type_name(cpu->ctidx)) != NULL && qc_set_row_attr_string(*tbl, row, qc_cpu_type, type))
+			return -5;
+		row++;
+	}
+	qc_debug(hdl, "Added %d CPUs to table\n", num);
+
+	return 0;
+}
+
+// Fills in table 'lpars' of LPAR group layer 'group' with the members of the group as listed in
+// table 'lpars' of the CEC layer, and sums up their cores and weights
+static int qc_fill_in_hypfs_lpar_group(struct qc_handle *group) {
+	enum qc_attr_id ids[] = {qc_num_cp_total, qc_num_cp_shared, qc_num_ifl_total, qc_num_ifl_shared,
+				 qc_cp_weight, qc_ifl_weight};
+	int sums[sizeof(ids) / sizeof(ids[0])] = {0}, num = 0, row, i, *val;
+	struct qc_table *cec_tbl, *tbl;
+	char *name, *grp;
+
+	if ((name = qc_get_attr_value_string(group, qc_layer_name)) == NULL ||
+	    (cec_tbl = qc_get_table(qc_get_cec_handle(group), qc_table_lpars)) == NULL)
+		return 0;
+	for (row = 0; row < cec_tbl->num_rows; ++row)
+		if ((grp = qc_get_row_attr_value_string(cec_tbl, row, qc_lpar_group_name)) != NULL && !strcmp(grp, name))
+			num++;
+	if (qc_new_table(group, qc_table_lpars, num, &tbl))
+		return -1;
+	tbl->timestamp = cec_tbl->timestamp;
+	for (row = 0, num = 0; row < cec_tbl->num_rows; ++row) {
+		if ((grp = qc_get_row_attr_value_string(cec_tbl, row, qc_lpar_group_name)) == NULL || strcmp(grp, name))
+			continue;
+		if (qc_copy_row(tbl, num++, cec_tbl, row))
+			return -2;
+		for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); ++i)
+			if ((val = qc_get_row_attr_value_int(cec_tbl, row, ids[i])) != NULL)
+				sums[i] += *val;
+	}
+	if (qc_index_table(tbl, qc_layer_name))
+		return -3;
+	qc_debug(group, "Added %d members of LPAR group '%s' to table\n", num, name);
+	for (i = 0; i < (int)(sizeof(ids) / sizeof(ids[0])); ++i)
+		if (qc_set_attr_int(group, ids[i], sums[i], ATTR_SRC_HYPFS))
+			return -4;
+
+	return 0;
+}
+
 static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 	int ifl = 0, cp = 0, ifl_ded = 0, cp_ded = 0, ifl_cap = 0, cp_cap = 0, ifl_weight = 0,
 	    cp_weight = 0, ifl_abs_cap = 0, cp_abs_cap = 0, cp_all_weight = 0, ifl_all_weight = 0,
 	    cp_w, ifl_w, un = 0, *ifl_sh, *cp_sh, i, j, rc = -1, gpd_available;
+	int ziip = 0, icf = 0, ziip_ded = 0, icf_ded = 0, ziip_weight = 0, icf_weight = 0, ziip_abs_cap = 0,
+	    icf_abs_cap = 0, ziip_all_weight = 0, icf_all_weight = 0, ziip_w, icf_w, *ziip_sh, *icf_sh;
 	struct dfs_info_blk_hdr *time_hdr;
 	struct dfs_sys_hdr *sys_hdr, *tgt_lpar;
 	struct dfs_cpu_info *cpu;
 	struct qc_handle *group;
+	struct qc_table *tbl;
 	int cap_active = 0;
 
 	qc_debug(hdl, "Add LPAR values from binary hypfs API\n");
@@ -383,7 +480,7 @@ static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 	qc_debug(hdl, "Found data for %d LPAR(s), GPD data is %savailable\n", time_hdr->npar, gpd_available ? "" : "NOT ");
 	for (i = 0; i < time_hdr->npar; ++i) {
 		cpu = (struct dfs_cpu_info*)(sys_hdr + 1);
-		cp_w = ifl_w = 0;
+		cp_w = ifl_w = ziip_w = icf_w = 0;
 		for (j = 0; j < sys_hdr->rcpus; ++j, ++cpu) {
 			if (!(cpu->cflag & QC_CPU_CONFIGURED))
 				continue;
@@ -416,6 +513,30 @@ static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 				if (cpu->weight != QC_CPU_DEDICATED)
 					ifl_w = htobe16(cpu->weight);
 				break;
+			case QC_CPU_TYPE_ZIIP:
+				if (sys_hdr == tgt_lpar) {
+					ziip++;
+					ziip_abs_cap = htobe32(cpu->cpuTypeCap);
+					if (cpu->weight == QC_CPU_DEDICATED)
+						ziip_ded++;
+					else
+						ziip_weight = htobe16(cpu->weight);
+				}
+				if (cpu->weight != QC_CPU_DEDICATED)
+					ziip_w = htobe16(cpu->weight);
+				break;
+			case QC_CPU_TYPE_ICF:
+				if (sys_hdr == tgt_lpar) {
+					icf++;
+					icf_abs_cap = htobe32(cpu->cpuTypeCap);
+					if (cpu->weight == QC_CPU_DEDICATED)
+						icf_ded++;
+					else
+						icf_weight = htobe16(cpu->weight);
+				}
+				if (cpu->weight != QC_CPU_DEDICATED)
+					icf_w = htobe16(cpu->weight);
+				break;
 			default:
 				if (sys_hdr == tgt_lpar)
 					un++;
@@ -424,9 +545,12 @@ static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 		}
 		cp_all_weight += cp_w;
 		ifl_all_weight += ifl_w;
+		ziip_all_weight += ziip_w;
+		icf_all_weight += icf_w;
 		sys_hdr = (struct dfs_sys_hdr *)cpu;
 	}
-	qc_debug(hdl, "Found %d cpus total (%d CP, %d IFL, %d UN)\n", cp + ifl + un, cp, ifl, un);
+	qc_debug(hdl, "Found %d cpus total (%d CP, %d IFL, %d zIIP, %d ICF, %d UN)\n", cp + ifl + ziip + icf + un, cp,
+		 ifl, ziip, icf, un);
 	hdl = qc_get_lpar_handle(hdl);
 	if (qc_set_attr_int(hdl, qc_num_cp_total, cp, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_cp_dedicated, cp_ded, ATTR_SRC_HYPFS) ||
@@ -435,7 +559,16 @@ static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 	    qc_set_attr_int(hdl, qc_num_ifl_dedicated, ifl_ded, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_ifl_shared, ifl - ifl_ded, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_cp_absolute_capping, cp_abs_cap * 0x10000 / 100, ATTR_SRC_HYPFS) ||
-	    qc_set_attr_int(hdl, qc_ifl_absolute_capping, ifl_abs_cap * 0x10000 / 100, ATTR_SRC_HYPFS))
+	    qc_set_attr_int(hdl, qc_ifl_absolute_capping, ifl_abs_cap * 0x10000 / 100, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_ziip_total, ziip, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_ziip_dedicated, ziip_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_ziip_shared, ziip - ziip_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_icf_total, icf, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_icf_dedicated, icf_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_icf_shared, icf - icf_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_ziip_absolute_capping, ziip_abs_cap * 0x10000 / 100, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_icf_absolute_capping, icf_abs_cap * 0x10000 / 100, ATTR_SRC_HYPFS) ||
+	    qc_fill_in_hypfs_cpu_table(hdl, time_hdr, tgt_lpar, 0, &tbl))
 		goto out_err;
 	if (gpd_available) {
 		cp_sh = qc_get_attr_value_int(qc_get_cec_handle(hdl), qc_num_cp_shared);
@@ -444,6 +577,12 @@ static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 		    (qc_set_attr_int(hdl, qc_cp_weight_capping, cp_weight ? *cp_sh * 0x10000 * cp_weight / cp_all_weight : 0, ATTR_SRC_HYPFS) ||
 		     qc_set_attr_int(hdl, qc_ifl_weight_capping, ifl_weight ? *ifl_sh * 0x10000 * ifl_weight / ifl_all_weight : 0, ATTR_SRC_HYPFS)))
 			goto out_err;
+		ziip_sh = qc_get_attr_value_int(qc_get_cec_handle(hdl), qc_num_ziip_shared);
+		icf_sh = qc_get_attr_value_int(qc_get_cec_handle(hdl), qc_num_icf_shared);
+		if (cap_active && ziip_sh && icf_sh &&
+		    (qc_set_attr_int(hdl, qc_ziip_weight_capping, ziip_weight ? *ziip_sh * 0x10000 * ziip_weight / ziip_all_weight : 0, ATTR_SRC_HYPFS) ||
+		     qc_set_attr_int(hdl, qc_icf_weight_capping, icf_weight ? *icf_sh * 0x10000 * icf_weight / icf_all_weight : 0, ATTR_SRC_HYPFS)))
+			goto out_err;
 	}
 	if (qc_is_nonempty_ebcdic((__u64*)tgt_lpar->grp_name)) {
 		/* LPAR group is only defined in case group name is not binary zero */
@@ -457,6 +596,12 @@ static int qc_fill_in_hypfs_lpar_values_bin(struct qc_handle *hdl, __u8 *data) {
 			rc |= qc_set_attr_int(group, qc_cp_absolute_capping, cp_cap * 0x10000 / 100, ATTR_SRC_STHYI);
 		if (ifl_cap)
 			rc |= qc_set_attr_int(group, qc_ifl_absolute_capping, ifl_cap * 0x10000 / 100, ATTR_SRC_STHYI);
+		// without GPD data, the CEC layer lists our own LPAR only
+		if (gpd_available && qc_fill_in_hypfs_lpar_group(group)) {
+			qc_debug(hdl, "Error: Failed to add members of LPAR group\n");
+			rc = -1;
+			goto out_err;
+		}
 	}
 	rc = 0;
 
@@ -466,25 +611,142 @@ out_err:
 	return rc;
 }
 
+// Fills in row 'row' of table 'lpars' with the LPAR described by 'sys_hdr'
+static int qc_fill_in_hypfs_lpar_row(struct qc_table *tbl, int row, struct dfs_sys_hdr *sys_hdr) {
+	int cp = 0, ifl = 0, cp_ded = 0, ifl_ded = 0, cp_weight = 0, ifl_weight = 0, cp_cap = 0,
+	    ifl_cap = 0, cp_abs_cap = 0, ifl_abs_cap = 0, grp, i;
+	int ziip = 0, icf = 0, ziip_ded = 0, icf_ded = 0, ziip_weight = 0, icf_weight = 0, ziip_abs_cap = 0,
+	    icf_abs_cap = 0;
+	__u64 cp_time = 0, ifl_time = 0;
+	struct dfs_cpu_info *cpu;
+
+	cpu = (struct dfs_cpu_info *)(sys_hdr + 1);
+	for (i = 0; i < sys_hdr->rcpus; ++i, ++cpu) {
+		if (!(cpu->cflag & QC_CPU_CONFIGURED))
+			continue;
+		switch (cpu->ctidx) {
+		case QC_CPU_TYPE_CP:
+			cp++;
+			cp_time += htobe64(cpu->lp_time);
+			cp_cap = htobe32(cpu->groupCpuTypeCap);
+			cp_abs_cap = htobe32(cpu->cpuTypeCap);
+			if (cpu->weight == QC_CPU_DEDICATED)
+				cp_ded++;
+			else
+				cp_weight = htobe16(cpu->weight);
+			break;
+		case QC_CPU_TYPE_IFL:
+			ifl++;
+			ifl_time += htobe64(cpu->lp_time);
+			ifl_cap = htobe32(cpu->groupCpuTypeCap);
+			ifl_abs_cap = htobe32(cpu->cpuTypeCap);
+			if (cpu->weight == QC_CPU_DEDICATED)
+				ifl_ded++;
+			else
+				ifl_weight = htobe16(cpu->weight);
+			break;
+		case QC_CPU_TYPE_ZIIP:
+			ziip++;
+			ziip_abs_cap = htobe32(cpu->cpuTypeCap);
+			if (cpu->weight == QC_CPU_DEDICATED)
+				ziip_ded++;
+			else
+				ziip_weight = htobe16(cpu->weight);
+			break;
+		case QC_CPU_TYPE_ICF:
+			icf++;
+			icf_abs_cap = htobe32(cpu->cpuTypeCap);
+			if (cpu->weight == QC_CPU_DEDICATED)
+				icf_ded++;
+			else
+				icf_weight = htobe16(cpu->weight);
+			break;
+		default:
+			break;
+		}
+	}
+	if (qc_set_row_attr_ebcdic_string(tbl, row, qc_layer_name, (unsigned char *)sys_hdr->sys_name, sizeof(sys_hdr->sys_name)) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_cp_total, cp) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_cp_dedicated, cp_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_cp_shared, cp - cp_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_ifl_total, ifl) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_ifl_dedicated, ifl_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_ifl_shared, ifl - ifl_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_cp_absolute_capping, cp_abs_cap * 0x10000 / 100) ||
+	    qc_set_row_attr_int(tbl, row, qc_ifl_absolute_capping, ifl_abs_cap * 0x10000 / 100) ||
+	    qc_set_row_attr_int64(tbl, row, qc_cp_time, cp_time) ||
+	    qc_set_row_attr_int64(tbl, row, qc_ifl_time, ifl_time) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_ziip_total, ziip) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_ziip_dedicated, ziip_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_ziip_shared, ziip - ziip_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_icf_total, icf) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_icf_dedicated, icf_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_num_icf_shared, icf - icf_ded) ||
+	    qc_set_row_attr_int(tbl, row, qc_ziip_absolute_capping, ziip_abs_cap * 0x10000 / 100) ||
+	    qc_set_row_attr_int(tbl, row, qc_icf_absolute_capping, icf_abs_cap * 0x10000 / 100))
+		return -1;
+	if ((cp > cp_ded && qc_set_row_attr_int(tbl, row, qc_cp_weight, cp_weight)) ||
+	    (ifl > ifl_ded && qc_set_row_attr_int(tbl, row, qc_ifl_weight, ifl_weight)) ||
+	    (ziip > ziip_ded && qc_set_row_attr_int(tbl, row, qc_ziip_weight, ziip_weight)) ||
+	    (icf > icf_ded && qc_set_row_attr_int(tbl, row, qc_icf_weight, icf_weight)))
+		return -2;
+	/* LPAR group is only defined in case group name is not binary zero */
+	grp = qc_is_nonempty_ebcdic((__u64 *)sys_hdr->grp_name);
+	if (grp && (qc_set_row_attr_ebcdic_string(tbl, row, qc_lpar_group_name, (unsigned char *)sys_hdr->grp_name, sizeof(sys_hdr->grp_name)) ||
+		    qc_set_row_attr_int(tbl, row, qc_cp_group_capping, cp_cap * 0x10000 / 100) ||
+		    qc_set_row_attr_int(tbl, row, qc_ifl_group_capping, ifl_cap * 0x10000 / 100)))
+		return -3;
+
+	return 0;
+}
+
 static int qc_fill_in_hypfs_cec_values_bin(struct qc_handle *hdl, __u8 *data) {
-	int num_ifl = 0, num_ifl_ded = 0, num_cp = 0, num_cp_ded = 0, num_un = 0, i, rc = 0;
+	int num_ifl = 0, num_ifl_ded = 0, num_cp = 0, num_cp_ded = 0, num_un = 0, i, j, rc = 0;
+	int num_ziip = 0, num_ziip_ded = 0, num_icf = 0, num_icf_ded = 0;
+	__u64 shared_cp_time = 0, shared_ifl_time = 0;
 	struct dfs_sys_hdr *sys_hdr = NULL;
 	struct dfs_info_blk_hdr *time_hdr;
 	struct dfs_cpu_info *cpu;
+	struct qc_table *tbl;
 
 	qc_debug(hdl, "Add CEC values from binary hypfs API\n");
 	qc_debug_indent_inc();
 	time_hdr = (struct dfs_info_blk_hdr *)(data + sizeof(struct dfs_diag_hdr));
-	if (!(time_hdr->flags & QC_FLAG_PHYS)) {
-		qc_debug(hdl, "GPD data is NOT available\n");
+	if (qc_new_table(hdl, qc_table_lpars, time_hdr->npar, &tbl)) {
+		rc = -1;
 		goto out;
 	}
-
+	tbl->timestamp = htobe64(time_hdr->curtod1) >> 12;
 	data = (__u8 *)(time_hdr + 1);
 	for (i = 0; i < time_hdr->npar; ++i) {
 		sys_hdr = (struct dfs_sys_hdr*)data;
+		if (qc_fill_in_hypfs_lpar_row(tbl, i, sys_hdr)) {
+			qc_debug(hdl, "Error: Failed to add LPAR %d to table\n", i);
+			rc = -2;
+			goto out;
+		}
+		// sum up the time that the shared physical CPUs were dispatched to the LPARs
+		cpu = (struct dfs_cpu_info*)(sys_hdr + 1);
+		for (j = 0; j < sys_hdr->rcpus; ++j, ++cpu) {
+			if (cpu->weight == QC_CPU_DEDICATED)
+				continue;
+			if (cpu->ctidx == QC_CPU_TYPE_CP)
+				shared_cp_time += htobe64(cpu->lp_time);
+			else if (cpu->ctidx == QC_CPU_TYPE_IFL)
+				shared_ifl_time += htobe64(cpu->lp_time);
+		}
 		data += (sizeof(struct dfs_sys_hdr) + (sys_hdr->rcpus * sizeof(struct dfs_cpu_info)));
 	}
+	if (qc_index_table(tbl, qc_layer_name)) {
+		rc = -3;
+		goto out;
+	}
+	qc_debug(hdl, "Added %d LPARs to table\n", time_hdr->npar);
+	if (!(time_hdr->flags & QC_FLAG_PHYS)) {
+		qc_debug(hdl, "GPD data is NOT available\n");
+		goto out;
+	}
+
 	sys_hdr = (struct dfs_sys_hdr*)data;
 	cpu = (struct dfs_cpu_info*)(sys_hdr + 1);
 	for (i = 0; i < sys_hdr->cpus; ++i, ++cpu) {
@@ -499,21 +761,44 @@ static int qc_fill_in_hypfs_cec_values_bin(struct qc_handle *hdl, __u8 *data) {
 			if (cpu->weight == QC_CPU_DEDICATED)
 				num_ifl_ded++;
 			break;
+		case QC_CPU_TYPE_ZIIP:
+			num_ziip++;
+			if (cpu->weight == QC_CPU_DEDICATED)
+				num_ziip_ded++;
+			break;
+		case QC_CPU_TYPE_ICF:
+			num_icf++;
+			if (cpu->weight == QC_CPU_DEDICATED)
+				num_icf_ded++;
+			break;
 		default:
 			num_un++;
 			break;
 		}
 	}
-	qc_debug(hdl, "CPs=%d, dedicated CPs=%d, IFLs=%d, dedicated IFLs=%d, unknown=%d\n", num_cp, num_cp_ded, num_ifl, num_ifl_ded, num_un);
+	qc_debug(hdl, "CPs=%d, dedicated CPs=%d, IFLs=%d, dedicated IFLs=%d, zIIPs=%d, dedicated zIIPs=%d, "
+		 "ICFs=%d, dedicated ICFs=%d, unknown=%d\n", num_cp, num_cp_ded, num_ifl, num_ifl_ded, num_ziip,
+		 num_ziip_ded, num_icf, num_icf_ded, num_un);
 	if (qc_set_attr_int(hdl, qc_num_cp_total, num_cp, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_cp_dedicated, num_cp_ded, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_cp_shared, num_cp - num_cp_ded, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_ifl_total, num_ifl, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_ifl_dedicated, num_ifl_ded, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_ifl_shared, num_ifl - num_ifl_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_ziip_total, num_ziip, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_ziip_dedicated, num_ziip_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_ziip_shared, num_ziip - num_ziip_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_icf_total, num_icf, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_icf_dedicated, num_icf_ded, ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int(hdl, qc_num_icf_shared, num_icf - num_icf_ded, ATTR_SRC_HYPFS) ||
 	    qc_set_attr_int(hdl, qc_num_core_dedicated, num_cp_ded + num_ifl_ded, ATTR_SRC_HYPFS) ||
-	    qc_set_attr_int(hdl, qc_num_core_shared, num_ifl + num_cp - num_cp_ded - num_ifl_ded, ATTR_SRC_HYPFS))
+	    qc_set_attr_int(hdl, qc_num_core_shared, num_ifl + num_cp - num_cp_ded - num_ifl_ded, ATTR_SRC_HYPFS) ||
+	    qc_fill_in_hypfs_cpu_table(hdl, time_hdr, sys_hdr, 1, &tbl)) {
 		rc = -1;
+		goto out;
+	}
+	tbl->shared_cp_time = shared_cp_time;
+	tbl->shared_ifl_time = shared_ifl_time;
 
 out:
 	qc_debug_indent_dec();
@@ -698,25 +983,87 @@ out:
 // Returns diag data for highest layer z/VM instance in var 'data', with pointer to entire data
 // stored in 'buf' (must be free()'d), and updates hdl to point to respective handle.
 static int qc_get_zvm_diag_data(struct qc_handle **hdl, struct dfs_diag_hdr *hdr, struct dfs_diag2fc **data) {
-	char name[QC_NAME_LEN + 1];
+	char name[QC_NAME_LEN];
 	const char *s;
 	int i;
 
 	if ((*hdl = qc_get_zvm_hdl(*hdl, &s)) == NULL)
 		return -1;
 	qc_debug(*hdl, "Found data for %" PRIu64 " z/VM guest(s)\n", htobe64((uint64_t)hdr->count));
-	for (i = 0, *data = (struct dfs_diag2fc*)(hdr + 1); i < htobe64(hdr->count); ++i, ++*data) {
-		memset(&name, 0, QC_NAME_LEN + 1);
-		memcpy(name, (*data)->guest_name, QC_NAME_LEN);
-		if (qc_ebcdic_to_ascii(*hdl, name, QC_NAME_LEN) != 0)
-			return -2;
-		if (strcmp(name, s) == 0)
-			return 0;
+	// convert our name once instead of every guest's name
+	if (qc_ascii_to_ebcdic(*hdl, name, s, QC_NAME_LEN) != 0) {
+		qc_debug(*hdl, "Error: Failed to convert guest name '%s'\n", s);
+		return -2;
 	}
+	for (i = 0, *data = (struct dfs_diag2fc*)(hdr + 1); i < htobe64(hdr->count); ++i, ++*data)
+		if (memcmp(name, (*data)->guest_name, QC_NAME_LEN) == 0)
+			return 0;
 	qc_debug(*hdl, "Error: No matching data found for z/VM guest '%s'\n", s);
 	return -3;
 }
 
+// Returns the z/VM hypervisor layer that the highest z/VM guest layer runs on, with the latter in
+// 'guest', or NULL if there is none
+static struct qc_handle *qc_get_zvm_hyp_hdl(struct qc_handle *hdl, struct qc_handle **guest) {
+	struct qc_handle *hyp = NULL, *res = NULL;
+	int *type;
+
+	*guest = NULL;
+	for (hdl = hdl->root; hdl; hdl = hdl->next) {
+		if ((type = qc_get_attr_value_int(hdl, qc_layer_type_num)) == NULL)
+			continue;
+		if (*type == QC_LAYER_TYPE_ZVM_HYPERVISOR)
+			hyp = hdl;
+		else if (*type == QC_LAYER_TYPE_ZVM_GUEST && hyp) {
+			*guest = hdl;
+			res = hyp;
+		}
+	}
+
+	return res;
+}
+
+// Fills in table 'zvm_guests' at the z/VM hypervisor layer that guest 'hdl' runs on
+static int qc_fill_in_hypfs_zvm_guest_table(struct qc_handle *hdl, struct dfs_diag_hdr *hdr) {
+	struct qc_handle *hyp, *guest;
+	struct dfs_diag2fc *data;
+	struct qc_table *tbl;
+	int i, num;
+
+	if ((hyp = qc_get_zvm_hyp_hdl(hdl, &guest)) == NULL || guest != hdl) {
+		qc_debug(hdl, "Error: No z/VM hypervisor layer found\n");
+		return -1;
+	}
+	hdl = hyp;
+	num = htobe64(hdr->count);
+	if (qc_new_table(hdl, qc_table_zvm_guests, num, &tbl))
+		return -2;
+	for (i = 0, data = (struct dfs_diag2fc *)(hdr + 1); i < num; ++i, ++data) {
+		if (qc_set_row_attr_ebcdic_string(tbl, i, qc_layer_name, (unsigned char *)data->guest_name, QC_NAME_LEN) ||
+		    qc_set_row_attr_int(tbl, i, qc_num_cpu_total, htobe32(data->vcpus)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_cpu_time, htobe64(data->used_cpu)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_online_time, htobe64(data->el_time)) ||
+		    qc_set_row_attr_int(tbl, i, qc_cpu_max, htobe32(data->cpu_max)) ||
+		    qc_set_row_attr_int(tbl, i, qc_cpu_shares, htobe32(data->cpu_shares)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_mem_min, htobe64(data->mem_min_kb)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_mem_max, htobe64(data->mem_max_kb)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_mem_share, htobe64(data->mem_share_kb)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_mem_used, htobe64(data->mem_used_kb)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_cpu_use_samples, htobe32(data->cpu_use_samp)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_cpu_delay_samples, htobe32(data->cpu_delay_samp)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_page_wait_samples, htobe32(data->page_wait_samp)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_idle_samples, htobe32(data->idle_samp)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_other_samples, htobe32(data->other_samp)) ||
+		    qc_set_row_attr_int64(tbl, i, qc_total_samples, htobe32(data->total_samp)))
+			return -3;
+	}
+	if (qc_index_table(tbl, qc_layer_name))
+		return -4;
+	qc_debug(hdl, "Added %d z/VM guests to table\n", num);
+
+	return 0;
+}
+
 static int qc_fill_in_hypfs_zvm_values_bin(struct qc_handle *hdl, struct hypfs_priv *priv) {
 	unsigned int dedicated, capped;
 	struct dfs_diag2fc *data;
@@ -727,6 +1074,10 @@ static int qc_fill_in_hypfs_zvm_values_bin(struct qc_handle *hdl, struct hypfs_p
 	qc_debug_indent_inc();
 	if ((rc = qc_get_zvm_diag_data(&hdl, (struct dfs_diag_hdr *)priv->data, &data)) != 0)
 		goto out;
+	if (qc_fill_in_hypfs_zvm_guest_table(hdl, (struct dfs_diag_hdr *)priv->data)) {
+		rc = -5;
+		goto out;
+	}
 
 	// update capping information
 	capped = (htobe32(data->flags) & 0x00000006) >> 1;
@@ -749,6 +1100,17 @@ static int qc_fill_in_hypfs_zvm_values_bin(struct qc_handle *hdl, struct hypfs_p
 		goto out;
 	}
 
+	// memory settings of the guest, as listed in the guest table
+	qc_debug(hdl, "Raw data: mem_min=%" PRIu64 " KB, mem_max=%" PRIu64 " KB, mem_used=%" PRIu64 " KB\n",
+		 (uint64_t)htobe64(data->mem_min_kb), (uint64_t)htobe64(data->mem_max_kb), (uint64_t)htobe64(data->mem_used_kb));
+	if (qc_set_attr_int64(hdl, qc_mem_min, htobe64(data->mem_min_kb), ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int64(hdl, qc_mem_max, htobe64(data->mem_max_kb), ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int64(hdl, qc_mem_share, htobe64(data->mem_share_kb), ATTR_SRC_HYPFS) ||
+	    qc_set_attr_int64(hdl, qc_mem_used, htobe64(data->mem_used_kb), ATTR_SRC_HYPFS)) {
+		rc = -6;
+		goto out;
+	}
+
 	// update shared cpu counts
 	if (dedicated == 0) {
 		/* the dedicated flag tells us, if the guest has got at least one dedicated CPU.
@@ -937,6 +1299,55 @@ out:
 	return rc;
 }
 
+static int qc_hypfs_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+			     char **buf) {
+	const struct qc_source_buffer *src;
+	struct hypfs_priv *priv;
+	int rc = 0, avail;
+
+	qc_debug(hdl, "Retrieve hypfs information from buffer\n");
+	qc_debug_indent_inc();
+	if ((priv = malloc(sizeof(struct hypfs_priv))) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate hypfs_priv\n");
+		rc = -1;
+		goto out;
+	}
+	bzero(priv, sizeof(struct hypfs_priv));
+	*buf = (char *)priv;
+
+	/* just like in qc_hypfs_open(): if z/VM diag data is present, the LPAR diag data
+	   isn't valid */
+	if ((src = qc_get_source_buffer(bufs, num, QC_SOURCE_HYPFS_DIAG_2FC)) != NULL) {
+		priv->diag = QC_HYPFS_ZVM;
+		avail = HYPFS_AVAIL_BIN_ZVM;
+	} else if ((src = qc_get_source_buffer(bufs, num, QC_SOURCE_HYPFS_DIAG_204)) != NULL) {
+		priv->diag = QC_HYPFS_LPAR;
+		avail = HYPFS_AVAIL_BIN_LPAR;
+	} else {
+		qc_debug(hdl, "No hypfs data available\n");
+		goto out;
+	}
+	if (src->len < sizeof(struct dfs_diag_hdr) ||
+	    sizeof(struct dfs_diag_hdr) + htobe64(((struct dfs_diag_hdr *)src->data)->len) != src->len) {
+		qc_debug(hdl, "Error: Length of %s data is inconsistent\n", priv->diag);
+		rc = -2;
+		goto out;
+	}
+	if ((priv->data = malloc(src->len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate '%zd' Bytes for %s data\n", src->len, priv->diag);
+		rc = -3;
+		goto out;
+	}
+	memcpy(priv->data, src->data, src->len);
+	priv->len = src->len;
+	priv->avail = avail;
+
+out:
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
 static void qc_hypfs_close(struct qc_handle *hdl, char *buf) {
 	struct hypfs_priv *priv = (struct hypfs_priv *)buf;
 	if (priv) {
@@ -946,6 +1357,61 @@ static void qc_hypfs_close(struct qc_handle *hdl, char *buf) {
 	}
 }
 
+// Verifies that all records of the diag 204 data in 'data' lie within its 'len' Bytes
+static int qc_hypfs_verify_diag_204(struct qc_handle *hdl, __u8 *data, ssize_t len) {
+	struct dfs_info_blk_hdr *time_hdr;
+	struct dfs_sys_hdr *sys_hdr;
+	__u8 *tgt_lpar, *end;
+	int i, tgt_found = 0;
+
+	end = data + len;
+	time_hdr = (struct dfs_info_blk_hdr *)(data + sizeof(struct dfs_diag_hdr));
+	if (len < (ssize_t)(sizeof(struct dfs_diag_hdr) + sizeof(struct dfs_info_blk_hdr))) {
+		qc_debug(hdl, "Error: diag 204 data too short for info block header\n");
+		return -1;
+	}
+	tgt_lpar = (__u8 *)time_hdr + htobe16(time_hdr->thispart);
+	data = (__u8 *)(time_hdr + 1);
+	for (i = 0; i < time_hdr->npar; ++i) {
+		sys_hdr = (struct dfs_sys_hdr *)data;
+		if (end - data < (ssize_t)sizeof(struct dfs_sys_hdr) ||
+		    end - data < (ssize_t)(sizeof(struct dfs_sys_hdr) + sys_hdr->rcpus * sizeof(struct dfs_cpu_info))) {
+			qc_debug(hdl, "Error: diag 204 data of LPAR %d exceeds buffer\n", i);
+			return -2;
+		}
+		if (data == tgt_lpar)
+			tgt_found = 1;
+		data += sizeof(struct dfs_sys_hdr) + sys_hdr->rcpus * sizeof(struct dfs_cpu_info);
+	}
+	if (!tgt_found) {
+		qc_debug(hdl, "Error: diag 204 offset of own LPAR (%u) does not match any LPAR\n",
+			 htobe16(time_hdr->thispart));
+		return -3;
+	}
+	if (!(time_hdr->flags & QC_FLAG_PHYS))
+		return 0;
+	sys_hdr = (struct dfs_sys_hdr *)data;
+	if (end - data < (ssize_t)sizeof(struct dfs_sys_hdr) ||
+	    end - data < (ssize_t)(sizeof(struct dfs_sys_hdr) + sys_hdr->cpus * sizeof(struct dfs_cpu_info))) {
+		qc_debug(hdl, "Error: diag 204 data of physical CPUs exceeds buffer\n");
+		return -4;
+	}
+
+	return 0;
+}
+
+// Verifies that all guest records of the diag 2fc data in 'data' lie within its 'len' Bytes
+static int qc_hypfs_verify_diag_2fc(struct qc_handle *hdl, __u8 *data, ssize_t len) {
+	__u64 count = htobe64(((struct dfs_diag_hdr *)data)->count);
+
+	if (count > (len - sizeof(struct dfs_diag_hdr)) / sizeof(struct dfs_diag2fc)) {
+		qc_debug(hdl, "Error: diag 2fc data of %" PRIu64 " guests exceeds buffer\n", (uint64_t)count);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int qc_hypfs_process(struct qc_handle *hdl, char *buf) {
 	struct hypfs_priv *priv = (struct hypfs_priv *)buf;
 #ifdef CONFIG_TEXTUAL_HYPFS
@@ -964,11 +1430,15 @@ static int qc_hypfs_process(struct qc_handle *hdl, char *buf) {
 		goto out;
 	}
 	if (priv->avail == HYPFS_AVAIL_BIN_LPAR) {
+		if ((rc = qc_hypfs_verify_diag_204(hdl, (__u8 *)priv->data, priv->len)) != 0)
+			goto out;
 		rc = qc_fill_in_hypfs_cec_values_bin(hdl->root, (__u8 *)priv->data) ||
 		    qc_fill_in_hypfs_lpar_values_bin(hdl, (__u8 *)priv->data);
 		goto out;
 	}
 	if (priv->avail == HYPFS_AVAIL_BIN_ZVM) {
+		if ((rc = qc_hypfs_verify_diag_2fc(hdl, (__u8 *)priv->data, priv->len)) != 0)
+			goto out;
        		rc = qc_fill_in_hypfs_zvm_values_bin(hdl, priv);
 		goto out;
 	}
@@ -1063,9 +1533,363 @@ out:
 	return rc;
 }
 
-struct qc_data_src hypfs = {qc_hypfs_open,
+// Sets the utilization attributes of type 'type' in 'hdl' for 'num' cores, which were busy
+// for 'busy' microseconds within 'delta' microseconds
+static int qc_set_utilization(struct qc_handle *hdl, int type, int num, __u64 busy, __u64 delta) {
+	enum qc_attr_id util = type == QC_CPU_TYPE_CP ? qc_cp_utilization : qc_ifl_utilization;
+	enum qc_attr_id cons = type == QC_CPU_TYPE_CP ? qc_cp_consumption : qc_ifl_consumption;
+
+	qc_debug(hdl, "%s: %d cores busy for %llu us\n", type == QC_CPU_TYPE_CP ? "CPs" : "IFLs", num,
+		 (unsigned long long)busy);
+	if (!num)
+		return 0;
+
+	return qc_set_attr_float(hdl, util, 100.0 * busy / (delta * num), ATTR_SRC_HYPFS) ||
+	       qc_set_attr_int(hdl, cons, busy * 0x10000 / delta, ATTR_SRC_HYPFS);
+}
+
+// Returns the time elapsed between the tables 'cpus' in 'hdl' and 'prev', or 0 if not available
+static __u64 qc_get_elapsed_time(struct qc_handle *hdl, struct qc_handle *prev, struct qc_table **tbl,
+				 struct qc_table **prev_tbl) {
+	*tbl = qc_get_table(hdl, qc_table_cpus);
+	*prev_tbl = qc_get_table(prev, qc_table_cpus);
+	if (!*tbl || !*prev_tbl) {
+		qc_debug(hdl, "No CPU times available\n");
+		return 0;
+	}
+	if ((*tbl)->timestamp <= (*prev_tbl)->timestamp) {
+		qc_debug(hdl, "Configuration is not newer than previous configuration\n");
+		return 0;
+	}
+	qc_debug(hdl, "Time elapsed: %llu us\n", (unsigned long long)((*tbl)->timestamp - (*prev_tbl)->timestamp));
+
+	return (*tbl)->timestamp - (*prev_tbl)->timestamp;
+}
+
+// Sets utilization values of the shared physical CPUs from the times that elapsed since 'prev'
+static int qc_hypfs_pool_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	__u64 delta, cp_busy, ifl_busy;
+	int row, prev_row, cp_num = 0, ifl_num = 0, *addr, *type, *ded;
+	struct qc_table *tbl, *prev_tbl;
+	int64_t *cur, *old;
+
+	qc_debug(hdl, "Compute shared physical CPU utilization\n");
+	qc_debug_indent_inc();
+	if ((delta = qc_get_elapsed_time(hdl, prev, &tbl, &prev_tbl)) == 0) {
+		qc_debug_indent_dec();
+		return 1;
+	}
+	qc_unset_attr(hdl, qc_cp_utilization);
+	qc_unset_attr(hdl, qc_ifl_utilization);
+	qc_unset_attr(hdl, qc_cp_consumption);
+	qc_unset_attr(hdl, qc_ifl_consumption);
+	if (tbl->shared_cp_time < prev_tbl->shared_cp_time || tbl->shared_ifl_time < prev_tbl->shared_ifl_time) {
+		qc_debug(hdl, "CPU times decreased, ignoring\n");
+		qc_debug_indent_dec();
+		return 1;
+	}
+	cp_busy = tbl->shared_cp_time - prev_tbl->shared_cp_time;
+	ifl_busy = tbl->shared_ifl_time - prev_tbl->shared_ifl_time;
+	// add the management time of the hypervisor on the shared physical CPUs
+	for (row = 0; row < tbl->num_rows; ++row) {
+		addr = qc_get_row_attr_value_int(tbl, row, qc_cpu_address);
+		type = qc_get_row_attr_value_int(tbl, row, qc_cpu_type_num);
+		ded = qc_get_row_attr_value_int(tbl, row, qc_dedicated);
+		if (!addr || !type || !ded || *ded)
+			continue;
+		cur = qc_get_row_attr_value_int64(tbl, row, qc_mgmt_time);
+		if ((prev_row = qc_find_row_int(prev_tbl, qc_cpu_address, *addr)) < 0 ||
+		    (old = qc_get_row_attr_value_int64(prev_tbl, prev_row, qc_mgmt_time)) == NULL ||
+		    !cur || *cur < *old)
+			continue;
+		switch (*type) {
+		case QC_CPU_TYPE_CP:
+			cp_busy += *cur - *old;
+			cp_num++;
+			break;
+		case QC_CPU_TYPE_IFL:
+			ifl_busy += *cur - *old;
+			ifl_num++;
+			break;
+		default:
+			break;
+		}
+	}
+	if (qc_set_utilization(hdl, QC_CPU_TYPE_CP, cp_num, cp_busy, delta) ||
+	    qc_set_utilization(hdl, QC_CPU_TYPE_IFL, ifl_num, ifl_busy, delta)) {
+		qc_debug_indent_dec();
+		return -1;
+	}
+	qc_debug_indent_dec();
+
+	return 0;
+}
+
+// Sets utilization values for our LPAR from the CPU times that elapsed since 'prev'
+static int qc_hypfs_lpar_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	__u64 delta, cp_sum = 0, ifl_sum = 0, cur_time, prev_time;
+	int row, prev_row, cp_num = 0, ifl_num = 0, *addr, *type;
+	struct qc_table *tbl, *prev_tbl;
+	int64_t *cur, *old;
+
+	qc_debug(hdl, "Compute LPAR utilization\n");
+	qc_debug_indent_inc();
+	if (qc_strings_differ(qc_get_attr_value_string(hdl, qc_layer_name), qc_get_attr_value_string(prev, qc_layer_name))) {
+		qc_debug(hdl, "Configurations originate from different LPARs\n");
+		goto out_na;
+	}
+	if ((delta = qc_get_elapsed_time(hdl, prev, &tbl, &prev_tbl)) == 0)
+		goto out_na;
+
+	qc_unset_attr(hdl, qc_cp_utilization);
+	qc_unset_attr(hdl, qc_ifl_utilization);
+	qc_unset_attr(hdl, qc_cp_consumption);
+	qc_unset_attr(hdl, qc_ifl_consumption);
+	for (row = 0; row < tbl->num_rows; ++row) {
+		qc_unset_row_attr(tbl, row, qc_utilization);
+		addr = qc_get_row_attr_value_int(tbl, row, qc_cpu_address);
+		type = qc_get_row_attr_value_int(tbl, row, qc_cpu_type_num);
+		cur = qc_get_row_attr_value_int64(tbl, row, qc_cpu_time);
+		// CPUs that were configured in between have no previous value
+		if (!addr || !type || !cur || (prev_row = qc_find_row_int(prev_tbl, qc_cpu_address, *addr)) < 0 ||
+		    (old = qc_get_row_attr_value_int64(prev_tbl, prev_row, qc_cpu_time)) == NULL)
+			continue;
+		cur_time = *cur;
+		prev_time = *old;
+		if (cur_time < prev_time)
+			continue;
+		if (qc_set_row_attr_float(tbl, row, qc_utilization, 100.0 * (cur_time - prev_time) / delta))
+			goto out_err;
+		switch (*type) {
+		case QC_CPU_TYPE_CP:
+			cp_sum += cur_time - prev_time;
+			cp_num++;
+			break;
+		case QC_CPU_TYPE_IFL:
+			ifl_sum += cur_time - prev_time;
+			ifl_num++;
+			break;
+		default:
+			break;
+		}
+	}
+	if (qc_set_utilization(hdl, QC_CPU_TYPE_CP, cp_num, cp_sum, delta) ||
+	    qc_set_utilization(hdl, QC_CPU_TYPE_IFL, ifl_num, ifl_sum, delta))
+		goto out_err;
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_na:
+	qc_debug_indent_dec();
+
+	return 1;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+// Returns the increase of int64 attribute 'id' in 'delta', or >0 if not available
+static int qc_get_row_delta(struct qc_table *tbl, int row, struct qc_table *prev_tbl, int prev_row,
+			    enum qc_attr_id id, __u64 *delta) {
+	int64_t *cur, *old;
+
+	if ((cur = qc_get_row_attr_value_int64(tbl, row, id)) == NULL ||
+	    (old = qc_get_row_attr_value_int64(prev_tbl, prev_row, id)) == NULL || *cur < *old)
+		return 1;
+	*delta = *cur - *old;
+
+	return 0;
+}
+
+// Sets the CP and IFL consumption of all LPARs in table 'lpars' of 'hdl' from the times that
+// elapsed since 'prev'. Returns the summed up times in 'cp' and 'ifl', and the elapsed time in
+// 'elapsed', or >0 if not available.
+static int qc_hypfs_lpars_consumption(struct qc_handle *hdl, struct qc_handle *prev, __u64 *cp, __u64 *ifl,
+				      __u64 *elapsed) {
+	struct qc_table *tbl, *prev_tbl;
+	__u64 cp_time, ifl_time;
+	int row, prev_row;
+	char *name;
+
+	*cp = *ifl = 0;
+	if ((tbl = qc_get_table(hdl, qc_table_lpars)) == NULL || (prev_tbl = qc_get_table(prev, qc_table_lpars)) == NULL ||
+	    tbl->timestamp <= prev_tbl->timestamp)
+		return 1;
+	*elapsed = tbl->timestamp - prev_tbl->timestamp;
+	for (row = 0; row < tbl->num_rows; ++row) {
+		qc_unset_row_attr(tbl, row, qc_cp_consumption);
+		qc_unset_row_attr(tbl, row, qc_ifl_consumption);
+		// LPARs that were activated in between have no previous value
+		if ((name = qc_get_row_attr_value_string(tbl, row, qc_layer_name)) == NULL ||
+		    (prev_row = qc_find_row_string(prev_tbl, qc_layer_name, name)) < 0 ||
+		    qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_cp_time, &cp_time) ||
+		    qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_ifl_time, &ifl_time))
+			continue;
+		if (qc_set_row_attr_int(tbl, row, qc_cp_consumption, cp_time * 0x10000 / *elapsed) ||
+		    qc_set_row_attr_int(tbl, row, qc_ifl_consumption, ifl_time * 0x10000 / *elapsed))
+			return -1;
+		*cp += cp_time;
+		*ifl += ifl_time;
+	}
+
+	return 0;
+}
+
+// Returns the LPAR group layer, or NULL if there is none
+static struct qc_handle *qc_get_lpar_group_hdl(struct qc_handle *hdl) {
+	for (hdl = hdl->root; hdl && *(int *)(hdl->layer) != QC_LAYER_TYPE_LPAR_GROUP; hdl = hdl->next);
+
+	return hdl;
+}
+
+// Sets the consumption of all LPARs of the CEC, as well as the consumption of our LPAR group
+// and its share of the group's capping from the times that elapsed since 'prev'
+static int qc_hypfs_lpars_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	enum qc_attr_id cons[] = {qc_cp_consumption, qc_ifl_consumption};
+	enum qc_attr_id util[] = {qc_cp_utilization, qc_ifl_utilization};
+	enum qc_attr_id caps[] = {qc_cp_absolute_capping, qc_ifl_absolute_capping};
+	struct qc_handle *group, *prev_group;
+	__u64 elapsed, busy[2];
+	int rc, i, *cap;
+
+	qc_debug(hdl, "Compute LPARs utilization\n");
+	qc_debug_indent_inc();
+	if ((rc = qc_hypfs_lpars_consumption(qc_get_cec_handle(hdl), qc_get_cec_handle(prev), &busy[0], &busy[1],
+					     &elapsed)) != 0)
+		goto out;
+	if ((group = qc_get_lpar_group_hdl(hdl)) == NULL || (prev_group = qc_get_lpar_group_hdl(prev)) == NULL ||
+	    qc_strings_differ(qc_get_attr_value_string(group, qc_layer_name), qc_get_attr_value_string(prev_group, qc_layer_name)))
+		goto out;
+	for (i = 0; i < 2; ++i) {
+		qc_unset_attr(group, cons[i]);
+		qc_unset_attr(group, util[i]);
+	}
+	if ((rc = qc_hypfs_lpars_consumption(group, prev_group, &busy[0], &busy[1], &elapsed)) != 0) {
+		rc = rc < 0 ? rc : 0;
+		goto out;
+	}
+	qc_debug(hdl, "LPAR group busy for %llu us on CPs and %llu us on IFLs\n", (unsigned long long)busy[0],
+		 (unsigned long long)busy[1]);
+	for (i = 0; i < 2; ++i) {
+		if (qc_set_attr_int(group, cons[i], busy[i] * 0x10000 / elapsed, ATTR_SRC_HYPFS) ||
+		    ((cap = qc_get_attr_value_int(group, caps[i])) != NULL && *cap > 0 &&
+		     qc_set_attr_float(group, util[i], 100.0 * busy[i] * 0x10000 / elapsed / *cap, ATTR_SRC_HYPFS))) {
+			rc = -1;
+			goto out;
+		}
+	}
+
+out:
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+// Sets the CPU consumption, as well as the shares of CPU delay and page wait samples of our z/VM
+// guest from the values that changed since 'prev'
+static int qc_hypfs_zvm_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	__u64 elapsed, used, samples, delay, page_wait;
+	struct qc_handle *hyp, *guest, *prev_guest;
+	struct qc_table *tbl, *prev_tbl;
+	const char *name;
+	int row, prev_row;
+
+	qc_debug(hdl, "Compute z/VM guest utilization\n");
+	qc_debug_indent_inc();
+	if ((hyp = qc_get_zvm_hyp_hdl(hdl, &guest)) == NULL || (tbl = qc_get_table(hyp, qc_table_zvm_guests)) == NULL ||
+	    (hyp = qc_get_zvm_hyp_hdl(prev, &prev_guest)) == NULL || (prev_tbl = qc_get_table(hyp, qc_table_zvm_guests)) == NULL) {
+		qc_debug(hdl, "No z/VM guest data available\n");
+		goto out_na;
+	}
+	name = qc_get_attr_value_string(guest, qc_layer_name);
+	if (!name || qc_strings_differ(name, qc_get_attr_value_string(prev_guest, qc_layer_name))) {
+		qc_debug(hdl, "Configurations originate from different z/VM guests\n");
+		goto out_na;
+	}
+	if ((row = qc_find_row_string(tbl, qc_layer_name, name)) < 0 ||
+	    (prev_row = qc_find_row_string(prev_tbl, qc_layer_name, name)) < 0) {
+		qc_debug(hdl, "No data for z/VM guest '%s'\n", name);
+		goto out_na;
+	}
+	// elapsed time restarts at logon
+	if (qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_online_time, &elapsed) || !elapsed) {
+		qc_debug(hdl, "Configuration is not newer than previous configuration\n");
+		goto out_na;
+	}
+	qc_debug(hdl, "Time elapsed: %llu us\n", (unsigned long long)elapsed);
+	qc_unset_attr(guest, qc_cpu_consumption);
+	qc_unset_attr(guest, qc_cpu_delay);
+	qc_unset_attr(guest, qc_page_wait);
+	if (!qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_cpu_time, &used) &&
+	    qc_set_attr_int(guest, qc_cpu_consumption, used * 0x10000 / elapsed, ATTR_SRC_HYPFS))
+		goto out_err;
+	if (!qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_total_samples, &samples) && samples &&
+	    !qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_cpu_delay_samples, &delay) &&
+	    !qc_get_row_delta(tbl, row, prev_tbl, prev_row, qc_page_wait_samples, &page_wait)) {
+		qc_debug(hdl, "%llu samples, CPU delay in %llu, page wait in %llu\n", (unsigned long long)samples,
+			 (unsigned long long)delay, (unsigned long long)page_wait);
+		if (qc_set_attr_float(guest, qc_cpu_delay, 100.0 * delay / samples, ATTR_SRC_HYPFS) ||
+		    qc_set_attr_float(guest, qc_page_wait, 100.0 * page_wait / samples, ATTR_SRC_HYPFS))
+			goto out_err;
+	}
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_na:
+	qc_debug_indent_dec();
+
+	return 1;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+// Computes utilization of the shared physical CPUs, of all LPARs and our LPAR group, of our LPAR
+// and of our z/VM guest. Returns 0 if any of these could be computed.
+static int qc_hypfs_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	struct qc_handle *lpar, *prev_lpar;
+	int rc = 1, lrc;
+
+	qc_debug(hdl, "Compute utilization from hypfs\n");
+	qc_debug_indent_inc();
+	if (qc_strings_differ(qc_get_attr_value_string(hdl, qc_sequence_code), qc_get_attr_value_string(prev, qc_sequence_code))) {
+		qc_debug(hdl, "Configurations originate from different CECs\n");
+		goto out;
+	}
+	if ((rc = qc_hypfs_pool_utilization(hdl, prev)) < 0)
+		goto out;
+	if ((lrc = qc_hypfs_lpars_utilization(hdl, prev)) < 0) {
+		rc = lrc;
+		goto out;
+	}
+	if (lrc == 0)
+		rc = 0;
+	lpar = qc_get_lpar_handle(hdl);
+	prev_lpar = qc_get_lpar_handle(prev);
+	if (lpar && prev_lpar) {
+		if ((lrc = qc_hypfs_lpar_utilization(lpar, prev_lpar)) <= 0 || rc > 0)
+			rc = lrc;
+	}
+	if (rc >= 0 && ((lrc = qc_hypfs_zvm_utilization(hdl, prev)) <= 0 || rc > 0))
+		rc = lrc;
+
+out:
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+struct qc_data_src hypfs = {"hypfs",
+			    qc_hypfs_open,
 			    qc_hypfs_process,
 			    qc_hypfs_dump,
 			    qc_hypfs_close,
 			    NULL,
-			    NULL};
+			    qc_hypfs_open_buf,
+			    qc_hypfs_utilization};
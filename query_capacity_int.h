@@ -9,7 +9,6 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
-#include <iconv.h>
 #include <inttypes.h>
 #include <linux/types.h>
 
@@ -23,6 +22,10 @@
 #define ATTR_SRC_OCF		'O'
 #define ATTR_SRC_HYPFS		'H'
 #define ATTR_SRC_STHYI		'V'
+#define ATTR_SRC_PROCSTAT	'p'
+#define ATTR_SRC_KVMHOST	'k'
+#define ATTR_SRC_TOPOLOGY	't'
+#define ATTR_SRC_MEMINFO	'm'
 #define ATTR_SRC_POSTPROC	'P'	// Note: Post-processed attributes can have multiple origins - would be
 					//       complicated to figure out accurately. We leave it at 'P' for now
 #define ATTR_SRC_UNDEF		'_'
@@ -39,52 +42,99 @@
 #endif // __BYTE_ORDER
 #endif // htobe32
 
+struct qc_handle;
+
+// Variable number of rows of attributes, attached to a layer
+struct qc_table {
+	enum qc_table_id  id;
+	struct qc_handle *hdl;		// layer the table is attached to
+	struct qc_attr	 *attr_list;	// columns, defined like attributes of layers
+	int		  num_attrs;
+	size_t		  row_sz;
+	int		  num_rows;
+	char		 *rows;		// num_rows entries of size row_sz
+	char		 *attr_present;	// num_rows * num_attrs entries
+	__u64		  timestamp;	// time of measurement in microseconds, if applicable
+	__u64		  shared_cp_time;	// physical CPUs only: accumulated time of all LPARs' shared
+	__u64		  shared_ifl_time;	// logical CPs/IFLs in microseconds
+	int		 *index;	// optional hash index on string column 'index_id', see qc_index_table()
+	int		  index_sz;
+	enum qc_attr_id	  index_id;
+	struct qc_table	 *next;
+};
+
 struct qc_handle {
 	void		 *layer;	// holds a copy of the respective *_values struct (see below),
 					// and is filled by looking up the offset via the respective *_attrs table
+	size_t		  layer_sz;
 	struct qc_attr	 *attr_list;
 	int 		  layer_no;
 	int 		 *attr_present;	// array indicating whether attributes are set
 	char		 *src;		// array indicating the source of the attribute's value, see ATTR_SRC_*
 	struct qc_handle *next;
 	struct qc_handle *root;		// points to top handle
+	int		  buffered;	// root only: opened by qc_open_from_buffers() or qc_simulate()
+	struct qc_table	 *tables;
 };
 
 struct qc_data_src {
+	const char *name;
 	int  (*open)(struct qc_handle *, char **);
 	int  (*process)(struct qc_handle *, char *);
 	void (*dump)(struct qc_handle *, char *);
 	void (*close)(struct qc_handle *, char *);
 	int  (*lgm_check)(struct qc_handle *, const char *);
-	char *priv;
+	// like open, but retrieves the data from the buffers passed to qc_open_from_buffers()
+	int  (*open_buf)(struct qc_handle *, const struct qc_source_buffer *, int, char **);
+	// optional: computes utilization from the difference to an earlier configuration
+	int  (*utilization)(struct qc_handle *, struct qc_handle *);
 };
 
-extern struct qc_data_src sysinfo, ocf, hypfs, sthyi;
+extern struct qc_data_src sysinfo, ocf, hypfs, sthyi, topology, procstat, kvmhost, meminfo;
 
 /* Utility functions */
 int qc_ebcdic_to_ascii(struct qc_handle *hdl, char *inbuf, size_t insz);
+int qc_ascii_to_ebcdic(struct qc_handle *hdl, char *outbuf, const char *inbuf, size_t outsz);
+int qc_strings_differ(const char *a, const char *b);
+const struct qc_source_buffer *qc_get_source_buffer(const struct qc_source_buffer *bufs, int num, int type);
 int qc_is_nonempty_ebcdic(__u64 *str);
 int qc_new_handle(struct qc_handle *hdl, struct qc_handle **tgthdl, int layer_no, int layer_type);
 // Insert new layer 'inserted_hdl' of type 'type' before 'hdl'. Won't support inserting a new root
 int qc_insert_handle(struct qc_handle *hdl, struct qc_handle **inserted_hdl, int type);
 // Insert new layer 'appended_hdl' of type 'type' after 'hdl'
 int qc_append_handle(struct qc_handle *hdl, struct qc_handle **appended_hdl, int type);
+// Allocates a copy of layer 'src' without its tables, 'hdl' as in qc_new_handle()
+int qc_copy_handle(struct qc_handle *hdl, struct qc_handle **tgthdl, struct qc_handle *src);
 struct qc_handle *qc_get_cec_handle(struct qc_handle *hdl);
 struct qc_handle *qc_get_lpar_handle(struct qc_handle *hdl);
 struct qc_handle *qc_get_root_handle(struct qc_handle *hdl);
 struct qc_handle *qc_get_prev_handle(struct qc_handle *hdl);
+// Releases all layers and tables of 'hdl', leaving the root handle itself allocated
+void qc_hdl_reinit(struct qc_handle *hdl);
 
 /* Debugging-related functions and variables */
 extern long  qc_dbg_level;
 extern FILE *qc_dbg_file;
 extern char *qc_dbg_dump_dir;
 extern char *qc_dbg_use_dump;
-extern int   qc_dbg_indent;
+extern __thread int qc_dbg_indent;
 extern int   qc_consistency_check_requested;
 void qc_debug_indent_inc();
 void qc_debug_indent_dec();
 void qc_mark_dump_incomplete(struct qc_handle *hdl, char *missing_component);
 
+/* Tracing-related functions and variables */
+extern FILE *qc_trace_file;
+void qc_trace_event(char phase, const char *src, const char *name);
+
+// Spans are written in Chrome trace event format, 'src' is optional and prefixed to 'name'
+#define qc_trace_begin(src, name)	if (qc_trace_file) { \
+						qc_trace_event('B', src, name); \
+					}
+#define qc_trace_end(src, name)		if (qc_trace_file) { \
+						qc_trace_event('E', src, name); \
+					}
+
 
 #ifdef CONFIG_DEBUG_TIMESTAMPS
 #define qc_debug(hdl, arg, ...)	if (qc_dbg_level > 0) { \
@@ -0,0 +1,462 @@
+/* Copyright IBM Corp. 2018 */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "query_capacity_int.h"
+#include "query_capacity_data.h"
+
+
+#define DIR_MACHINE_SLICE_V2	"/sys/fs/cgroup/machine.slice"
+#define DIR_MACHINE_SLICE_V1	"/sys/fs/cgroup/cpuacct/machine.slice"
+#define FILE_UPTIME		"/proc/uptime"
+#define MAX_GUEST_NAME_LEN	64
+
+/* We retrieve the KVM guests of a KVM host from the scopes that libvirt and systemd-machined
+   create in cgroup machine.slice, and from the respective qemu processes. As that data spreads
+   across a multitude of files, we collect it into one line per guest, which is what we dump:
+     <vCPUs> <CPU time in us> <time since guest start in us> <guest name> */
+
+static void qc_kvmhost_dump(struct qc_handle *hdl, char *data) {
+	char *path = NULL;
+	FILE *fp;
+	int rc;
+
+	qc_debug(hdl, "Dump KVM guests\n");
+	qc_debug_indent_inc();
+	if (!data)
+		goto out;
+	if (asprintf(&path, "%s/kvm_guests", qc_dbg_dump_dir) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failure, cannot dump KVM guests\n");
+		goto out_err;
+	}
+	if ((fp = fopen(path, "w")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open %s to write KVM guests dump\n", path);
+		goto out_err;
+	}
+	rc = fprintf(fp, "%s", data);
+	fclose(fp);
+	if (rc < 0) {
+		qc_debug(hdl, "Error: Failed to write dump to '%s'\n", path);
+		goto out_err;
+	}
+	goto out;
+
+out_err:
+	qc_mark_dump_incomplete(hdl, "kvm_guests");
+out:
+	free(path);
+	qc_debug_indent_dec();
+
+	return;
+}
+
+// Reads the first line of file 'path' into 'buf'. Returns 0 on success.
+static int qc_kvmhost_read_line(const char *path, char *buf, int sz) {
+	FILE *fp;
+	int rc;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		return -1;
+	rc = fgets(buf, sz, fp) == NULL;
+	fclose(fp);
+
+	return rc;
+}
+
+// Returns the first pid in cgroup 'path' or any of its children up to 'depth' levels down,
+// or 0 if there is none. With cgroup v2, libvirt moves qemu into child cgroup 'libvirt/emulator'.
+static pid_t qc_kvmhost_find_pid(const char *path, int depth) {
+	char *fname = NULL, buf[32];
+	struct dirent *de;
+	pid_t pid = 0;
+	DIR *dir;
+
+	if (asprintf(&fname, "%s/cgroup.procs", path) == -1)
+		return 0;
+	if (qc_kvmhost_read_line(fname, buf, sizeof(buf)) == 0)
+		pid = atoi(buf);
+	free(fname);
+	if (pid > 0 || depth == 0 || (dir = opendir(path)) == NULL)
+		return pid;
+	while (pid <= 0 && (de = readdir(dir)) != NULL) {
+		if (de->d_type != DT_DIR || de->d_name[0] == '.' || asprintf(&fname, "%s/%s", path, de->d_name) == -1)
+			continue;
+		pid = qc_kvmhost_find_pid(fname, depth - 1);
+		free(fname);
+	}
+	closedir(dir);
+
+	return pid;
+}
+
+// Returns the number of vCPU threads of qemu process 'pid', which are named 'CPU <n>/KVM'
+static int qc_kvmhost_count_vcpus(pid_t pid) {
+	char *path = NULL, buf[32];
+	struct dirent *de;
+	int num = 0, n;
+	DIR *dir;
+
+	if (asprintf(&path, "/proc/%d/task", pid) == -1)
+		return 0;
+	dir = opendir(path);
+	free(path);
+	if (!dir)
+		return 0;
+	while ((de = readdir(dir)) != NULL) {
+		if (de->d_name[0] == '.' || asprintf(&path, "/proc/%d/task/%s/comm", pid, de->d_name) == -1)
+			continue;
+		if (qc_kvmhost_read_line(path, buf, sizeof(buf)) == 0 && sscanf(buf, "CPU %d/KVM", &n) == 1)
+			num++;
+		free(path);
+	}
+	closedir(dir);
+
+	return num;
+}
+
+// Returns the time in microseconds that process 'pid' is running for, or -1 on error
+static int64_t qc_kvmhost_get_runtime(pid_t pid, double uptime) {
+	char *path = NULL, buf[1024], *p;
+	unsigned long long start;
+
+	if (asprintf(&path, "/proc/%d/stat", pid) == -1)
+		return -1;
+	if (qc_kvmhost_read_line(path, buf, sizeof(buf)) ||
+	    // skip the command, which might contain blanks, and 19 more fields to get to 'starttime'
+	    (p = strrchr(buf, ')')) == NULL ||
+	    sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &start) != 1)
+		start = -1;
+	free(path);
+	if (start == (unsigned long long)-1)
+		return -1;
+
+	return (int64_t)(uptime * 1000000) - (int64_t)start * 1000000 / sysconf(_SC_CLK_TCK);
+}
+
+// Returns the CPU time in microseconds consumed by all processes in cgroup 'path', or -1 on error
+static int64_t qc_kvmhost_get_cpu_time(const char *path, int v2) {
+	unsigned long long usage;
+	char *fname = NULL, buf[64];
+	int64_t rc = -1;
+	FILE *fp;
+
+	if (asprintf(&fname, "%s/%s", path, v2 ? "cpu.stat" : "cpuacct.usage") == -1)
+		return -1;
+	if ((fp = fopen(fname, "r")) == NULL)
+		goto out;
+	while (fgets(buf, sizeof(buf), fp)) {
+		if (v2 && sscanf(buf, "usage_usec %llu", &usage) == 1) {
+			rc = usage;
+			break;
+		}
+		if (!v2 && sscanf(buf, "%llu", &usage) == 1) {
+			rc = usage / 1000;	// reported in nanoseconds
+			break;
+		}
+	}
+	fclose(fp);
+out:
+	free(fname);
+
+	return rc;
+}
+
+// Converts scope name 'scope' as created by systemd-machined, e.g. 'machine-qemu\x2d1\x2dguest.scope',
+// back to the guest name, e.g. 'guest'
+static void qc_kvmhost_decode_name(const char *scope, char *name) {
+	const char *end = strstr(scope, ".scope");
+	unsigned int c;
+	int i, j;
+
+	if (strncmp(scope, "machine-", strlen("machine-")) == 0)
+		scope += strlen("machine-");
+	for (i = 0, j = 0; &scope[i] < end && j < MAX_GUEST_NAME_LEN; ++j) {
+		if (strncmp(&scope[i], "\\x", 2) == 0 && sscanf(&scope[i + 2], "%2x", &c) == 1) {
+			name[j] = c;
+			i += 4;
+		} else
+			name[j] = scope[i++];
+	}
+	name[j] = '\0';
+	// strip libvirt's 'qemu-<id>-' prefix
+	if (strncmp(name, "qemu-", strlen("qemu-")) == 0) {
+		for (i = strlen("qemu-"); isdigit(name[i]); ++i);
+		if (i > (int)strlen("qemu-") && name[i] == '-')
+			memmove(name, &name[i + 1], strlen(&name[i + 1]) + 1);
+	}
+}
+
+static int qc_kvmhost_open(struct qc_handle *hdl, char **data) {
+	char *fname = NULL, *path = NULL, name[MAX_GUEST_NAME_LEN + 1], buf[64];
+	int64_t cpu_time, runtime;
+	const char *slice;
+	struct dirent *de;
+	int rc = 0, vcpus, v2 = 1;
+	size_t n = 0;
+	double uptime;
+	DIR *dir;
+	FILE *fp;
+	pid_t pid;
+
+	qc_debug(hdl, "Retrieve KVM guests data\n");
+	qc_debug_indent_inc();
+	*data = NULL;
+	if (qc_dbg_use_dump) {
+		qc_debug(hdl, "Read KVM guests from dump\n");
+		if (asprintf(&fname, "%s/kvm_guests", qc_dbg_use_dump) == -1) {
+			qc_debug(hdl, "Error: Mem alloc failed, cannot open dump\n");
+			rc = -1;
+			goto out;
+		}
+		if (access(fname, F_OK)) {
+			qc_debug(hdl, "No KVM guests data available\n");
+			goto out;
+		}
+		if ((fp = fopen(fname, "r")) == NULL) {
+			qc_debug(hdl, "Error: Failed to open file '%s': %s\n", fname, strerror(errno));
+			rc = -2;
+			goto out;
+		}
+		if (getdelim(data, &n, '\0', fp) == -1) {
+			free(*data);
+			// the file is empty if there are no KVM guests
+			if (!feof(fp) || (*data = strdup("")) == NULL) {
+				qc_debug(hdl, "Error: Failed to read content: %s\n", strerror(errno));
+				*data = NULL;
+				rc = -3;
+			}
+		}
+		fclose(fp);
+		goto out;
+	}
+
+	slice = DIR_MACHINE_SLICE_V2;
+	if ((dir = opendir(slice)) == NULL) {
+		slice = DIR_MACHINE_SLICE_V1;
+		dir = opendir(slice);
+		v2 = 0;
+	}
+	if (!dir) {
+		qc_debug(hdl, "No KVM guests data available\n");
+		goto out;
+	}
+	qc_debug(hdl, "Read KVM guests from %s\n", slice);
+	if (qc_kvmhost_read_line(FILE_UPTIME, buf, sizeof(buf)) || sscanf(buf, "%lf", &uptime) != 1) {
+		qc_debug(hdl, "Error: Failed to read " FILE_UPTIME "\n");
+		rc = -4;
+		goto out_close;
+	}
+	if ((fp = open_memstream(data, &n)) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate buffer for KVM guests data\n");
+		rc = -5;
+		goto out_close;
+	}
+	while ((de = readdir(dir)) != NULL) {
+		if (de->d_type != DT_DIR || !strstr(de->d_name, ".scope"))
+			continue;
+		if (asprintf(&path, "%s/%s", slice, de->d_name) == -1) {
+			qc_debug(hdl, "Error: Mem alloc failed, cannot read KVM guests\n");
+			rc = -6;
+			break;
+		}
+		qc_kvmhost_decode_name(de->d_name, name);
+		// guests can shut down at any time, hence we skip all guests with incomplete data
+		if ((pid = qc_kvmhost_find_pid(path, 2)) > 0 && (vcpus = qc_kvmhost_count_vcpus(pid)) > 0 &&
+		    (cpu_time = qc_kvmhost_get_cpu_time(path, v2)) >= 0 &&
+		    (runtime = qc_kvmhost_get_runtime(pid, uptime)) >= 0)
+			fprintf(fp, "%d %lld %lld %s\n", vcpus, (long long)cpu_time, (long long)runtime, name);
+		else
+			qc_debug(hdl, "Skipping guest '%s', data incomplete\n", name);
+		free(path);
+	}
+	fclose(fp);
+	if (rc) {
+		free(*data);
+		*data = NULL;
+	}
+
+out_close:
+	closedir(dir);
+out:
+	free(fname);
+	qc_debug(hdl, "Done reading KVM guests data\n");
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+static int qc_kvmhost_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+			       char **data) {
+	const struct qc_source_buffer *buf;
+
+	qc_debug(hdl, "Retrieve KVM guests data from buffer\n");
+	*data = NULL;
+	buf = qc_get_source_buffer(bufs, num, QC_SOURCE_KVM_GUESTS);
+	if (!buf) {
+		qc_debug(hdl, "No KVM guests data available\n");
+		return 0;
+	}
+	if ((*data = strndup(buf->data, buf->len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to alloc buffer for KVM guests data\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void qc_kvmhost_close(struct qc_handle *hdl, char *data) {
+	free(data);
+}
+
+// Returns the highest layer if it can host KVM guests, or NULL otherwise
+static struct qc_handle *qc_get_kvm_host_hdl(struct qc_handle *hdl) {
+	int *type;
+
+	for (hdl = hdl->root; hdl->next; hdl = hdl->next);
+	type = qc_get_attr_value_int(hdl, qc_layer_type_num);
+
+	return type && (*type == QC_LAYER_TYPE_LPAR || *type == QC_LAYER_TYPE_ZVM_GUEST) ? hdl : NULL;
+}
+
+// Returns the number of shared cores of the KVM host, or 0 if unknown
+static int qc_get_kvm_host_shared_cores(struct qc_handle *hdl) {
+	int *num;
+
+	if ((num = qc_get_attr_value_int(hdl, qc_num_core_shared)) == NULL)
+		num = qc_get_attr_value_int(hdl, qc_num_cpu_shared);
+
+	return num ? *num : 0;
+}
+
+static int qc_kvmhost_process(struct qc_handle *hdl, char *data) {
+	int num = 0, row, vcpus, sum = 0, cores, pos;
+	long long cpu_time, runtime;
+	struct qc_handle *host;
+	struct qc_table *tbl;
+	char *line, *end, c;
+
+	qc_debug(hdl, "Process KVM guests\n");
+	qc_debug_indent_inc();
+	if (!data) {
+		qc_debug(hdl, "No KVM guests data, exiting\n");
+		goto out;
+	}
+	if ((host = qc_get_kvm_host_hdl(hdl)) == NULL) {
+		qc_debug(hdl, "Not running in a KVM host, ignoring\n");
+		goto out;
+	}
+	for (line = data; *line; ++num) {
+		end = strchrnul(line, '\n');
+		line = *end ? end + 1 : end;
+	}
+	if (qc_new_table(host, qc_table_kvm_guests, num, &tbl))
+		goto out_err;
+	cores = qc_get_kvm_host_shared_cores(host);
+	for (row = 0, line = data; row < num; line = c ? end + 1 : end, ++row) {
+		end = strchrnul(line, '\n');
+		c = *end;
+		if (sscanf(line, "%d %lld %lld %n", &vcpus, &cpu_time, &runtime, &pos) != 3 ||
+		    line + pos >= end || end - line - pos > MAX_GUEST_NAME_LEN) {
+			qc_debug(hdl, "Error: Failed to parse line %d\n", row);
+			goto out_err;
+		}
+		*end = '\0';
+		if (qc_set_row_attr_string(tbl, row, qc_layer_name, line + pos) ||
+		    qc_set_row_attr_int(tbl, row, qc_num_cpu_total, vcpus) ||
+		    qc_set_row_attr_int64(tbl, row, qc_cpu_time, cpu_time) ||
+		    qc_set_row_attr_int64(tbl, row, qc_online_time, runtime) ||
+		    (cores > 0 && qc_set_row_attr_float(tbl, row, qc_overcommit, (float)vcpus / cores)))
+			goto out_err;
+		sum += vcpus;
+		*end = c;
+	}
+	if (qc_index_table(tbl, qc_layer_name))
+		goto out_err;
+	qc_debug(hdl, "Added %d KVM guests with %d vCPUs to table\n", num, sum);
+	if (cores > 0 && qc_set_attr_float(host, qc_overcommit, (float)sum / cores, ATTR_SRC_KVMHOST))
+		goto out_err;
+
+out:
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+// Sets the CPU consumption of each KVM guest from the time that elapsed since 'prev'
+static int qc_kvmhost_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	int64_t *cpu_time, *runtime, *prev_cpu_time, *prev_runtime;
+	struct qc_handle *host, *prev_host;
+	struct qc_table *tbl, *prev_tbl;
+	int row, prev_row, num = 0, *vcpus;
+	char *name;
+
+	qc_debug(hdl, "Compute KVM guests utilization\n");
+	qc_debug_indent_inc();
+	if ((host = qc_get_kvm_host_hdl(hdl)) == NULL || (prev_host = qc_get_kvm_host_hdl(prev)) == NULL ||
+	    (tbl = qc_get_table(host, qc_table_kvm_guests)) == NULL ||
+	    (prev_tbl = qc_get_table(prev_host, qc_table_kvm_guests)) == NULL) {
+		qc_debug(hdl, "No KVM guests data available\n");
+		goto out_na;
+	}
+	for (row = 0; row < tbl->num_rows; ++row) {
+		qc_unset_row_attr(tbl, row, qc_cpu_consumption);
+		qc_unset_row_attr(tbl, row, qc_utilization);
+		// guests that were started in between have no previous value, and restarted guests
+		// have a shorter runtime
+		if ((name = qc_get_row_attr_value_string(tbl, row, qc_layer_name)) == NULL ||
+		    (prev_row = qc_find_row_string(prev_tbl, qc_layer_name, name)) < 0)
+			continue;
+		cpu_time = qc_get_row_attr_value_int64(tbl, row, qc_cpu_time);
+		runtime = qc_get_row_attr_value_int64(tbl, row, qc_online_time);
+		vcpus = qc_get_row_attr_value_int(tbl, row, qc_num_cpu_total);
+		prev_cpu_time = qc_get_row_attr_value_int64(prev_tbl, prev_row, qc_cpu_time);
+		prev_runtime = qc_get_row_attr_value_int64(prev_tbl, prev_row, qc_online_time);
+		if (!cpu_time || !runtime || !vcpus || !prev_cpu_time || !prev_runtime ||
+		    *runtime <= *prev_runtime || *cpu_time < *prev_cpu_time)
+			continue;
+		if (qc_set_row_attr_int(tbl, row, qc_cpu_consumption,
+					(*cpu_time - *prev_cpu_time) * 0x10000 / (*runtime - *prev_runtime)) ||
+		    qc_set_row_attr_float(tbl, row, qc_utilization,
+					  100.0 * (*cpu_time - *prev_cpu_time) / (*runtime - *prev_runtime) / *vcpus))
+			goto out_err;
+		num++;
+	}
+	if (!num) {
+		qc_debug(hdl, "Configuration is not newer than previous configuration\n");
+		goto out_na;
+	}
+	qc_debug(hdl, "Computed utilization of %d KVM guests\n", num);
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_na:
+	qc_debug_indent_dec();
+
+	return 1;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+struct qc_data_src kvmhost = {"kvmhost",
+			      qc_kvmhost_open,
+			      qc_kvmhost_process,
+			      qc_kvmhost_dump,
+			      qc_kvmhost_close,
+			      NULL,
+			      qc_kvmhost_open_buf,
+			      qc_kvmhost_utilization};
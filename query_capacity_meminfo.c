@@ -0,0 +1,296 @@
+/* Copyright IBM Corp. 2018 */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "query_capacity_int.h"
+#include "query_capacity_data.h"
+
+
+#define FILE_PROC_MEMINFO	"/proc/meminfo"
+#define FILE_PROC_CGROUP	"/proc/self/cgroup"
+#define DIR_CGROUP		"/sys/fs/cgroup"
+// cgroup v1 reports unlimited memory as the highest multiple of the page size, v2 as "max"
+#define CGROUP_MEM_UNLIMITED	(1LL << 62)
+
+
+static void qc_meminfo_dump(struct qc_handle *hdl, char *data) {
+	char *path = NULL;
+	FILE *fp;
+	int rc;
+
+	qc_debug(hdl, "Dump memory data\n");
+	qc_debug_indent_inc();
+	if (!data)
+		goto out;
+	if (asprintf(&path, "%s/memory", qc_dbg_dump_dir) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failure, cannot dump memory data\n");
+		goto out_err;
+	}
+	if ((fp = fopen(path, "w")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open %s to write memory data dump\n", path);
+		goto out_err;
+	}
+	rc = fprintf(fp, "%s", data);
+	fclose(fp);
+	if (rc < 0) {
+		qc_debug(hdl, "Error: Failed to write dump to '%s'\n", path);
+		goto out_err;
+	}
+	goto out;
+
+out_err:
+	qc_mark_dump_incomplete(hdl, "memory");
+out:
+	free(path);
+	qc_debug_indent_dec();
+
+	return;
+}
+
+// Reads MemTotal from /proc/meminfo into 'total' in KB
+static int qc_meminfo_read_total(struct qc_handle *hdl, long long *total) {
+	char buf[STR_BUF_SIZE];
+	int rc = -1;
+	FILE *fp;
+
+	if ((fp = fopen(FILE_PROC_MEMINFO, "r")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open '%s': %s\n", FILE_PROC_MEMINFO, strerror(errno));
+		return -1;
+	}
+	while (fgets(buf, sizeof(buf), fp)) {
+		if (sscanf(buf, "MemTotal: %lld kB", total) == 1) {
+			rc = 0;
+			break;
+		}
+	}
+	fclose(fp);
+	if (rc)
+		qc_debug(hdl, "Error: Failed to find MemTotal in '%s'\n", FILE_PROC_MEMINFO);
+
+	return rc;
+}
+
+/* Reads the memory limit of control group 'path' and all of its parents, where 'file' is the name
+   of the limit's file in the hierarchy at 'dir'. Sets 'limit' to the lowest limit in bytes, or
+   leaves it unmodified if there is none */
+static int qc_meminfo_read_cgroup_limit(struct qc_handle *hdl, const char *dir, char *path, const char *file,
+					long long *limit) {
+	char buf[STR_BUF_SIZE], *fname, *s;
+	long long val;
+	FILE *fp;
+
+	for (;;) {
+		if (asprintf(&fname, "%s%s/%s", dir, strcmp(path, "/") ? path : "", file) == -1) {
+			qc_debug(hdl, "Error: Mem alloc failed, cannot read memory limit\n");
+			return -1;
+		}
+		// files do not exist in the root control group, or for groups outside our namespace
+		if ((fp = fopen(fname, "r")) != NULL) {
+			if (fgets(buf, sizeof(buf), fp) && sscanf(buf, "%lld", &val) == 1 && val < CGROUP_MEM_UNLIMITED &&
+			    (*limit < 0 || val < *limit)) {
+				qc_debug(hdl, "Memory limit of %lld bytes in '%s'\n", val, fname);
+				*limit = val;
+			}
+			fclose(fp);
+		}
+		free(fname);
+		if ((s = strrchr(path, '/')) == NULL || s == path)
+			break;
+		*s = '\0';
+	}
+
+	return 0;
+}
+
+/* Reads the memory limit of the control group of the calling process, preferring the memory controller of
+   cgroup v1 over the unified hierarchy of cgroup v2, into 'limit' in bytes, or -1 if not limited */
+static int qc_meminfo_read_limit(struct qc_handle *hdl, long long *limit) {
+	char *line = NULL, *v1 = NULL, *v2 = NULL, *ctrl, *path, *tok, *save;
+	size_t n = 0;
+	int rc = 0;
+	FILE *fp;
+
+	*limit = -1;
+	if ((fp = fopen(FILE_PROC_CGROUP, "r")) == NULL) {
+		qc_debug(hdl, "No control groups available\n");
+		return 0;
+	}
+	// lines have format 'hierarchy-id:controller-list:path'
+	while (getline(&line, &n, fp) != -1 && !v1) {
+		line[strcspn(line, "\n")] = '\0';
+		if ((ctrl = strchr(line, ':')) == NULL || (path = strchr(++ctrl, ':')) == NULL)
+			continue;
+		*path++ = '\0';
+		if (*ctrl == '\0') {
+			free(v2);
+			v2 = strdup(path);
+			continue;
+		}
+		for (tok = strtok_r(ctrl, ",", &save); tok; tok = strtok_r(NULL, ",", &save))
+			if (strcmp(tok, "memory") == 0)
+				v1 = strdup(path);
+	}
+	free(line);
+	fclose(fp);
+	if (v1)
+		rc = qc_meminfo_read_cgroup_limit(hdl, DIR_CGROUP "/memory", v1, "memory.limit_in_bytes", limit);
+	else if (v2)
+		rc = qc_meminfo_read_cgroup_limit(hdl, DIR_CGROUP, v2, "memory.max", limit);
+	free(v1);
+	free(v2);
+
+	return rc;
+}
+
+// Collects MemTotal and the memory limit of our control group in KB, with the latter being "max" if not limited
+static int qc_meminfo_read(struct qc_handle *hdl, char **data) {
+	long long total, limit;
+
+	if (qc_meminfo_read_total(hdl, &total) || qc_meminfo_read_limit(hdl, &limit))
+		return -1;
+	if ((limit < 0 && asprintf(data, "%lld max\n", total) == -1) ||
+	    (limit >= 0 && asprintf(data, "%lld %lld\n", total, limit / 1024) == -1)) {
+		qc_debug(hdl, "Error: Mem alloc failed, cannot read memory data\n");
+		*data = NULL;
+		return -2;
+	}
+
+	return 0;
+}
+
+static int qc_meminfo_open(struct qc_handle *hdl, char **data) {
+	char *fname = NULL;
+	size_t n = 0;
+	int rc = 0;
+	FILE *fp;
+
+	qc_debug(hdl, "Retrieve memory data\n");
+	qc_debug_indent_inc();
+	*data = NULL;
+	if (!qc_dbg_use_dump) {
+		qc_debug(hdl, "Read " FILE_PROC_MEMINFO " and " FILE_PROC_CGROUP "\n");
+		if (access(FILE_PROC_MEMINFO, F_OK)) {
+			qc_debug(hdl, "No memory data available\n");
+			goto out;
+		}
+		if (qc_meminfo_read(hdl, data)) {
+			qc_debug(hdl, "Error: Failed to read memory data\n");
+			rc = -1;
+		}
+		goto out;
+	}
+	qc_debug(hdl, "Read memory data from dump\n");
+	if (asprintf(&fname, "%s/memory", qc_dbg_use_dump) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failed, cannot open dump\n");
+		rc = -1;
+		goto out;
+	}
+	if (access(fname, F_OK)) {
+		qc_debug(hdl, "No memory data available\n");
+		goto out;
+	}
+	if ((fp = fopen(fname, "r")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open file '%s': %s\n", fname, strerror(errno));
+		rc = -2;
+		goto out;
+	}
+	if (getdelim(data, &n, '\0', fp) == -1) {
+		qc_debug(hdl, "Error: Failed to read content: %s\n", strerror(errno));
+		free(*data);
+		*data = NULL;
+		rc = -3;
+	}
+	fclose(fp);
+
+out:
+	free(fname);
+	qc_debug(hdl, "Done reading memory data\n");
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+static int qc_meminfo_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+			       char **data) {
+	const struct qc_source_buffer *buf;
+
+	qc_debug(hdl, "Retrieve memory data from buffer\n");
+	*data = NULL;
+	buf = qc_get_source_buffer(bufs, num, QC_SOURCE_MEMORY);
+	if (!buf) {
+		qc_debug(hdl, "No memory data available\n");
+		return 0;
+	}
+	if ((*data = strndup(buf->data, buf->len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to alloc buffer for memory data\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void qc_meminfo_close(struct qc_handle *hdl, char *data) {
+	free(data);
+}
+
+// Fills in the memory of the highest layer, which is the Linux instance that we run in
+static int qc_meminfo_process(struct qc_handle *hdl, char *data) {
+	char limit[STR_BUF_SIZE];
+	long long total, val;
+	int rc = 0;
+
+	qc_debug(hdl, "Process memory data\n");
+	qc_debug_indent_inc();
+	if (!data) {
+		qc_debug(hdl, "No memory data, exiting\n");
+		goto out;
+	}
+	for (hdl = hdl->root; hdl->next; hdl = hdl->next);
+	switch (*(int *)(hdl->layer)) {
+	case QC_LAYER_TYPE_LPAR:
+	case QC_LAYER_TYPE_ZVM_GUEST:
+	case QC_LAYER_TYPE_KVM_HYPERVISOR:
+	case QC_LAYER_TYPE_KVM_GUEST:
+		break;
+	default:
+		qc_debug(hdl, "Layer %d has no memory attributes, ignoring\n", hdl->layer_no);
+		goto out;
+	}
+	if (sscanf(data, "%lld %256s", &total, limit) != 2 || total <= 0) {
+		qc_debug(hdl, "Error: Failed to parse memory data\n");
+		rc = -1;
+		goto out;
+	}
+	qc_debug(hdl, "Layer %d: MemTotal=%lld KB, limit=%s\n", hdl->layer_no, total, limit);
+	if (qc_set_attr_int64(hdl, qc_mem_total, total, ATTR_SRC_MEMINFO)) {
+		rc = -2;
+		goto out;
+	}
+	if (strcmp(limit, "max") == 0)
+		goto out;
+	if (sscanf(limit, "%lld", &val) != 1 || val < 0) {
+		qc_debug(hdl, "Error: Failed to parse memory limit '%s'\n", limit);
+		rc = -3;
+		goto out;
+	}
+	if (qc_set_attr_int64(hdl, qc_mem_limit, val, ATTR_SRC_MEMINFO))
+		rc = -4;
+
+out:
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+struct qc_data_src meminfo = {"meminfo",
+			      qc_meminfo_open,
+			      qc_meminfo_process,
+			      qc_meminfo_dump,
+			      qc_meminfo_close,
+			      NULL,
+			      qc_meminfo_open_buf,
+			      NULL};
@@ -111,6 +111,25 @@ out:
 	return rc;
 }
 
+static int qc_ocf_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+			   char **data) {
+	const struct qc_source_buffer *buf;
+
+	qc_debug(hdl, "Retrieve ocf data from buffer\n");
+	*data = NULL;
+	buf = qc_get_source_buffer(bufs, num, QC_SOURCE_OCF_CPC_NAME);
+	if (!buf || buf->len == 0 || *(char *)buf->data == '\n') {
+		qc_debug(hdl, "No ocf data available\n");
+		return 0;
+	}
+	if ((*data = strndup(buf->data, buf->len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to alloc buffer for ocf data\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static void qc_ocf_close(struct qc_handle *hdl, char *data) {
 	free(data);
 }
@@ -130,9 +149,11 @@ out:
 	return 0;
 }
 
-struct qc_data_src ocf = {qc_ocf_open,
+struct qc_data_src ocf = {"ocf",
+			  qc_ocf_open,
 			  qc_ocf_process,
 			  qc_ocf_dump,
 			  qc_ocf_close,
 			  NULL,
+			  qc_ocf_open_buf,
 			  NULL};
@@ -0,0 +1,334 @@
+/* Copyright IBM Corp. 2018 */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "query_capacity_int.h"
+#include "query_capacity_data.h"
+
+
+#define FILE_PROC_STAT		"/proc/stat"
+
+struct procstat_priv {
+	char   *data;
+	int	deferred;	// /proc/stat is read in qc_procstat_process() once we know whether we run in a KVM guest
+};
+
+// Reads file 'fname' as a whole into 'data', which remains NULL if the file does not exist
+static int qc_procstat_read(struct qc_handle *hdl, const char *fname, char **data) {
+	size_t n = 0;
+	FILE *fp;
+	int rc;
+
+	if (access(fname, F_OK)) {
+		qc_debug(hdl, "No /proc/stat data available\n");
+		return 0;
+	}
+	fp = fopen(fname, "r");
+	if (!fp) {
+		qc_debug(hdl, "Error: Failed to open file '%s': %s\n", fname, strerror(errno));
+		return -1;
+	}
+	// the file contains no zero bytes, so this reads it as a whole
+	rc = getdelim(data, &n, '\0', fp);
+	fclose(fp);
+	if (rc == -1) {
+		qc_debug(hdl, "Error: Failed to read content: %s\n", strerror(errno));
+		free(*data);
+		*data = NULL;
+		return -2;
+	}
+
+	return 0;
+}
+
+static void qc_procstat_dump(struct qc_handle *hdl, char *buf) {
+	struct procstat_priv *priv = (struct procstat_priv *)buf;
+	char *path = NULL;
+	FILE *fp;
+	int rc;
+
+	qc_debug(hdl, "Dump /proc/stat\n");
+	qc_debug_indent_inc();
+	if (!priv)
+		goto out_err;
+	if (priv->deferred) {
+		// an error or the layer type kept process() from reading it
+		qc_debug(hdl, "Read " FILE_PROC_STAT " for the dump\n");
+		priv->deferred = 0;
+		if (qc_procstat_read(hdl, FILE_PROC_STAT, &priv->data))
+			goto out_err;
+	}
+	if (!priv->data) {
+		qc_debug(hdl, "No /proc/stat data available\n");
+		goto out_err;
+	}
+	if (asprintf(&path, "%s/proc_stat", qc_dbg_dump_dir) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failure, cannot dump /proc/stat\n");
+		goto out_err;
+	}
+	if ((fp = fopen(path, "w")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open %s to write /proc/stat dump\n", path);
+		goto out_err;
+	}
+	rc = fprintf(fp, "%s", priv->data);
+	fclose(fp);
+	if (rc < 0) {
+		qc_debug(hdl, "Error: Failed to write dump to '%s'\n", path);
+		goto out_err;
+	}
+	goto out;
+
+out_err:
+	qc_mark_dump_incomplete(hdl, "proc_stat");
+out:
+	free(path);
+	qc_debug_indent_dec();
+
+	return;
+}
+
+static int qc_procstat_open(struct qc_handle *hdl, char **buf) {
+	struct procstat_priv *priv;
+	char *fname = NULL;
+	int rc = 0;
+
+	qc_debug(hdl, "Retrieve /proc/stat data\n");
+	qc_debug_indent_inc();
+	if ((priv = calloc(1, sizeof(struct procstat_priv))) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate procstat_priv\n");
+		rc = -1;
+		goto out;
+	}
+	*buf = (char *)priv;
+	if (!qc_dbg_use_dump) {
+		// the CPU times are of use in KVM guests only
+		qc_debug(hdl, "Defer reading " FILE_PROC_STAT " until the layers are known\n");
+		priv->deferred = 1;
+		goto out;
+	}
+	qc_debug(hdl, "Read /proc/stat from dump\n");
+	if (asprintf(&fname, "%s/proc_stat", qc_dbg_use_dump) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failed, cannot open dump\n");
+		rc = -2;
+		goto out;
+	}
+	if (qc_procstat_read(hdl, fname, &priv->data))
+		rc = -3;
+
+out:
+	free(fname);
+	qc_debug(hdl, "Done reading /proc/stat data\n");
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+static int qc_procstat_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+				char **buf) {
+	const struct qc_source_buffer *src;
+	struct procstat_priv *priv;
+
+	qc_debug(hdl, "Retrieve /proc/stat data from buffer\n");
+	if ((priv = calloc(1, sizeof(struct procstat_priv))) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate procstat_priv\n");
+		return -1;
+	}
+	*buf = (char *)priv;
+	src = qc_get_source_buffer(bufs, num, QC_SOURCE_PROC_STAT);
+	if (!src || src->len == 0) {
+		qc_debug(hdl, "No /proc/stat data available\n");
+		return 0;
+	}
+	if ((priv->data = strndup(src->data, src->len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to alloc buffer for /proc/stat data\n");
+		return -2;
+	}
+
+	return 0;
+}
+
+static void qc_procstat_close(struct qc_handle *hdl, char *buf) {
+	struct procstat_priv *priv = (struct procstat_priv *)buf;
+
+	if (priv) {
+		free(priv->data);
+		free(priv);
+	}
+}
+
+// Returns the highest layer if it is a KVM guest, or NULL otherwise
+static struct qc_handle *qc_get_kvm_guest_hdl(struct qc_handle *hdl) {
+	int *type;
+
+	for (hdl = hdl->root; hdl->next; hdl = hdl->next);
+	type = qc_get_attr_value_int(hdl, qc_layer_type_num);
+
+	return type && *type == QC_LAYER_TYPE_KVM_GUEST ? hdl : NULL;
+}
+
+// Returns the next line in 'data' starting with 'cpu' followed by a digit, or NULL if there is none
+static const char *qc_next_cpu_line(const char *data) {
+	for (; data; data = strchr(data, '\n'), data = data ? data + 1 : NULL)
+		if (strncmp(data, "cpu", 3) == 0 && data[3] >= '0' && data[3] <= '9')
+			return data;
+
+	return NULL;
+}
+
+// Fills in table 'cpus' with the times of the virtual CPUs in /proc/stat, in units of USER_HZ
+static int qc_procstat_process(struct qc_handle *hdl, char *buf) {
+	struct procstat_priv *priv = (struct procstat_priv *)buf;
+	unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
+	struct qc_handle *guest;
+	int64_t hz, busy, total;
+	struct qc_table *tbl;
+	int num = 0, row, addr;
+	const char *line, *data;
+
+	qc_debug(hdl, "Process /proc/stat\n");
+	qc_debug_indent_inc();
+	if (!priv) {
+		qc_debug(hdl, "No priv, exiting\n");
+		goto out;
+	}
+	// steal time is only meaningful for the topmost layer, i.e. ourselves
+	if ((guest = qc_get_kvm_guest_hdl(hdl)) == NULL) {
+		qc_debug(hdl, "Not running in a KVM guest, ignoring\n");
+		goto out;
+	}
+	if (priv->deferred) {
+		qc_debug(hdl, "Read " FILE_PROC_STAT "\n");
+		priv->deferred = 0;
+		if (qc_procstat_read(hdl, FILE_PROC_STAT, &priv->data))
+			goto out_err;
+	}
+	if ((data = priv->data) == NULL) {
+		qc_debug(hdl, "No /proc/stat data, exiting\n");
+		goto out;
+	}
+	for (line = qc_next_cpu_line(data); line; line = qc_next_cpu_line(line + 1))
+		num++;
+	if (qc_new_table(guest, qc_table_cpus, num, &tbl))
+		goto out_err;
+	hz = sysconf(_SC_CLK_TCK);
+	for (row = 0, line = qc_next_cpu_line(data); line; line = qc_next_cpu_line(line + 1), ++row) {
+		if (sscanf(line, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu", &addr, &user, &nice, &system,
+			   &idle, &iowait, &irq, &softirq, &steal) != 9) {
+			qc_debug(hdl, "Error: Failed to parse line %d\n", row);
+			goto out_err;
+		}
+		// guest times are included in user and nice already
+		busy = user + nice + system + irq + softirq;
+		total = busy + idle + iowait + steal;
+		// KVM guests support IFLs only, see qc_post_process_KVM_guest()
+		if (qc_set_row_attr_int(tbl, row, qc_cpu_address, addr) ||
+		    qc_set_row_attr_int(tbl, row, qc_cpu_type_num, QC_CPU_TYPE_IFL) ||
+		    qc_set_row_attr_string(tbl, row, qc_cpu_type, "IFL") ||
+		    qc_set_row_attr_int(tbl, row, qc_dedicated, 0) ||
+		    qc_set_row_attr_int64(tbl, row, qc_cpu_time, busy * 1000000 / hz) ||
+		    qc_set_row_attr_int64(tbl, row, qc_steal_time, (int64_t)steal * 1000000 / hz) ||
+		    qc_set_row_attr_int64(tbl, row, qc_online_time, total * 1000000 / hz))
+			goto out_err;
+	}
+	qc_debug(hdl, "Added %d CPUs to table\n", num);
+
+out:
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+// Sets utilization and steal of each virtual CPU and of the KVM guest as a whole from the
+// times that elapsed since 'prev'
+static int qc_procstat_utilization(struct qc_handle *hdl, struct qc_handle *prev) {
+	enum qc_attr_id ids[] = {qc_cpu_time, qc_steal_time, qc_online_time};
+	__u64 sum_busy = 0, sum_steal = 0, sum_total = 0, busy, steal, total;
+	int row, prev_row, num = 0, i, *addr;
+	struct qc_handle *guest, *prev_guest;
+	struct qc_table *tbl, *prev_tbl;
+	int64_t *cur[3], *old[3];
+
+	qc_debug(hdl, "Compute KVM guest utilization\n");
+	qc_debug_indent_inc();
+	if ((guest = qc_get_kvm_guest_hdl(hdl)) == NULL || (prev_guest = qc_get_kvm_guest_hdl(prev)) == NULL ||
+	    (tbl = qc_get_table(guest, qc_table_cpus)) == NULL || (prev_tbl = qc_get_table(prev_guest, qc_table_cpus)) == NULL) {
+		qc_debug(hdl, "No KVM guest CPU times available\n");
+		goto out_na;
+	}
+	if (qc_strings_differ(qc_get_attr_value_string(guest, qc_layer_uuid), qc_get_attr_value_string(prev_guest, qc_layer_uuid)) ||
+	    qc_strings_differ(qc_get_attr_value_string(guest, qc_layer_name), qc_get_attr_value_string(prev_guest, qc_layer_name))) {
+		qc_debug(hdl, "Configurations originate from different KVM guests\n");
+		goto out_na;
+	}
+	qc_unset_attr(guest, qc_utilization);
+	qc_unset_attr(guest, qc_cpu_consumption);
+	qc_unset_attr(guest, qc_steal);
+	for (row = 0; row < tbl->num_rows; ++row) {
+		qc_unset_row_attr(tbl, row, qc_utilization);
+		qc_unset_row_attr(tbl, row, qc_steal);
+		// CPUs that were added in between have no previous value
+		if ((addr = qc_get_row_attr_value_int(tbl, row, qc_cpu_address)) == NULL ||
+		    (prev_row = qc_find_row_int(prev_tbl, qc_cpu_address, *addr)) < 0)
+			continue;
+		for (i = 0; i < 3; ++i) {
+			cur[i] = qc_get_row_attr_value_int64(tbl, row, ids[i]);
+			old[i] = qc_get_row_attr_value_int64(prev_tbl, prev_row, ids[i]);
+			if (!cur[i] || !old[i] || *cur[i] < *old[i])
+				break;
+		}
+		if (i < 3 || *cur[2] == *old[2])
+			continue;
+		busy = *cur[0] - *old[0];
+		steal = *cur[1] - *old[1];
+		total = *cur[2] - *old[2];
+		if (qc_set_row_attr_float(tbl, row, qc_utilization, 100.0 * busy / total) ||
+		    qc_set_row_attr_float(tbl, row, qc_steal, 100.0 * steal / total))
+			goto out_err;
+		sum_busy += busy;
+		sum_steal += steal;
+		sum_total += total;
+		num++;
+	}
+	if (!num) {
+		qc_debug(hdl, "Configuration is not newer than previous configuration\n");
+		goto out_na;
+	}
+	qc_debug(hdl, "%d CPUs busy for %llu us, stolen for %llu us within %llu us\n", num,
+		 (unsigned long long)sum_busy, (unsigned long long)sum_steal, (unsigned long long)sum_total);
+	// the CPUs' accounted times advance by the elapsed time each
+	if (qc_set_attr_float(guest, qc_utilization, 100.0 * sum_busy / sum_total, ATTR_SRC_PROCSTAT) ||
+	    qc_set_attr_float(guest, qc_steal, 100.0 * sum_steal / sum_total, ATTR_SRC_PROCSTAT) ||
+	    qc_set_attr_int(guest, qc_cpu_consumption, sum_busy * 0x10000 * num / sum_total, ATTR_SRC_PROCSTAT))
+		goto out_err;
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_na:
+	qc_debug_indent_dec();
+
+	return 1;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+struct qc_data_src procstat = {"procstat",
+			       qc_procstat_open,
+			       qc_procstat_process,
+			       qc_procstat_dump,
+			       qc_procstat_close,
+			       NULL,
+			       qc_procstat_open_buf,
+			       qc_procstat_utilization};
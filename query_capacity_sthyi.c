@@ -3,7 +3,6 @@
 #define _GNU_SOURCE
 #define _DEFAULT_SOURCE
 
-#include <iconv.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <endian.h>
@@ -205,10 +204,15 @@ static int qc_parse_sthyi_partition(struct qc_handle *lpar, struct inf0par *part
 
 	if (partition->infpval1 & INFPLGVL && (rc = qc_is_nonempty_ebcdic((__u64*)partition->infplgnm)) > 0) {
 		/* LPAR group is only defined in case group name is not empty */
-		qc_debug(lpar, "Insert LPAR group layer\n");
-		if (qc_insert_handle(lpar, &group, QC_LAYER_TYPE_LPAR_GROUP)) {
-			qc_debug(lpar, "Error: Failed to insert LPAR group layer\n");
-			goto out_err;
+		group = qc_get_prev_handle(lpar);
+		if (*(int *)(group->layer) == QC_LAYER_TYPE_LPAR_GROUP) {
+			qc_debug(lpar, "LPAR group layer already inserted by hypfs\n");
+		} else {
+			qc_debug(lpar, "Insert LPAR group layer\n");
+			if (qc_insert_handle(lpar, &group, QC_LAYER_TYPE_LPAR_GROUP)) {
+				qc_debug(lpar, "Error: Failed to insert LPAR group layer\n");
+				goto out_err;
+			}
 		}
 		rc = qc_set_attr_ebcdic_string(group, qc_layer_name, partition->infplgnm, sizeof(partition->infplgnm), ATTR_SRC_STHYI);
 		if (htobe32(partition->infplgcp))
@@ -336,6 +340,16 @@ static struct qc_handle *qc_get_HV_layer(struct qc_handle *hdl, int num) {
 	return NULL;
 }
 
+// Verifies that the section at offset 'off' with 'size' Bytes lies within the STHYI buffer
+static int qc_sthyi_verify_section(struct qc_handle *hdl, const char *name, __u16 off, size_t size) {
+	if (off < sizeof(struct inf0hdr) || off + size > STHYI_BUF_SIZE) {
+		qc_debug(hdl, "Error: STHYI %s section at offset %u exceeds buffer\n", name, off);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int qc_sthyi_process(struct qc_handle *hdl, char *buf) {
 	struct sthyi_priv *priv = (struct sthyi_priv *)buf;
 	int no_hyp_gst, i, rc = 0;
@@ -362,6 +376,11 @@ static int qc_sthyi_process(struct qc_handle *hdl, char *buf) {
 		goto out;	// No data: nothing we can do about
 	}
 	header = (struct inf0hdr *) sthyi_buffer;
+	if (qc_sthyi_verify_section(hdl, "machine", htobe16(header->infmoff), sizeof(struct inf0mac)) ||
+	    qc_sthyi_verify_section(hdl, "partition", htobe16(header->infpoff), sizeof(struct inf0par))) {
+		rc = -2;
+		goto out;
+	}
 	machine = (struct inf0mac *) (sthyi_buffer + htobe16(header->infmoff));
 	partition = (struct inf0par *) (sthyi_buffer + htobe16(header->infpoff));
 	no_hyp_gst = (int)header->infhygct;
@@ -371,6 +390,18 @@ static int qc_sthyi_process(struct qc_handle *hdl, char *buf) {
 		rc = -1;
 		goto out;
 	}
+	if ((no_hyp_gst > 0 &&
+	     (qc_sthyi_verify_section(hdl, "hypervisor", htobe16(header->infhoff1), sizeof(struct inf0hyp)) ||
+	      qc_sthyi_verify_section(hdl, "guest", htobe16(header->infgoff1), sizeof(struct inf0gst)))) ||
+	    (no_hyp_gst > 1 &&
+	     (qc_sthyi_verify_section(hdl, "hypervisor", htobe16(header->infhoff2), sizeof(struct inf0hyp)) ||
+	      qc_sthyi_verify_section(hdl, "guest", htobe16(header->infgoff2), sizeof(struct inf0gst)))) ||
+	    (no_hyp_gst > 2 &&
+	     (qc_sthyi_verify_section(hdl, "hypervisor", htobe16(header->infhoff3), sizeof(struct inf0hyp)) ||
+	      qc_sthyi_verify_section(hdl, "guest", htobe16(header->infgoff3), sizeof(struct inf0gst))))) {
+		rc = -2;
+		goto out;
+	}
 	if (no_hyp_gst > 0) {
 		hv[0] = (struct inf0hyp *)(sthyi_buffer + htobe16(header->infhoff1));
 		guest[0] = (struct inf0gst *)(sthyi_buffer + htobe16(header->infgoff1));
@@ -540,6 +571,48 @@ out:
 	return rc;
 }
 
+static int qc_sthyi_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+			     char **buf) {
+	const struct qc_source_buffer *src;
+	struct sthyi_priv *priv = NULL;
+	void *p = NULL;
+	int rc = 0;
+
+	*buf = NULL;
+	qc_debug(hdl, "Retrieve STHYI information from buffer\n");
+	qc_debug_indent_inc();
+	if ((src = qc_get_source_buffer(bufs, num, QC_SOURCE_STHYI)) == NULL) {
+		qc_debug(hdl, "No STHYI data available\n");
+		goto out;
+	}
+	if (src->len > STHYI_BUF_SIZE) {
+		qc_debug(hdl, "Error: STHYI data exceeds %d Bytes\n", STHYI_BUF_SIZE);
+		rc = -1;
+		goto out;
+	}
+	if ((priv = malloc(sizeof(struct sthyi_priv))) == NULL) {
+		qc_debug(hdl, "Error: failed to alloc \n");
+		rc = -2;
+		goto out;
+	}
+	bzero(priv, sizeof(struct sthyi_priv));
+	*buf = (char *)priv;
+	if (posix_memalign(&p, STHYI_BUF_ALIGNMENT, STHYI_BUF_SIZE)) {
+		qc_debug(hdl, "Error: posix_memalign() failed\n");
+		rc = -3;
+		goto out;
+	}
+	priv->data = (char *)p;
+	bzero(priv->data, STHYI_BUF_SIZE);
+	memcpy(priv->data, src->data, src->len);
+	priv->avail = STHYI_AVAILABLE;
+
+out:
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
 static void qc_sthyi_close(struct qc_handle *hdl, char *priv) {
 	if (priv) {
 		free(((struct sthyi_priv *)priv)->data);
@@ -547,9 +620,11 @@ static void qc_sthyi_close(struct qc_handle *hdl, char *priv) {
 	}
 }
 
-struct qc_data_src sthyi = {qc_sthyi_open,
+struct qc_data_src sthyi = {"sthyi",
+			    qc_sthyi_open,
 			    qc_sthyi_process,
 			    qc_sthyi_dump,
 			    qc_sthyi_close,
 			    NULL,
+			    qc_sthyi_open_buf,
 			    NULL};
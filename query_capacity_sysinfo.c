@@ -117,6 +117,22 @@ out_early:
 	return *sysinfo == NULL;
 }
 
+static int qc_sysinfo_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+			       char **sysinfo) {
+	const struct qc_source_buffer *buf;
+
+	qc_debug(hdl, "Retrieve sysinfo from buffer\n");
+	*sysinfo = NULL;
+	if ((buf = qc_get_source_buffer(bufs, num, QC_SOURCE_SYSINFO)) == NULL) {
+		qc_debug(hdl, "Error: No sysinfo buffer provided\n");
+		return 1;
+	}
+	if ((*sysinfo = strndup(buf->data, buf->len)) == NULL)
+		qc_debug(hdl, "Error: Failed to alloc buffer for sysinfo\n");
+
+	return *sysinfo == NULL;
+}
+
 static int qc_sysinfo_lgm_check(struct qc_handle *hdl, const char *sysinfo) {
 	char *lsysinfo = NULL;
 	int rc = 0;
@@ -444,9 +460,11 @@ out:
 	return rc;
 }
 
-struct qc_data_src sysinfo = {qc_sysinfo_open,
+struct qc_data_src sysinfo = {"sysinfo",
+			      qc_sysinfo_open,
 			      qc_sysinfo_process,
 			      qc_sysinfo_dump,
 			      qc_sysinfo_close,
 			      qc_sysinfo_lgm_check,
+			      qc_sysinfo_open_buf,
 			      NULL};
@@ -0,0 +1,418 @@
+/* Copyright IBM Corp. 2018 */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "query_capacity_int.h"
+#include "query_capacity_data.h"
+
+
+#define DIR_SYS_CPU		"/sys/devices/system/cpu"
+// size of column 'polarization' in table 'topology', must match the format width in qc_topology_process()
+#define POLARIZATION_LEN	16
+
+struct topology_priv {
+	char   *data;
+	int	deferred;	// sysfs is read in qc_topology_process() once we know whether we run in an LPAR
+};
+
+// Reads the first line of file 'name' of CPU 'cpu' into 'buf'. Returns >0 if the file does not exist.
+static int qc_topology_read_file(struct qc_handle *hdl, int cpu, const char *name, char *buf, int len) {
+	char *path;
+	FILE *fp;
+	int rc = 0;
+
+	if (asprintf(&path, DIR_SYS_CPU "/cpu%d/%s", cpu, name) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failed, cannot read CPU topology\n");
+		return -1;
+	}
+	if ((fp = fopen(path, "r")) == NULL) {
+		rc = 1;
+		goto out;
+	}
+	if (!fgets(buf, len, fp)) {
+		qc_debug(hdl, "Error: Failed to read '%s'\n", path);
+		rc = -2;
+	} else
+		buf[strcspn(buf, "\n")] = '\0';
+	fclose(fp);
+
+out:
+	free(path);
+
+	return rc;
+}
+
+// Reads the integer in file 'name' of CPU 'cpu' into 'val', which is set to -1 if the file does not exist
+static int qc_topology_read_int(struct qc_handle *hdl, int cpu, const char *name, int *val) {
+	char buf[STR_BUF_SIZE];
+	int rc;
+
+	*val = -1;
+	if ((rc = qc_topology_read_file(hdl, cpu, name, buf, sizeof(buf))) != 0)
+		return rc < 0 ? rc : 0;
+	if (sscanf(buf, "%d", val) != 1) {
+		qc_debug(hdl, "Error: Failed to parse '%s' of CPU %d\n", name, cpu);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int qc_polarization_to_num(const char *polarization) {
+	if (strcmp(polarization, "horizontal") == 0)
+		return QC_POLARIZATION_HORIZONTAL;
+	if (strcmp(polarization, "vertical:low") == 0)
+		return QC_POLARIZATION_VERTICAL_LOW;
+	if (strcmp(polarization, "vertical:medium") == 0)
+		return QC_POLARIZATION_VERTICAL_MEDIUM;
+	if (strcmp(polarization, "vertical:high") == 0)
+		return QC_POLARIZATION_VERTICAL_HIGH;
+
+	return -1;
+}
+
+/* Collects the topology of all online CPUs, one line per CPU: Its number, polarization, drawer,
+   book, socket and core id, where ids that are not available are reported as -1 */
+static int qc_topology_read(struct qc_handle *hdl, char **data) {
+	int cpu, online, drawer, book, socket, core, rc = 0;
+	char polarization[STR_BUF_SIZE], *path;
+	size_t len = 0;
+	FILE *fp;
+
+	if ((fp = open_memstream(data, &len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to open memstream\n");
+		return -1;
+	}
+	// possible CPUs are numbered consecutively
+	for (cpu = 0; ; ++cpu) {
+		if (asprintf(&path, DIR_SYS_CPU "/cpu%d", cpu) == -1) {
+			rc = -2;
+			break;
+		}
+		rc = access(path, F_OK);
+		free(path);
+		if (rc) {
+			rc = 0;
+			break;
+		}
+		// CPU 0 cannot be set offline, and has no 'online' file then
+		if ((rc = qc_topology_read_int(hdl, cpu, "online", &online)) != 0)
+			break;
+		if (online == 0)
+			continue;
+		if ((rc = qc_topology_read_file(hdl, cpu, "polarization", polarization, sizeof(polarization))) < 0)
+			break;
+		// report values that we do not know, e.g. from newer kernels, as unknown to keep the column bounded
+		if (rc > 0 || qc_polarization_to_num(polarization) < 0)
+			strcpy(polarization, "unknown");
+		if ((rc = qc_topology_read_int(hdl, cpu, "topology/drawer_id", &drawer)) != 0 ||
+		    (rc = qc_topology_read_int(hdl, cpu, "topology/book_id", &book)) != 0 ||
+		    (rc = qc_topology_read_int(hdl, cpu, "topology/physical_package_id", &socket)) != 0 ||
+		    (rc = qc_topology_read_int(hdl, cpu, "topology/core_id", &core)) != 0)
+			break;
+		fprintf(fp, "%d %s %d %d %d %d\n", cpu, polarization, drawer, book, socket, core);
+	}
+	fclose(fp);
+	if (rc) {
+		free(*data);
+		*data = NULL;
+	}
+
+	return rc;
+}
+
+static void qc_topology_dump(struct qc_handle *hdl, char *buf) {
+	struct topology_priv *priv = (struct topology_priv *)buf;
+	char *path = NULL;
+	FILE *fp;
+	int rc;
+
+	qc_debug(hdl, "Dump CPU topology\n");
+	qc_debug_indent_inc();
+	if (!priv)
+		goto out_err;
+	if (priv->deferred) {
+		// an error or the layer type kept process() from reading it
+		qc_debug(hdl, "Read " DIR_SYS_CPU " for the dump\n");
+		priv->deferred = 0;
+		if (qc_topology_read(hdl, &priv->data))
+			goto out_err;
+	}
+	if (!priv->data) {
+		qc_debug(hdl, "No CPU topology available\n");
+		goto out_err;
+	}
+	if (asprintf(&path, "%s/topology", qc_dbg_dump_dir) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failure, cannot dump CPU topology\n");
+		goto out_err;
+	}
+	if ((fp = fopen(path, "w")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open %s to write CPU topology dump\n", path);
+		goto out_err;
+	}
+	rc = fprintf(fp, "%s", priv->data);
+	fclose(fp);
+	if (rc < 0) {
+		qc_debug(hdl, "Error: Failed to write dump to '%s'\n", path);
+		goto out_err;
+	}
+	goto out;
+
+out_err:
+	qc_mark_dump_incomplete(hdl, "topology");
+out:
+	free(path);
+	qc_debug_indent_dec();
+
+	return;
+}
+
+static int qc_topology_open(struct qc_handle *hdl, char **buf) {
+	struct topology_priv *priv;
+	char *fname = NULL, **data;
+	size_t n = 0;
+	int rc = 0;
+	FILE *fp;
+
+	qc_debug(hdl, "Retrieve CPU topology\n");
+	qc_debug_indent_inc();
+	if ((priv = calloc(1, sizeof(struct topology_priv))) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate topology_priv\n");
+		rc = -1;
+		goto out;
+	}
+	*buf = (char *)priv;
+	data = &priv->data;
+	if (!qc_dbg_use_dump) {
+		// walking all CPUs is costly, and the topology is of use in LPARs only
+		qc_debug(hdl, "Defer reading " DIR_SYS_CPU " until the layers are known\n");
+		priv->deferred = 1;
+		goto out;
+	}
+	qc_debug(hdl, "Read CPU topology from dump\n");
+	if (asprintf(&fname, "%s/topology", qc_dbg_use_dump) == -1) {
+		qc_debug(hdl, "Error: Mem alloc failed, cannot open dump\n");
+		rc = -1;
+		goto out;
+	}
+	if (access(fname, F_OK)) {
+		qc_debug(hdl, "No CPU topology available\n");
+		goto out;
+	}
+	if ((fp = fopen(fname, "r")) == NULL) {
+		qc_debug(hdl, "Error: Failed to open file '%s': %s\n", fname, strerror(errno));
+		rc = -2;
+		goto out;
+	}
+	if (getdelim(data, &n, '\0', fp) == -1) {
+		free(*data);
+		// the file is empty if there are no online CPUs listed
+		if (!feof(fp) || (*data = strdup("")) == NULL) {
+			qc_debug(hdl, "Error: Failed to read content: %s\n", strerror(errno));
+			*data = NULL;
+			rc = -3;
+		}
+	}
+	fclose(fp);
+
+out:
+	free(fname);
+	qc_debug(hdl, "Done reading CPU topology\n");
+	qc_debug_indent_dec();
+
+	return rc;
+}
+
+static int qc_topology_open_buf(struct qc_handle *hdl, const struct qc_source_buffer *bufs, int num,
+				char **buf) {
+	const struct qc_source_buffer *src;
+	struct topology_priv *priv;
+
+	qc_debug(hdl, "Retrieve CPU topology from buffer\n");
+	if ((priv = calloc(1, sizeof(struct topology_priv))) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate topology_priv\n");
+		return -1;
+	}
+	*buf = (char *)priv;
+	src = qc_get_source_buffer(bufs, num, QC_SOURCE_TOPOLOGY);
+	if (!src) {
+		qc_debug(hdl, "No CPU topology available\n");
+		return 0;
+	}
+	if ((priv->data = strndup(src->data, src->len)) == NULL) {
+		qc_debug(hdl, "Error: Failed to alloc buffer for CPU topology\n");
+		return -2;
+	}
+
+	return 0;
+}
+
+static void qc_topology_close(struct qc_handle *hdl, char *buf) {
+	struct topology_priv *priv = (struct topology_priv *)buf;
+
+	if (priv) {
+		free(priv->data);
+		free(priv);
+	}
+}
+
+// Returns the highest layer if it is an LPAR, or NULL otherwise
+static struct qc_handle *qc_get_top_lpar_hdl(struct qc_handle *hdl) {
+	int *type;
+
+	for (hdl = hdl->root; hdl->next; hdl = hdl->next);
+	type = qc_get_attr_value_int(hdl, qc_layer_type_num);
+
+	return type && *type == QC_LAYER_TYPE_LPAR ? hdl : NULL;
+}
+
+struct qc_drawer_core {
+	int drawer;
+	int core;	// -1 if not available
+};
+
+static int qc_cmp_drawer_core(const void *p1, const void *p2) {
+	const struct qc_drawer_core *a = p1, *b = p2;
+
+	if (a->drawer != b->drawer)
+		return a->drawer < b->drawer ? -1 : 1;
+
+	return a->core < b->core ? -1 : a->core > b->core;
+}
+
+// Sets the number of drawers that the CPUs in table 'tbl' are spread across, and the highest
+// number of cores within a single drawer
+static int qc_topology_drawers(struct qc_handle *hdl, struct qc_table *tbl) {
+	int row, i, num = 0, num_drawers = 0, max_cores = 0, cores = 0, *drawer, *core;
+	struct qc_drawer_core *ids;
+
+	if ((ids = malloc(tbl->num_rows * sizeof(struct qc_drawer_core))) == NULL) {
+		qc_debug(hdl, "Error: Failed to allocate drawer ids\n");
+		return -1;
+	}
+	for (row = 0; row < tbl->num_rows; ++row) {
+		if ((drawer = qc_get_row_attr_value_int(tbl, row, qc_drawer_id)) == NULL)
+			continue;
+		core = qc_get_row_attr_value_int(tbl, row, qc_core_id);
+		ids[num].drawer = *drawer;
+		ids[num++].core = core ? *core : -1;
+	}
+	// with the ids sorted, each drawer and each of its cores is counted at its first occurrence,
+	// since SMT threads share the core id
+	qsort(ids, num, sizeof(struct qc_drawer_core), qc_cmp_drawer_core);
+	for (i = 0; i < num; ++i) {
+		if (i == 0 || ids[i].drawer != ids[i - 1].drawer) {
+			num_drawers++;
+			cores = 0;
+		} else if (ids[i].core == ids[i - 1].core)
+			continue;
+		if (ids[i].core >= 0 && ++cores > max_cores)
+			max_cores = cores;
+	}
+	free(ids);
+	if (!num_drawers) {
+		qc_debug(hdl, "No drawer ids available\n");
+		return 0;
+	}
+	qc_debug(hdl, "CPUs spread across %d drawer(s), with up to %d cores per drawer\n", num_drawers, max_cores);
+	if (qc_set_attr_int(hdl, qc_num_drawers, num_drawers, ATTR_SRC_TOPOLOGY) ||
+	    qc_set_attr_int(hdl, qc_num_core_per_drawer, max_cores, ATTR_SRC_TOPOLOGY))
+		return -1;
+
+	return 0;
+}
+
+// Fills in table 'topology' of the LPAR layer, and counts the CPUs per polarization
+static int qc_topology_process(struct qc_handle *hdl, char *buf) {
+	struct topology_priv *priv = (struct topology_priv *)buf;
+	int ids[] = {-1, -1, -1, -1}, counts[4] = {0}, num = 0, row, cpu, pol, i;
+	char polarization[POLARIZATION_LEN];
+	struct qc_handle *lpar;
+	struct qc_table *tbl;
+	const char *line, *data;
+
+	qc_debug(hdl, "Process CPU topology\n");
+	qc_debug_indent_inc();
+	if (!priv) {
+		qc_debug(hdl, "No priv, exiting\n");
+		goto out;
+	}
+	// the topology refers to the CPUs that we run on, which are only an LPAR's if we run in one
+	if ((lpar = qc_get_top_lpar_hdl(hdl)) == NULL) {
+		qc_debug(hdl, "Not running in an LPAR, ignoring\n");
+		goto out;
+	}
+	if (priv->deferred) {
+		qc_debug(hdl, "Read " DIR_SYS_CPU "\n");
+		priv->deferred = 0;
+		if (qc_topology_read(hdl, &priv->data)) {
+			qc_debug(hdl, "Error: Failed to read CPU topology\n");
+			goto out_err;
+		}
+	}
+	if ((data = priv->data) == NULL) {
+		qc_debug(hdl, "No CPU topology, exiting\n");
+		goto out;
+	}
+	for (line = data; *line; line = strchrnul(line, '\n'), line += *line ? 1 : 0)
+		num++;
+	if (qc_new_table(lpar, qc_table_topology, num, &tbl))
+		goto out_err;
+	for (row = 0, line = data; row < num; ++row, line = strchrnul(line, '\n'), line += *line ? 1 : 0) {
+		if (sscanf(line, "%d %15s %d %d %d %d", &cpu, polarization, &ids[0], &ids[1], &ids[2], &ids[3]) != 6) {
+			qc_debug(hdl, "Error: Failed to parse line %d\n", row);
+			goto out_err;
+		}
+		if (qc_set_row_attr_int(tbl, row, qc_cpu_address, cpu) ||
+		    qc_set_row_attr_string(tbl, row, qc_polarization, polarization))
+			goto out_err;
+		if ((pol = qc_polarization_to_num(polarization)) >= 0) {
+			counts[pol]++;
+			if (qc_set_row_attr_int(tbl, row, qc_polarization_num, pol))
+				goto out_err;
+		}
+		// ids that are not available on this machine, e.g. books on newer models, are reported as -1
+		if ((ids[0] >= 0 && qc_set_row_attr_int(tbl, row, qc_drawer_id, ids[0])) ||
+		    (ids[1] >= 0 && qc_set_row_attr_int(tbl, row, qc_book_id, ids[1])) ||
+		    (ids[2] >= 0 && qc_set_row_attr_int(tbl, row, qc_socket_id, ids[2])) ||
+		    (ids[3] >= 0 && qc_set_row_attr_int(tbl, row, qc_core_id, ids[3])))
+			goto out_err;
+	}
+	qc_debug(hdl, "Added %d CPUs to table\n", num);
+	for (i = 0; i < 4 && !counts[i]; ++i);
+	if (i < 4) {
+		qc_debug(hdl, "Polarization: %d horizontal, %d vertical low, %d vertical medium, %d vertical high\n",
+			 counts[QC_POLARIZATION_HORIZONTAL], counts[QC_POLARIZATION_VERTICAL_LOW],
+			 counts[QC_POLARIZATION_VERTICAL_MEDIUM], counts[QC_POLARIZATION_VERTICAL_HIGH]);
+		if (qc_set_attr_int(lpar, qc_num_cpu_horizontal, counts[QC_POLARIZATION_HORIZONTAL], ATTR_SRC_TOPOLOGY) ||
+		    qc_set_attr_int(lpar, qc_num_cpu_vertical_low, counts[QC_POLARIZATION_VERTICAL_LOW], ATTR_SRC_TOPOLOGY) ||
+		    qc_set_attr_int(lpar, qc_num_cpu_vertical_medium, counts[QC_POLARIZATION_VERTICAL_MEDIUM], ATTR_SRC_TOPOLOGY) ||
+		    qc_set_attr_int(lpar, qc_num_cpu_vertical_high, counts[QC_POLARIZATION_VERTICAL_HIGH], ATTR_SRC_TOPOLOGY))
+			goto out_err;
+	}
+	if (qc_topology_drawers(lpar, tbl))
+		goto out_err;
+
+out:
+	qc_debug_indent_dec();
+
+	return 0;
+
+out_err:
+	qc_debug_indent_dec();
+
+	return -1;
+}
+
+struct qc_data_src topology = {"topology",
+			       qc_topology_open,
+			       qc_topology_process,
+			       qc_topology_dump,
+			       qc_topology_close,
+			       NULL,
+			       qc_topology_open_buf,
+			       NULL};